@@ -6,12 +6,59 @@ MIT License Copyright (c) 2022, Victor Marian Popa (victormarianpopa@gmail.com)
 #define USHELL_CORE_H
 
 #include "ushell_core_datatypes.h"
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+#include "ushell_core_fileview.h"
+#endif /* (1 == uSHELL_SUPPORTS_FILE_ARGS) */
+#if (1 == uSHELL_SUPPORTS_READER)
+#include "ushell_core_reader.h"
+#endif /* (1 == uSHELL_SUPPORTS_READER) */
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+#include "ushell_core_output.h"
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+#include "ushell_core_frame.h"
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+#include "ushell_core_input.h"
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+#if (1 == uSHELL_SUPPORTS_KEY_METER)
+#include "ushell_core_keymeter.h"
+#endif /* (1 == uSHELL_SUPPORTS_KEY_METER) */
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+#include "ushell_core_jobs.h"
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+#include "ushell_core_cancel.h"
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+#include "ushell_core_fanout.h"
+#endif /* (1 == uSHELL_SUPPORTS_FAN_OUT) */
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
 #include <memory>
 #endif /* (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
 
 #define uSHELL_VERSION "1.0.0"
 
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+/** \brief result of a command run by Execute() with an output sink */
+typedef struct {
+    int      iRetVal;      /* value returned by the command, 0 if it did not run */
+    int      iError;       /* uSHELL_ERR_OK or the parsing error (its text is in the sink) */
+    int      iErrorArg;    /* index of the argument the parsing failed on, -1: none */
+    uint32_t uElapsedUs;   /* parsing and execution time */
+} execResult_s;
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+
+#if defined(uSHELL_FAN_OUT_THREADS)
+/** \brief a line of #p parsed for a thread: the strings of its arguments are in its own copy of the input */
+typedef struct {
+    command_s    sCommand;
+    PFEXEC       pfExec;
+    outputSink_s sOutput;      /* the output of the line, printed once all of them ended */
+    char         vstrInput[uSHELL_MAX_INPUT_BUF_LEN];
+} fanItem_s;
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+
 /*==============================================================================
             MICROSHELL CLASS DEFINITION
 ==============================================================================*/
@@ -26,6 +73,18 @@ class Microshell {
 #if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
     bool Execute(const char *pstrCommand);
 #endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+    bool Execute(const char *pstrCommand, outputSink_s *psSink, execResult_s *psResult);
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    bool Execute(frameRequest_s *psRequest, outputSink_s *psSink, execResult_s *psResult);
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    static void SetBatchMode(const bool bBatchMode);
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    static void SetCommandTimeout(const uint32_t uTimeoutMs);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
 
   private:
     Microshell(uShellInst_s *psShellInst, const char *pstrPromptExt);
@@ -36,11 +95,62 @@ class Microshell {
     static void m_CoreExecuteEnterKey(void);
     static int m_CoreParseCommand(void);
     static void m_CoreParseExecuteCommand(void);
+    static int m_CoreRunCommand(int *piRetVal);
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    static int m_CoreStopError(const cancelReason_e eReason);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+#if ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) || (1 == uSHELL_SUPPORTS_FAN_OUT))
+    static int m_CoreExecuteInput(int *piRetVal, const bool bPrintErrors);
+#endif /* ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) || (1 == uSHELL_SUPPORTS_FAN_OUT)) */
+#if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
+    static int m_CoreExecuteText(const char *pstrCommand, int *piRetVal, const bool bPrintErrors);
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    static int m_CoreExecuteFrame(frameRequest_s *psRequest, int *piRetVal);
+    static int m_CoreDecodeFrameArgs(frameRequest_s *psRequest);
+    static int m_CoreSearchFunctionHash(const uint32_t uHash);
+    static void m_CoreListFrameCommands(void);
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
     static int m_CoreSearchFunction(const char *pstrFctName);
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    static int m_CoreResolveFunction(const char *pstrFctName);
+    static void m_CoreRestoreInstance(void);
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    static void m_CoreReloadInstance(void);
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
     static void m_CorePrintError(const int iError);
     static void m_CorePutString(const char *pstrArray);
     static void m_CoreProcessKeyPress(const char cKeyPressed);
+#if (1 == uSHELL_SUPPORTS_KEY_METER)
+    static keyClass_e m_CoreKeyClass(const char cKeyPressed);
+#endif /* (1 == uSHELL_SUPPORTS_KEY_METER) */
     static void m_CoreResetInput(const bool bFull);
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+    static void m_CoreRunJobs(void);
+    static void m_CoreShowJobs(void);
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    static void m_CoreCancelJob(const char *pstrId);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+    static void m_CoreJobsOutput(const char *pstrText, size_t szLength, void *pvContext);
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    static void m_CoreSetTimeout(const char *pstrArgs);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+    static void m_CoreFanOut(const char *pstrArgs);
+    static void m_CoreFanOutSerial(const fanOut_s *psFanOut);
+#if defined(uSHELL_FAN_OUT_THREADS)
+    static bool m_CoreFanOutParallel(const fanOut_s *psFanOut, const unsigned int uWorkers);
+    static bool m_CoreFanOutPrepare(const fanOut_s *psFanOut, const size_t szItem, fanItem_s *psItem);
+    static void m_CoreFanOutRelocate(fanItem_s *psItem);
+    static void m_CoreFanOutItem(size_t szItem, void *pvContext);
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+    static void m_CoreFanOutResult(const fanOut_s *psFanOut, const size_t szItem);
+    static void m_CoreFanOutReport(const fanOut_s *psFanOut, const unsigned int uWorkers, const uint64_t ullElapsedUs);
+#endif /* (1 == uSHELL_SUPPORTS_FAN_OUT) */
     static void m_CoreRemoveTrailingSpaces(void);
     static void m_CorePrintMessage(const int iFeatIdx, const int iStatusIdx);
     static void m_CorePrintPrompt(void);
@@ -66,6 +176,22 @@ class Microshell {
 #endif /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS)*/
 #endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
 
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+    static int m_CoreParseArray(const char cType, char *pstrToken, char **ppstrRest);
+    static int m_CoreParseArrayNumber(const char *pstrToken, const BIGNUM_T numMaxValue, BIGNUM_T *pNumVal);
+    static char *m_CoreNextArrayItem(const char cType, char **ppstrRest, int *piRetVal);
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+    static int m_CoreOpenFileArg(char **ppstrToken, size_t *pszLength, bool *pbIsFile);
+    static void m_CoreReleaseFileArgs(void);
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+
+#if (1 == uSHELL_SUPPORTS_READER)
+    static int m_CoreOpenReader(const char *pstrToken, char **ppstrRest);
+    static void m_CoreCloseReader(void);
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+
     /* core key handlers */
     static void m_CoreHandleKeyEnter(void);
     static void m_CoreHandleKeyDefault(const char cKeyPressed);
@@ -171,6 +297,22 @@ class Microshell {
     static int m_iInputPos;
     static int m_iCursorPos;
     static command_s m_sCommand;
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    static bool m_bBatchMode;
+#endif /*(1 == uSHELL_SUPPORTS_BATCH_MODE)*/
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    static uint32_t m_uCommandTimeoutMs;
+#endif /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+    static fanResult_s m_vsFanOutResults[uSHELL_FAN_OUT_MAX_ITEMS];
+#endif /*(1 == uSHELL_SUPPORTS_FAN_OUT)*/
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+    static fileview_t m_vsFileArgs[uSHELL_MAX_FILE_ARGS];
+    static unsigned int m_iNrFileArgs;
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+    static reader_t m_sReader;
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
 
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
     static autocomplete_s m_sAutocomplete;
@@ -234,6 +376,9 @@ class Microshell {
 #endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
 
     static uShellInst_s *m_pInst;
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    static uShellInst_s *m_pInstCaller;
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
     static int m_iInstanceCounter;
     static uShellInst_s *m_pInstBackup;
@@ -12,6 +12,9 @@ MIT License Copyright (c) 2022, Victor Marian Popa (victormarianpopa@gmail.com)
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+#include <chrono>
+#endif /*(1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)*/
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
 #include <memory>
 #endif /*(1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)*/
@@ -40,6 +43,24 @@ MIT License Copyright (c) 2022, Victor Marian Popa (victormarianpopa@gmail.com)
 #define uSHELL_NEWLINE      "\n\r"
 #define uSHELL_INVALID_VALUE (-1)
 
+#if ((1 == uSHELL_SUPPORTS_COROUTINES) && (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE))
+/* output of the jobs during a pass of the scheduler */
+typedef struct {
+    outputSink_s *psPrevSink;
+    bool          bWritten;
+} jobsOutput_s;
+#endif /* ((1 == uSHELL_SUPPORTS_COROUTINES) && (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)) */
+
+#if defined(uSHELL_FAN_OUT_THREADS)
+/* lines of #p shared by the threads */
+typedef struct {
+    fanItem_s     *psItems;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    cancelToken_s *psToken;   /* the one of #p, Ctrl-C fires it */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+} fanRun_s;
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+
 /*==============================================================================
             PUBLIC INTERFACES IMPLEMENTATION
 ==============================================================================*/
@@ -61,14 +82,29 @@ Microshell *Microshell::getShellPtr(uShellInst_s *psShellInst, const char *pstrP
 
 /*----------------------------------------------------------------------------*/
 void Microshell::Run(void) {
-    m_CorePrintPrompt();
-    while(m_Execute()) {}
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    m_CoreReloadInstance();
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+    bool bInteractive = true;
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    bInteractive = (false == m_bBatchMode); /* a batch has no keyboard: the nested shell of a plugin is not entered */
+    if (false == bInteractive) {
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "batch mode: no nested shell, the plugin commands run as plugin.command\n"));
+    }
+#endif /*(1 == uSHELL_SUPPORTS_BATCH_MODE)*/
+    if (true == bInteractive) {
+        m_CorePrintPrompt();
+        while(m_Execute()) {}
+    }
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
     if(0 == --m_iInstanceCounter) {
 #endif /*(1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)*/
 #if (1 == uSHELL_IMPLEMENTS_HISTORY)
         m_HistoryDeInit();
 #endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+        ushell_jobs_drop();
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
         uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR,"uShell exit!\n\r"));
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
     } else {
@@ -84,27 +120,395 @@ void Microshell::Run(void) {
 #if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
 /*----------------------------------------------------------------------------*/
 bool Microshell::Execute(const char *pstrCommand) {
-    bool bRetVal = false;
-    unsigned int iLen = (unsigned int)strlen(pstrCommand) + 1;
-    if ((nullptr != pstrCommand) && (iLen < uSHELL_MAX_INPUT_BUF_LEN)) {
-        strcpy(m_pstrInput, pstrCommand);
-        m_iInputPos = iLen;
-#if (1 == uSHELL_IMPLEMENTS_HISTORY)
-        // Use the proper pHistory write mechanism (which handles both memory and file)
-        m_HistoryWrite();
-#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY) */
-        if ((uSHELL_ERR_OK == m_CoreParseCommand()) && (m_pInst->pfExec(&m_sCommand) >= 0)) {
-            bRetVal = true;
-        }
-    }
-    return bRetVal;
+    int iRetVal = 0;
+    return (uSHELL_ERR_OK == m_CoreExecuteText(pstrCommand, &iRetVal, false)) && (iRetVal >= 0);
 } /* Execute() */
 #endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
 
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+/*----------------------------------------------------------------------------*/
+bool Microshell::Execute(const char *pstrCommand, outputSink_s *psSink, execResult_s *psResult) {
+    outputSink_s *psPrevSink = output_redirect(psSink);
+    const auto tStart = std::chrono::steady_clock::now();
+    int iRetVal = 0;
+    int iError = m_CoreExecuteText(pstrCommand, &iRetVal, true); /* the errors go into the sink */
+
+    if (nullptr != psResult) {
+        psResult->iRetVal = iRetVal;
+        psResult->iError = iError;
+        psResult->iErrorArg = ((uSHELL_ERR_OK != iError) && (uSHELL_ERR_INPUT_TOO_LONG != iError) && (uSHELL_ERR_FUNCTION_NOT_FOUND != iError) &&
+                               (uSHELL_ERR_INTERRUPTED != iError) && (uSHELL_ERR_TIMEOUT != iError)) ? m_sCommand.iErrorInfo : -1;
+        psResult->uElapsedUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+    }
+    output_redirect(psPrevSink);
+    return (uSHELL_ERR_OK == iError) && (iRetVal >= 0);
+} /* Execute() */
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+/*----------------------------------------------------------------------------*/
+/* pre-tokenised request: no line editing and no text parsing, the arguments are used in place */
+bool Microshell::Execute(frameRequest_s *psRequest, outputSink_s *psSink, execResult_s *psResult) {
+    outputSink_s *psPrevSink = output_redirect(psSink);
+    const auto tStart = std::chrono::steady_clock::now();
+    int iRetVal = 0;
+    int iError = m_CoreExecuteFrame(psRequest, &iRetVal);
+
+    if (nullptr != psResult) {
+        psResult->iRetVal = iRetVal;
+        psResult->iError = iError;
+        psResult->iErrorArg = ((uSHELL_ERR_OK != iError) && (uSHELL_ERR_FUNCTION_NOT_FOUND != iError) &&
+                               (uSHELL_ERR_INTERRUPTED != iError) && (uSHELL_ERR_TIMEOUT != iError)) ? m_sCommand.iErrorInfo : -1;
+        psResult->uElapsedUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+    }
+    output_redirect(psPrevSink);
+    return (uSHELL_ERR_OK == iError) && (iRetVal >= 0);
+} /* Execute() */
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+/*----------------------------------------------------------------------------*/
+/* commands fed by a script or a pipe: no banner, the commands are not kept in the history */
+void Microshell::SetBatchMode(const bool bBatchMode) {
+    m_bBatchMode = bBatchMode;
+} /* SetBatchMode() */
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/*----------------------------------------------------------------------------*/
+/* the watchdog fires the token of each command after uTimeoutMs (0: no timeout) */
+void Microshell::SetCommandTimeout(const uint32_t uTimeoutMs) {
+    m_uCommandTimeoutMs = uTimeoutMs;
+} /* SetCommandTimeout() */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
 /*==============================================================================
             PRIVATE INTERFACES IMPLEMENTATION
 ==============================================================================*/
 
+#if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreExecuteText(const char *pstrCommand, int *piRetVal, const bool bPrintErrors) {
+    int iError = uSHELL_ERR_INPUT_TOO_LONG;
+    size_t szLen = (nullptr != pstrCommand) ? (strlen(pstrCommand) + 1U) : uSHELL_MAX_INPUT_BUF_LEN;
+    *piRetVal = 0;
+    if (szLen < uSHELL_MAX_INPUT_BUF_LEN) {
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+        m_CoreReloadInstance();
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+        memset(&m_sCommand, 0, sizeof(m_sCommand)); /* the counters of the previous command */
+        strcpy(m_pstrInput, pstrCommand);
+        m_iInputPos = (int)szLen;
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+        bool bWriteHistory = true;
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+        bWriteHistory = (false == m_bBatchMode);
+#endif /*(1 == uSHELL_SUPPORTS_BATCH_MODE)*/
+        if (true == bWriteHistory) {
+            // Use the proper pHistory write mechanism (which handles both memory and file)
+            m_HistoryWrite();
+        }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY) */
+        iError = m_CoreExecuteInput(piRetVal, bPrintErrors);
+    }
+    return iError;
+} /* m_CoreExecuteText() */
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+
+#if ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) || (1 == uSHELL_SUPPORTS_FAN_OUT))
+/*----------------------------------------------------------------------------*/
+/* the line in the input buffer is parsed and run, not written into the history */
+int Microshell::m_CoreExecuteInput(int *piRetVal, const bool bPrintErrors) {
+    int iError = m_CoreParseCommand();
+    if (uSHELL_ERR_OK == iError) {
+        iError = m_CoreRunCommand(piRetVal);
+    }
+    if ((uSHELL_ERR_OK != iError) && (true == bPrintErrors)) {
+        m_CorePrintError(iError);
+    }
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+    m_CoreReleaseFileArgs();
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+    m_CoreCloseReader();
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    m_CoreRestoreInstance();
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+    return iError;
+} /* m_CoreExecuteInput() */
+#endif /* ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) || (1 == uSHELL_SUPPORTS_FAN_OUT)) */
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreExecuteFrame(frameRequest_s *psRequest, int *piRetVal) {
+    int iError = uSHELL_ERR_OK;
+    *piRetVal = 0;
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    m_CoreReloadInstance();
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+    memset(&m_sCommand, 0, sizeof(m_sCommand));
+    m_sCommand.pstrFctName = "?";
+
+    switch (psRequest->uSelector) {
+        case FRAME_BY_INDEX: {
+            m_sCommand.iFctIndex = (psRequest->uCommand < (uint32_t)m_pInst->iNrFunctions) ? (int)psRequest->uCommand : uSHELL_ERR_FUNCTION_NOT_FOUND;
+        } break;
+        case FRAME_BY_HASH: {
+            m_sCommand.iFctIndex = m_CoreSearchFunctionHash(psRequest->uCommand);
+        } break;
+        case FRAME_BY_NAME: {
+            m_sCommand.pstrFctName = psRequest->pstrName;
+            m_sCommand.iFctIndex = m_CoreSearchFunction(psRequest->pstrName);
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+            if (uSHELL_ERR_FUNCTION_NOT_FOUND == m_sCommand.iFctIndex) {
+                m_sCommand.iFctIndex = m_CoreResolveFunction(psRequest->pstrName);
+            }
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+        } break;
+        default: { /* FRAME_LIST */
+            m_CoreListFrameCommands();
+            return uSHELL_ERR_OK;
+        }
+    }
+
+    if (uSHELL_ERR_FUNCTION_NOT_FOUND == m_sCommand.iFctIndex) {
+        iError = uSHELL_ERR_FUNCTION_NOT_FOUND;
+    } else {
+        m_sCommand.pstrFctName = m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFctName;
+        iError = m_CoreDecodeFrameArgs(psRequest);
+    }
+    if (uSHELL_ERR_OK == iError) {
+        iError = m_CoreRunCommand(piRetVal);
+    }
+    if (uSHELL_ERR_OK != iError) {
+        m_CorePrintError(iError);
+    }
+#if (1 == uSHELL_SUPPORTS_READER)
+    m_CoreCloseReader();
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    m_CoreRestoreInstance();
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+    return iError;
+} /* m_CoreExecuteFrame() */
+
+/*----------------------------------------------------------------------------*/
+/* the argument slots map one to one onto the pattern of the command, their type letters must match it */
+int Microshell::m_CoreDecodeFrameArgs(frameRequest_s *psRequest) {
+    int iRetVal = uSHELL_ERR_OK;
+    const char *pstrPattern = m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef;
+    const int iNrParamsExpected = ('v' == pstrPattern[0]) ? 0 : (int)strlen(pstrPattern);
+    frameArg_s sArg;
+
+    for (unsigned int i = 0; (uSHELL_ERR_OK == iRetVal) && (i < psRequest->uNrArgs); ++i) {
+        if (m_sCommand.iTypIndex >= iNrParamsExpected) {
+            iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+            ++(m_sCommand.iTypIndex);
+            break;
+        }
+        const char cType = pstrPattern[(m_sCommand.iTypIndex)++];
+        const bool bIsValid = (true == frame_next_arg(psRequest, &sArg)) && (cType == sArg.cType);
+        switch (cType) {
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+            case 'l': { /* [l]ong <==> 64 bit */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_64BIT;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (m_sCommand.iNrNums64 < uSHELL_MAX_PARAMS_NUM64) {
+                    m_sCommand.vl[m_sCommand.iNrNums64++] = (num64_t)frame_get_u64(sArg.pData);
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+            case 'i': { /* [i]nteger <==> 32 bit */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_32BIT;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (m_sCommand.iNrNums32 < uSHELL_MAX_PARAMS_NUM32) {
+                    m_sCommand.vi[m_sCommand.iNrNums32++] = (num32_t)frame_get_u32(sArg.pData);
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+            case 'w': { /* [w]ord <==> 16 bit */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_16BIT;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (m_sCommand.iNrNums16 < uSHELL_MAX_PARAMS_NUM16) {
+                    m_sCommand.vw[m_sCommand.iNrNums16++] = (num16_t)frame_get_u16(sArg.pData);
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+            case 'b': { /* [b]yte <==> 8 bit */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_8BIT;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (m_sCommand.iNrNums8 < uSHELL_MAX_PARAMS_NUM8) {
+                    m_sCommand.vb[m_sCommand.iNrNums8++] = (num8_t)sArg.pData[0];
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+            case 'f': { /* IEEE 754 single precision */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_FLOAT;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (m_sCommand.iNrNumsFloat < uSHELL_MAX_PARAMS_FLOAT) {
+                    uint32_t uBits = frame_get_u32(sArg.pData);
+                    float fpVal = 0;
+                    memcpy(&fpVal, &uBits, sizeof(fpVal));
+                    m_sCommand.vf[m_sCommand.iNrNumsFloat++] = (numfp_t)fpVal;
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+            case 's': { /* [s]tring <==> (char*), in place in the request */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_STRING;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (m_sCommand.iNrStrings < uSHELL_MAX_PARAMS_STRING) {
+                    m_sCommand.vs[m_sCommand.iNrStrings++] = (str_t *)sArg.pData;
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+#if defined(uSHELL_IMPLEMENTS_BOOLEAN)
+            case 'o': { /* b[o]ol <==> bool */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_BOOL;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (sArg.pData[0] > uSHELL_MAX_VALUE_BOOLEAN) {
+                    iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+                } else if (m_sCommand.iNrBools < uSHELL_MAX_PARAMS_BOOLEAN) {
+                    m_sCommand.vo[m_sCommand.iNrBools++] = (0U != sArg.pData[0]);
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_BOOLEAN)*/
+#if defined(uSHELL_IMPLEMENTS_BLOB)
+            case 'x': { /* he[x] blob <==> {uint8_t*, size_t}, the raw bytes in place in the request */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_BLOB;
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (m_sCommand.iNrBlobs < uSHELL_MAX_PARAMS_BLOB) {
+                    m_sCommand.vx[m_sCommand.iNrBlobs].pData = sArg.pData;
+                    m_sCommand.vx[m_sCommand.iNrBlobs].szLength = sArg.uLength;
+                    ++m_sCommand.iNrBlobs;
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_BLOB)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+            case 'r': { /* [r]eader <==> "-": the shell input, "<path": a file */
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_READER;
+                iRetVal = (true == bIsValid) ? m_CoreOpenReader((const char *)sArg.pData, nullptr) : uSHELL_ERR_INVALID_NUMBER;
+            } break;
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+            case 'L':
+            case 'I':
+            case 'W':
+            case 'B':
+            case 'F':
+            case 'S': { /* array <==> copied into the array buffer of the instance */
+                if (false == bIsValid) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else if (sArg.uLength > (uint32_t)m_pInst->iArrayBufferItems) {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+                uint8_t *pItem = sArg.pData;
+                for (uint32_t j = 0; (uSHELL_ERR_OK == iRetVal) && (j < sArg.uLength); ++j) {
+                    switch (cType) {
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+                        case 'L': { ((num64_t *)m_pInst->puArrayBuffer)[j] = (num64_t)frame_get_u64(pItem); pItem += 8; } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+                        case 'I': { ((num32_t *)m_pInst->puArrayBuffer)[j] = (num32_t)frame_get_u32(pItem); pItem += 4; } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+                        case 'W': { ((num16_t *)m_pInst->puArrayBuffer)[j] = (num16_t)frame_get_u16(pItem); pItem += 2; } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+                        case 'B': { ((num8_t *)m_pInst->puArrayBuffer)[j] = (num8_t)pItem[0]; pItem += 1; } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+                        case 'F': {
+                            uint32_t uBits = frame_get_u32(pItem);
+                            float fpVal = 0;
+                            memcpy(&fpVal, &uBits, sizeof(fpVal));
+                            ((numfp_t *)m_pInst->puArrayBuffer)[j] = (numfp_t)fpVal;
+                            pItem += 4;
+                        } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+                        case 'S': { ((str_t **)m_pInst->puArrayBuffer)[j] = frame_next_string(&pItem); } break;
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+                        default: {
+                            iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+                        } break;
+                    }
+                }
+                m_sCommand.pvArray = m_pInst->puArrayBuffer;
+                m_sCommand.iNrArrayItems = (uSHELL_ERR_OK == iRetVal) ? sArg.uLength : 0U;
+            } break;
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+            default: {
+                iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+            } break;
+        }
+    }
+
+    if (uSHELL_ERR_OK == iRetVal) {
+#if (1 == uSHELL_SUPPORTS_READER)
+        if ((m_sCommand.iTypIndex + 1 == iNrParamsExpected) && ('r' == pstrPattern[iNrParamsExpected - 1])) {
+            iRetVal = m_CoreOpenReader(nullptr, nullptr); /* omitted reader: the shell input */
+            ++(m_sCommand.iTypIndex);
+        }
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+        if ((m_sCommand.iTypIndex != iNrParamsExpected) || (0U != psRequest->szArgs)) {
+            iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+            ++(m_sCommand.iTypIndex);
+        }
+    }
+    if (uSHELL_ERR_OK != iRetVal) {
+        m_sCommand.iErrorInfo = m_sCommand.iTypIndex - 1;
+    }
+    return iRetVal;
+} /* m_CoreDecodeFrameArgs() */
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreSearchFunctionHash(const uint32_t uHash) {
+    for (int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        if (uHash == frame_hash(m_pInst->psFuncDefArray[i].pstrFctName)) {
+            return i;
+        }
+    }
+    return uSHELL_ERR_FUNCTION_NOT_FOUND;
+} /* m_CoreSearchFunctionHash() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreListFrameCommands(void) {
+    for (int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        uSHELL_PRINTF("%d %08x %s %s\n", i, (unsigned int)frame_hash(m_pInst->psFuncDefArray[i].pstrFctName), m_pInst->psFuncDefArray[i].pstrFuncParamDef, m_pInst->psFuncDefArray[i].pstrFctName);
+    }
+} /* m_CoreListFrameCommands() */
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
 /*----------------------------------------------------------------------------*/
 Microshell::Microshell(uShellInst_s *psShellInst, const char *pstrPromptExt) {
     psShellInst->pstrPromptName = pstrPromptExt;
@@ -138,17 +542,20 @@ void Microshell::m_Init(const char *pstrPromptExt) {
 #endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
     m_pInst->psShortcutsArray[0] = {'#', m_CoreHandleShortcut_Hash};
     m_CoreResetInput(true);
+    bool bShowBanner = true;
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
-    if(0 == m_iInstanceCounter++) {
+    bShowBanner = (0 == m_iInstanceCounter++);
 #endif /*(1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    bShowBanner = bShowBanner && (false == m_bBatchMode);
+#endif /*(1 == uSHELL_SUPPORTS_BATCH_MODE)*/
+    if (true == bShowBanner) {
 #if (1 == uSHELL_SCRIPT_MODE)
-    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "uShell v%s [script mode]\n"), uSHELL_VERSION);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "uShell v%s [script mode]\n"), uSHELL_VERSION);
 #else
-    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "uShell v%s [info: ###]\n"), uSHELL_VERSION);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "uShell v%s [info: ###]\n"), uSHELL_VERSION);
 #endif /* (1 == uSHELL_SCRIPT_MODE) */
-#if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
     }
-#endif /*(1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)*/
 #if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
     m_pInst->bKeepRuning = true;
 #endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
@@ -156,7 +563,35 @@ void Microshell::m_Init(const char *pstrPromptExt) {
 
 /*----------------------------------------------------------------------------*/
 inline bool Microshell::m_Execute(void) {
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+    m_CoreRunJobs();
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+    const int iKey = uSHELL_GETCH();
+    if ((EOF == iKey) && (true == ushell_input_ended())) {
+        return false; /* the producer closed the input ring */
+    }
+#if !defined(SERIAL_TERMINAL)
+    if ((EOF == iKey) && (false == ushell_input_attached())) {
+        return false; /* end of the input or a read error */
+    }
+#endif /* !defined(SERIAL_TERMINAL) */
+#if (1 == uSHELL_SUPPORTS_KEY_METER)
+    ushell_key_meter_begin(m_CoreKeyClass((char)iKey));
+    m_CoreProcessKeyPress((char)iKey);
+    ushell_key_meter_end();
+#else
+    m_CoreProcessKeyPress((char)iKey);
+#endif /* (1 == uSHELL_SUPPORTS_KEY_METER) */
+#elif !defined(SERIAL_TERMINAL)
+    const int iKey = uSHELL_GETCH();
+    if (EOF == iKey) {
+        return false; /* end of the input or a read error */
+    }
+    m_CoreProcessKeyPress((char)iKey);
+#else
     m_CoreProcessKeyPress(uSHELL_GETCH());
+#endif /*(1 == uSHELL_SUPPORTS_INPUT_RING)*/
 #if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
     return m_pInst->bKeepRuning;
 #else
@@ -167,27 +602,83 @@ inline bool Microshell::m_Execute(void) {
 /*----------------------------------------------------------------------------*/
 void Microshell::m_CoreParseExecuteCommand(void) {
     int iRetVal = 0;
-    if (uSHELL_ERR_OK == (iRetVal = m_CoreParseCommand())) {
-        if ((iRetVal = m_pInst->pfExec(&m_sCommand)) >= 0) {
-            uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %d (0x%X)\n"), iRetVal, iRetVal);
-        } else {
-            m_CorePrintError(iRetVal); /* execution errors */
-        }
-    } else {
-        m_CorePrintError(iRetVal); /* parsing errors */
+    int iError = m_CoreParseCommand();
+    if (uSHELL_ERR_OK == iError) {
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+        ushell_jobs_background(true); /* a coroutine command goes on as a job */
+        iError = m_CoreRunCommand(&iRetVal);
+        ushell_jobs_background(false);
+#else
+        iError = m_CoreRunCommand(&iRetVal);
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
     }
+    if (uSHELL_ERR_OK != iError) {
+        m_CorePrintError(iError); /* parsing errors, the command stopped */
+    } else if (iRetVal >= 0) {
+        uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %d (0x%X)\n"), iRetVal, iRetVal);
+    } else {
+        m_CorePrintError(iRetVal); /* execution errors */
+    }
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+    m_CoreReleaseFileArgs();
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+    m_CoreCloseReader();
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    m_CoreRestoreInstance();
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
 } /* m_CoreParseExecuteCommand() */
 
+/*----------------------------------------------------------------------------*/
+/* the command runs with a token: Ctrl-C and its timeout ask it to stop, the error tells if it did */
+int Microshell::m_CoreRunCommand(int *piRetVal) {
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    cancelToken_s sToken;
+    cancel_token_init(&sToken, m_uCommandTimeoutMs);
+    cancelToken_s *psPrevious = ushell_cancel_enter(&sToken, true);
+    *piRetVal = m_pInst->pfExec(&m_sCommand);
+    const cancelReason_e eReason = cancel_token_reason(&sToken);
+    ushell_cancel_leave(&sToken, psPrevious);
+    cancel_token_release(&sToken);
+    return m_CoreStopError(eReason);
+#else
+    *piRetVal = m_pInst->pfExec(&m_sCommand);
+    return uSHELL_ERR_OK;
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+} /* m_CoreRunCommand() */
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/*----------------------------------------------------------------------------*/
+/* the error of a command whose token fired */
+int Microshell::m_CoreStopError(const cancelReason_e eReason) {
+    switch (eReason) {
+        case CANCEL_NONE:    return uSHELL_ERR_OK;
+        case CANCEL_TIMEOUT: return uSHELL_ERR_TIMEOUT;
+        default:             return uSHELL_ERR_INTERRUPTED;
+    }
+} /* m_CoreStopError() */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
 /*----------------------------------------------------------------------------*/
 int Microshell::m_CoreParseCommand(void) {
     int iRetVal = uSHELL_ERR_OK;
     char *pstrRest = m_pstrInput;
     char *pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
     m_sCommand.pstrFctName = pstrToken;
-    if (uSHELL_ERR_FUNCTION_NOT_FOUND != (m_sCommand.iFctIndex = m_CoreSearchFunction(pstrToken))) {
+    m_sCommand.iFctIndex = m_CoreSearchFunction(pstrToken);
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    if (uSHELL_ERR_FUNCTION_NOT_FOUND == m_sCommand.iFctIndex) {
+        m_sCommand.iFctIndex = m_CoreResolveFunction(pstrToken);
+    }
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+    if (uSHELL_ERR_FUNCTION_NOT_FOUND != m_sCommand.iFctIndex) {
         bool bIsVoidFct = ('v' == m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[0]);
         bool bHasParams = (nullptr != pstrRest);
         int iNrParamsExpected = (int)strlen(m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef);
+#if (1 == uSHELL_SUPPORTS_READER)
+        bool bReadsInput = ('r' == m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[iNrParamsExpected - 1]);
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
 
         if ((true == bHasParams) && (false == bIsVoidFct)) {
             int iNrParamsRead = 0;
@@ -308,8 +799,15 @@ int Microshell::m_CoreParseCommand(void) {
 #if defined(uSHELL_IMPLEMENTS_STRINGS)
                 case 's': { /* [s]tring <==> (char*) */
                     if (m_sCommand.iNrStrings < uSHELL_MAX_PARAMS_STRING) {
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+                        if (uSHELL_ERR_OK == (iRetVal = m_CoreOpenFileArg(&pstrToken, nullptr, nullptr))) {
+                            m_sCommand.vs[m_sCommand.iNrStrings++] = pstrToken;
+                            ++iNrParamsRead;
+                        }
+#else
                         m_sCommand.vs[m_sCommand.iNrStrings++] = pstrToken;
                         ++iNrParamsRead;
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
                     } else {
                         iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                     }
@@ -340,6 +838,59 @@ int Microshell::m_CoreParseCommand(void) {
                     }
                 } break;
 #endif /*defined(uSHELL_IMPLEMENTS_BOOLEAN)*/
+#if defined(uSHELL_IMPLEMENTS_BLOB)
+                case 'x': { /* he[x] blob <==> {uint8_t*, size_t}, decoded in place (the bytes are shorter than the text) */
+                    if (m_sCommand.iNrBlobs < uSHELL_MAX_PARAMS_BLOB) {
+                        size_t szLength = 0;
+                        bool bIsFile = false;
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+                        iRetVal = m_CoreOpenFileArg(&pstrToken, &szLength, &bIsFile);
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+                        if ((uSHELL_ERR_OK == iRetVal) && (false == bIsFile)) { /* a file holds the raw bytes, the text is hex */
+                            const char *pstrHex = pstrToken;
+                            if (('0' == pstrHex[0]) && ('x' == tolower(pstrHex[1]))) {
+                                pstrHex += 2;
+                            }
+                            if (false == unhexlify(pstrHex, (uint8_t *)pstrToken, &szLength)) {
+                                iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                            }
+                        }
+                        if (uSHELL_ERR_OK == iRetVal) {
+                            m_sCommand.vx[m_sCommand.iNrBlobs].pData = (const uint8_t *)pstrToken;
+                            m_sCommand.vx[m_sCommand.iNrBlobs].szLength = szLength;
+                            ++m_sCommand.iNrBlobs;
+                            ++iNrParamsRead;
+                        }
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_BLOB;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_BLOB)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+                case 'r': { /* [r]eader <==> "-": the shell input, "<path" or "< path": a file */
+                    if (uSHELL_ERR_OK == (iRetVal = m_CoreOpenReader(pstrToken, &pstrRest))) {
+                        ++iNrParamsRead;
+                    } else {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_READER;
+                    }
+                } break;
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+                case 'L':
+                case 'I':
+                case 'W':
+                case 'B':
+                case 'F':
+                case 'S': { /* array <==> this and all the remaining arguments */
+                    iRetVal = m_CoreParseArray(m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[m_sCommand.iTypIndex - 1], pstrToken, &pstrRest);
+                    if (uSHELL_ERR_OK == iRetVal) {
+                        ++iNrParamsRead;
+                    }
+                } break;
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
                 // default: {
                 default: { /* unsuported type or more params than defined */
                     if (m_sCommand.iTypIndex != iNrParamsExpected) {
@@ -360,6 +911,12 @@ int Microshell::m_CoreParseCommand(void) {
             if (uSHELL_ERR_OK != iRetVal) {
                 m_sCommand.iErrorInfo = m_sCommand.iTypIndex - 1;
             } else {
+#if (1 == uSHELL_SUPPORTS_READER)
+                if ((m_sCommand.iTypIndex + 1 == iNrParamsExpected) && (true == bReadsInput)) {
+                    iRetVal = m_CoreOpenReader(nullptr, nullptr); /* omitted reader: the shell input */
+                    ++(m_sCommand.iTypIndex);
+                }
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
                 if (m_sCommand.iTypIndex != iNrParamsExpected) {
                     iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
                 }
@@ -368,6 +925,11 @@ int Microshell::m_CoreParseCommand(void) {
             if (((true == bIsVoidFct) && (true == bHasParams)) || ((false == bIsVoidFct) && (false == bHasParams))) {
                 iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
             }
+#if (1 == uSHELL_SUPPORTS_READER)
+            if ((false == bHasParams) && (1 == iNrParamsExpected) && (true == bReadsInput)) {
+                iRetVal = m_CoreOpenReader(nullptr, nullptr);
+            }
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
         }
     } else {
         iRetVal = uSHELL_ERR_FUNCTION_NOT_FOUND;
@@ -375,6 +937,71 @@ int Microshell::m_CoreParseCommand(void) {
     return iRetVal;
 } /* m_CoreParseCommand() */
 
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreOpenFileArg(char **ppstrToken, size_t *pszLength, bool *pbIsFile) {
+    int iRetVal = uSHELL_ERR_OK;
+    bool bIsFile = false;
+    char *pstrToken = *ppstrToken;
+
+    if ('@' == pstrToken[0]) {
+        if ('@' == pstrToken[1]) { /* "@@text" <==> the literal "@text" */
+            *ppstrToken = pstrToken + 1;
+        } else if ((m_iNrFileArgs < uSHELL_MAX_FILE_ARGS) && (true == fileview_open(pstrToken + 1, &m_vsFileArgs[m_iNrFileArgs]))) {
+            *ppstrToken = m_vsFileArgs[m_iNrFileArgs].pData;
+            if (nullptr != pszLength) {
+                *pszLength = m_vsFileArgs[m_iNrFileArgs].szLength;
+            }
+            ++m_iNrFileArgs;
+            bIsFile = true;
+        } else {
+            iRetVal = uSHELL_ERR_FILE_NOT_READABLE;
+        }
+    }
+    if (nullptr != pbIsFile) {
+        *pbIsFile = bIsFile;
+    }
+    return iRetVal;
+} /* m_CoreOpenFileArg() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreReleaseFileArgs(void) {
+    while (m_iNrFileArgs > 0U) {
+        fileview_close(&m_vsFileArgs[--m_iNrFileArgs]);
+    }
+} /* m_CoreReleaseFileArgs() */
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+
+#if (1 == uSHELL_SUPPORTS_READER)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreOpenReader(const char *pstrToken, char **ppstrRest) {
+    int iRetVal = uSHELL_ERR_OK;
+
+    if ((nullptr == pstrToken) || (0 == strcmp(pstrToken, "-"))) {
+        reader_open_input(&m_sReader);
+    } else if ('<' == pstrToken[0]) {
+        const char *pstrPath = ('\0' != pstrToken[1]) ? (pstrToken + 1) : ((nullptr != ppstrRest) ? strtok_ex(*ppstrRest, m_pstrTokenSeparator, ppstrRest) : nullptr);
+        if ((nullptr == pstrPath) || (false == reader_open_file(&m_sReader, pstrPath))) {
+            iRetVal = uSHELL_ERR_FILE_NOT_READABLE;
+        }
+    } else {
+        iRetVal = uSHELL_ERR_INVALID_NUMBER;
+    }
+    if (uSHELL_ERR_OK == iRetVal) {
+        m_sCommand.psReader = &m_sReader;
+    }
+    return iRetVal;
+} /* m_CoreOpenReader() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreCloseReader(void) {
+    if (nullptr != m_sCommand.psReader) {
+        reader_close(m_sCommand.psReader);
+        m_sCommand.psReader = nullptr;
+    }
+} /* m_CoreCloseReader() */
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+
 /*----------------------------------------------------------------------------*/
 void Microshell::m_CorePrintError(const int iError) {
     static const char *pstrErrorUnknown = " ?";
@@ -388,8 +1015,11 @@ void Microshell::m_CorePrintError(const int iError) {
         case uSHELL_ERR_FUNCTION_NOT_FOUND       : { pstrErrorString = "command not found";}                 break;
         case uSHELL_ERR_WRONG_NUMBER_ARGS        : { pstrErrorString = "wrong number of arguments";}         break;
         case uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM    : { pstrErrorString = "data type not implem/enabled";}      break;
-        case uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM: { pstrErrorString = "params pattern not implem/enabled";} break;
         case uSHELL_ERR_STRING_NOT_CLOSED        : { pstrErrorString = "string not closed"; }                break;
+        case uSHELL_ERR_FILE_NOT_READABLE        : { pstrErrorString = "file argument not readable"; }       break;
+        case uSHELL_ERR_NO_TASK_FRAME            : { pstrErrorString = "no coroutine frame left"; }          break;
+        case uSHELL_ERR_INTERRUPTED              : { pstrErrorString = "interrupted"; }                      break;
+        case uSHELL_ERR_TIMEOUT                  : { pstrErrorString = "timed out"; }                        break;
         case uSHELL_ERR_TOO_MANY_ARGS            : { bIsTooManyArgsError = true;} break;
         case uSHELL_ERR_INVALID_NUMBER           : { bIsInvalidNumError  = true;} break;
         case uSHELL_ERR_VALUE_TOO_BIG            : { bIsNumBigValueError = true;} break;
@@ -429,13 +1059,19 @@ int Microshell::m_CoreHandleBorderedStrings(char **ppstrToken, char **ppstrRest,
             bFound = false;
             **ppstrRest = '\0';
             while(*m_pstrTokenSeparator == *(++(*ppstrRest)));   /* cleanup the trailing separators */
-            if('s' == m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[(m_sCommand.iTypIndex)++]) {
+            const char cType = m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[(m_sCommand.iTypIndex)++];
+            if('s' == cType) {
                 if(m_sCommand.iNrStrings < uSHELL_MAX_PARAMS_STRING) {
                     m_sCommand.vs[m_sCommand.iNrStrings++] = *ppstrToken;
                     ++(*pIntArgCounter);
                 } else {
                     iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                 }
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+            } else if ('S' == cType) { /* the bordered string starts an array of strings */
+                ++(*pIntArgCounter);
+                return m_CoreParseArray(cType, *ppstrToken, ppstrRest);
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
             } else {
                 iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
             }
@@ -464,6 +1100,124 @@ void Microshell::m_CoreSetStringBorder(const char *pstrStringBorder) {
 #endif /* (1 == uSHELL_SUPPORTS_SPACED_STRINGS) */
 #endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
 
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreParseArray(const char cType, char *pstrToken, char **ppstrRest) {
+    int iRetVal = uSHELL_ERR_OK;
+    unsigned int iNrItems = 0;
+    dataType_e eDataType = uSHELL_DATA_TYPE_LAST;
+
+    /* all the items are parsed in one pass, straight into the array buffer of the instance */
+    while ((uSHELL_ERR_OK == iRetVal) && (nullptr != pstrToken)) {
+        if (iNrItems >= (unsigned int)m_pInst->iArrayBufferItems) {
+            iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+            break;
+        }
+        BIGNUM_T numVal = 0;
+        switch (cType) {
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+            case 'L': { /* [l]ong <==> 64 bit */
+                eDataType = uSHELL_DATA_TYPE_64BIT_ARRAY;
+                if (uSHELL_ERR_OK == (iRetVal = m_CoreParseArrayNumber(pstrToken, uSHELL_MAX_VALUE_64BIT, &numVal))) {
+                    ((num64_t *)m_pInst->puArrayBuffer)[iNrItems] = (num64_t)numVal;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+            case 'I': { /* [i]nteger <==> 32 bit */
+                eDataType = uSHELL_DATA_TYPE_32BIT_ARRAY;
+                if (uSHELL_ERR_OK == (iRetVal = m_CoreParseArrayNumber(pstrToken, uSHELL_MAX_VALUE_32BIT, &numVal))) {
+                    ((num32_t *)m_pInst->puArrayBuffer)[iNrItems] = (num32_t)numVal;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+            case 'W': { /* [w]ord <==> 16 bit */
+                eDataType = uSHELL_DATA_TYPE_16BIT_ARRAY;
+                if (uSHELL_ERR_OK == (iRetVal = m_CoreParseArrayNumber(pstrToken, uSHELL_MAX_VALUE_16BIT, &numVal))) {
+                    ((num16_t *)m_pInst->puArrayBuffer)[iNrItems] = (num16_t)numVal;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+            case 'B': { /* [b]yte <==> 8 bit */
+                eDataType = uSHELL_DATA_TYPE_8BIT_ARRAY;
+                if (uSHELL_ERR_OK == (iRetVal = m_CoreParseArrayNumber(pstrToken, uSHELL_MAX_VALUE_8BIT, &numVal))) {
+                    ((num8_t *)m_pInst->puArrayBuffer)[iNrItems] = (num8_t)numVal;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+            case 'F': {
+                eDataType = uSHELL_DATA_TYPE_FLOAT_ARRAY;
+                numfp_t fpVal = 0;
+                if (false == asc2float(pstrToken, &fpVal)) {
+                    iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                } else {
+                    ((numfp_t *)m_pInst->puArrayBuffer)[iNrItems] = fpVal;
+                }
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+            case 'S': { /* [s]tring <==> (char*), the strings stay in the input buffer */
+                eDataType = uSHELL_DATA_TYPE_STRING_ARRAY;
+                ((str_t **)m_pInst->puArrayBuffer)[iNrItems] = pstrToken;
+            } break;
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+            default: {
+                iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+            } break;
+        }
+        if (uSHELL_ERR_OK == iRetVal) {
+            ++iNrItems;
+            pstrToken = m_CoreNextArrayItem(cType, ppstrRest, &iRetVal);
+        }
+    }
+
+    m_sCommand.pvArray = m_pInst->puArrayBuffer;
+    m_sCommand.iNrArrayItems = iNrItems;
+    if ((uSHELL_ERR_OK != iRetVal) && (uSHELL_DATA_TYPE_LAST != eDataType)) {
+        m_sCommand.eDataType = eDataType;
+    }
+    return iRetVal;
+} /* m_CoreParseArray() */
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreParseArrayNumber(const char *pstrToken, const BIGNUM_T numMaxValue, BIGNUM_T *pNumVal) {
+    if (false == asc2int(pstrToken, pNumVal)) {
+        return uSHELL_ERR_INVALID_NUMBER;
+    }
+    return (*pNumVal > numMaxValue) ? uSHELL_ERR_VALUE_TOO_BIG : uSHELL_ERR_OK;
+} /* m_CoreParseArrayNumber() */
+
+/*----------------------------------------------------------------------------*/
+char *Microshell::m_CoreNextArrayItem(const char cType, char **ppstrRest, int *piRetVal) {
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+#if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
+    if ('S' == cType) {
+        while ((nullptr != *ppstrRest) && (*m_pstrTokenSeparator == **ppstrRest)) {
+            (*ppstrRest)++; /* cleanup the leading separators */
+        }
+        if ((nullptr != *ppstrRest) && (m_cStringBorderSymbol == **ppstrRest)) {
+            char *pstrItem = *ppstrRest + 1;
+            char *pstrEnd = strchr(pstrItem, m_cStringBorderSymbol);
+            if (nullptr == pstrEnd) {
+                *piRetVal = uSHELL_ERR_STRING_NOT_CLOSED;
+                return nullptr;
+            }
+            *pstrEnd = '\0';
+            *ppstrRest = pstrEnd + 1;
+            return pstrItem;
+        }
+    }
+#endif /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS)*/
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+    (void)cType;
+    (void)piRetVal;
+    return strtok_ex(*ppstrRest, m_pstrTokenSeparator, ppstrRest);
+} /* m_CoreNextArrayItem() */
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+
 /*----------------------------------------------------------------------------*/
 void Microshell::m_CoreResetInput(const bool bFull) {
     memset(m_pstrInput, 0, sizeof(m_pstrInput));
@@ -479,6 +1233,372 @@ void Microshell::m_CoreResetInput(const bool bFull) {
     }
 } /* m_CoreResetInput() */
 
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+/*----------------------------------------------------------------------------*/
+/* the jobs run until a key comes: the line being typed is cleared before their output and redrawn after it */
+void Microshell::m_CoreRunJobs(void) {
+    jobEnd_s vsEnded[uSHELL_MAX_JOBS];
+    while (true == ushell_jobs_pending()) {
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+        jobsOutput_s sOutput = { nullptr, false };
+        outputSink_s sSink = output_sink_callback(m_CoreJobsOutput, &sOutput);
+        sOutput.psPrevSink = output_redirect(&sSink);
+        const size_t szEnded = ushell_jobs_run(vsEnded);
+        output_redirect(sOutput.psPrevSink);
+        bool bRedraw = sOutput.bWritten;
+#else
+        const size_t szEnded = ushell_jobs_run(vsEnded);
+        bool bRedraw = false;
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+        for (size_t i = 0U; i < szEnded; ++i) {
+            if (false == bRedraw) {
+                m_CorePutString("\r\033[K");
+                bRedraw = true;
+            }
+            if (vsEnded[i].iResult >= 0) {
+                uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "[%u] %s => %d (0x%X)\n"), (unsigned int)vsEnded[i].uId, vsEnded[i].pstrName, vsEnded[i].iResult, vsEnded[i].iResult);
+            } else {
+                uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "[%u] %s => %d\n"), (unsigned int)vsEnded[i].uId, vsEnded[i].pstrName, vsEnded[i].iResult);
+            }
+        }
+        if (true == bRedraw) {
+            m_CorePrintPrompt();
+            m_CorePutString(m_pstrInput);
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+            if ((true == m_bEditMode) && (m_iCursorPos < m_iInputPos)) {
+                uSHELL_PRINTF("\033[%dD", m_iInputPos - m_iCursorPos);
+            }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+        }
+        if ((false == ushell_jobs_pending()) || (true == ushell_jobs_wait_key())) {
+            break;
+        }
+    }
+} /* m_CoreRunJobs() */
+
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+/*----------------------------------------------------------------------------*/
+/* output of the jobs during a pass, passed to the previous sink once the line being typed is cleared */
+void Microshell::m_CoreJobsOutput(const char *pstrText, size_t szLength, void *pvContext) {
+    jobsOutput_s *psOutput = static_cast<jobsOutput_s *>(pvContext);
+    outputSink_s *psSink = output_redirect(psOutput->psPrevSink);
+    if (false == psOutput->bWritten) {
+        m_CorePutString("\r\033[K");
+        psOutput->bWritten = true;
+    }
+    uSHELL_PRINTF("%.*s", (int)szLength, pstrText);
+    output_redirect(psSink);
+} /* m_CoreJobsOutput() */
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreShowJobs(void) {
+    int iNrJobs = 0;
+    for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+        const job_s *psJob = ushell_job_get(i);
+        if (nullptr == psJob) {
+            continue;
+        }
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "[%u] %-16s %-6s"), (unsigned int)psJob->uId, psJob->pstrName, job_wait_name(psJob->eWait));
+        if ((JOB_WAIT_READ == psJob->eWait) || (JOB_WAIT_WRITE == psJob->eWait)) {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, " fd %d"), psJob->iFd);
+        }
+        if (0U != psJob->ullDeadlineMs) {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, " %u ms"), (unsigned int)ushell_job_remaining_ms(psJob));
+        }
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        const cancelReason_e eReason = cancel_token_reason(&psJob->sToken);
+        if (CANCEL_NONE != eReason) {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, " | %s"), cancel_reason_name(eReason));
+        } else if (0U != cancel_token_left_ms(&psJob->sToken)) {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, " | timeout %u ms"), (unsigned int)cancel_token_left_ms(&psJob->sToken));
+        }
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, " | resumed %u\n"), (unsigned int)psJob->uResumes);
+        ++iNrJobs;
+    }
+    if (0 == iNrJobs) {
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "no jobs\n"));
+    }
+} /* m_CoreShowJobs() */
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/*----------------------------------------------------------------------------*/
+/* #j<id>: the token of the job fires, it is resumed at the next pass to end */
+void Microshell::m_CoreCancelJob(const char *pstrId) {
+    BIGNUM_T numId = 0;
+    while (uSHELL_KEY_SPACE == *pstrId) {
+        ++pstrId;
+    }
+    if ((true == asc2int(pstrId, &numId)) && (true == ushell_job_cancel((uint32_t)numId))) {
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "[%u] %s\n"), (unsigned int)numId, cancel_reason_name(CANCEL_REQUEST));
+    } else {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "no job %s\n"), pstrId);
+    }
+} /* m_CoreCancelJob() */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/*----------------------------------------------------------------------------*/
+/* #t: the timeout of the commands, #t<ms>: a new one (0: none) */
+void Microshell::m_CoreSetTimeout(const char *pstrArgs) {
+    BIGNUM_T numMs = 0;
+    if (nullptr != pstrArgs) {
+        while (uSHELL_KEY_SPACE == *pstrArgs) {
+            ++pstrArgs;
+        }
+        if ((false == asc2int(pstrArgs, &numMs)) || ((uint64_t)numMs > (uint64_t)UINT32_MAX)) {
+            uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "invalid timeout %s\n"), pstrArgs);
+            return;
+        }
+        m_uCommandTimeoutMs = (uint32_t)numMs;
+    }
+    if (0U == m_uCommandTimeoutMs) {
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "timeout none\n"));
+    } else {
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "timeout %u ms\n"), (unsigned int)m_uCommandTimeoutMs);
+    }
+} /* m_CoreSetTimeout() */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+/*----------------------------------------------------------------------------*/
+/* #p<workers> command ... {first..last[..step]}|{a,b,...} ...: a line per value, the results in their order */
+void Microshell::m_CoreFanOut(const char *pstrArgs) {
+    char vstrTemplate[uSHELL_MAX_INPUT_BUF_LEN];
+    unsigned int uWorkers = uSHELL_FAN_OUT_WORKERS;
+    fanOut_s sFanOut;
+
+    if (0 != isdigit((unsigned char)*pstrArgs)) {
+        char *pstrEnd = nullptr;
+        const unsigned long ulWorkers = strtoul(pstrArgs, &pstrEnd, 10);
+        if ((0UL == ulWorkers) || (ulWorkers > FAN_OUT_MAX_WORKERS)) {
+            uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "workers 1..%u\n"), (unsigned int)FAN_OUT_MAX_WORKERS);
+            return;
+        }
+        uWorkers = (unsigned int)ulWorkers;
+        pstrArgs = pstrEnd;
+    }
+    while (uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+    strcpy(vstrTemplate, pstrArgs); /* the lines are built into the input buffer */
+    const fanOutError_e eError = fan_out_parse(&sFanOut, vstrTemplate);
+    if (FAN_OUT_TOO_MANY == eError) {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "#p: %llu values, %u at most (uSHELL_FAN_OUT_MAX_ITEMS)\n"), (unsigned long long)sFanOut.ullValues, (unsigned int)uSHELL_FAN_OUT_MAX_ITEMS);
+        return;
+    }
+    if (FAN_OUT_OK != eError) {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "#p[workers] command ... {first..last[..step]}|{a,b,...} ...\n"));
+        return;
+    }
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    cancelToken_s sToken; /* Ctrl-C: the lines running stop, the ones left do not run */
+    cancel_token_init(&sToken, 0U);
+    cancelToken_s *psPrevious = ushell_cancel_enter(&sToken, true);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    const uint64_t ullStartUs = fan_out_now_us();
+#if defined(uSHELL_FAN_OUT_THREADS)
+    if ((uWorkers < 2U) || (false == m_CoreFanOutParallel(&sFanOut, uWorkers))) {
+        uWorkers = 1U;
+        m_CoreFanOutSerial(&sFanOut);
+    }
+#else
+    uWorkers = 1U;
+    m_CoreFanOutSerial(&sFanOut);
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+    const uint64_t ullElapsedUs = fan_out_now_us() - ullStartUs;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    ushell_cancel_leave(&sToken, psPrevious);
+    cancel_token_release(&sToken);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    m_CoreFanOutReport(&sFanOut, uWorkers, ullElapsedUs);
+} /* m_CoreFanOut() */
+
+/*----------------------------------------------------------------------------*/
+/* one line after the other on the shell thread, like typed: the output comes as it is printed */
+void Microshell::m_CoreFanOutSerial(const fanOut_s *psFanOut) {
+    for (size_t i = 0U; i < psFanOut->szItems; ++i) {
+        fanResult_s *psResult = &m_vsFanOutResults[i];
+        const uint64_t ullStartUs = fan_out_now_us();
+        memset(psResult, 0, sizeof(*psResult));
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        psResult->iError = m_CoreStopError(ushell_stop_reason());
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+        if ((uSHELL_ERR_OK == psResult->iError) && (false == fan_out_line(psFanOut, i, m_pstrInput, sizeof(m_pstrInput)))) {
+            psResult->iError = uSHELL_ERR_INPUT_TOO_LONG;
+        }
+        if (uSHELL_ERR_OK == psResult->iError) {
+            memset(&m_sCommand, 0, sizeof(m_sCommand));
+            psResult->iError = m_CoreExecuteInput(&psResult->iRetVal, true);
+        }
+        psResult->uElapsedUs = (uint32_t)(fan_out_now_us() - ullStartUs);
+        m_CoreFanOutResult(psFanOut, i);
+    }
+} /* m_CoreFanOutSerial() */
+
+#if defined(uSHELL_FAN_OUT_THREADS)
+/*----------------------------------------------------------------------------*/
+/* the lines are parsed on the shell thread, then run by the threads; false if one of them can not be
+ * (a command not marked thread safe, a reader, an array or a file argument): nothing ran */
+bool Microshell::m_CoreFanOutParallel(const fanOut_s *psFanOut, const unsigned int uWorkers) {
+    fanItem_s *psItems = static_cast<fanItem_s *>(calloc(psFanOut->szItems, sizeof(fanItem_s)));
+    bool bParallel = (nullptr != psItems);
+    size_t szPrepared = 0U;
+
+    for (; (true == bParallel) && (szPrepared < psFanOut->szItems); ++szPrepared) {
+        bParallel = m_CoreFanOutPrepare(psFanOut, szPrepared, &psItems[szPrepared]);
+    }
+    if (true == bParallel) {
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        fanRun_s sRun = { psItems, ushell_cancel_current() };
+#else
+        fanRun_s sRun = { psItems };
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+        fan_out_run(psFanOut->szItems, uWorkers, m_CoreFanOutItem, &sRun);
+        for (size_t i = 0U; i < psFanOut->szItems; ++i) {
+            if (0U != psItems[i].sOutput.szLength) {
+                uSHELL_PRINTF("%.*s", (int)psItems[i].sOutput.szLength, psItems[i].sOutput.pBuffer);
+            }
+            m_CoreFanOutResult(psFanOut, i);
+        }
+    }
+    for (size_t i = 0U; i < szPrepared; ++i) {
+        output_sink_release(&psItems[i].sOutput);
+    }
+    free(psItems);
+    return bParallel;
+} /* m_CoreFanOutParallel() */
+
+/*----------------------------------------------------------------------------*/
+/* a line parsed into its item, its parsing errors go into its output */
+bool Microshell::m_CoreFanOutPrepare(const fanOut_s *psFanOut, const size_t szItem, fanItem_s *psItem) {
+    fanResult_s *psResult = &m_vsFanOutResults[szItem];
+    bool bThreadSafe = true;
+
+    memset(psResult, 0, sizeof(*psResult));
+    memset(&m_sCommand, 0, sizeof(m_sCommand));
+    psItem->sOutput = output_sink_arena();
+    outputSink_s *psPrevSink = output_redirect(&psItem->sOutput);
+    if (false == fan_out_line(psFanOut, szItem, m_pstrInput, sizeof(m_pstrInput))) {
+        psResult->iError = uSHELL_ERR_INPUT_TOO_LONG;
+    } else if (uSHELL_ERR_OK != (psResult->iError = m_CoreParseCommand())) {
+        m_CorePrintError(psResult->iError);
+    } else {
+        const fctDef_s *psFctDef = &m_pInst->psFuncDefArray[m_sCommand.iFctIndex];
+        bThreadSafe = (true == psFctDef->bThreadSafe) && (nullptr == strpbrk(psFctDef->pstrFuncParamDef, "rLIWBFS")); /* the reader and the arrays are in the instance */
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+        bThreadSafe = bThreadSafe && (0U == m_iNrFileArgs);
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+        psItem->sCommand = m_sCommand;
+        psItem->pfExec = m_pInst->pfExec;
+        memcpy(psItem->vstrInput, m_pstrInput, sizeof(m_pstrInput));
+        m_CoreFanOutRelocate(psItem);
+    }
+    output_redirect(psPrevSink);
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+    m_CoreReleaseFileArgs();
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+    m_CoreCloseReader();
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    m_CoreRestoreInstance();
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+    return bThreadSafe;
+} /* m_CoreFanOutPrepare() */
+
+/*----------------------------------------------------------------------------*/
+/* the arguments which point into the input buffer point into the copy of the item */
+void Microshell::m_CoreFanOutRelocate(fanItem_s *psItem) {
+    auto relocate = [psItem](const char *pstrText) -> char * {
+        const bool bInInput = (pstrText >= m_pstrInput) && (pstrText < (m_pstrInput + sizeof(m_pstrInput)));
+        return bInInput ? (psItem->vstrInput + (pstrText - m_pstrInput)) : const_cast<char *>(pstrText);
+    };
+    psItem->sCommand.pstrFctName = relocate(psItem->sCommand.pstrFctName);
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+    for (unsigned int i = 0U; i < psItem->sCommand.iNrStrings; ++i) {
+        psItem->sCommand.vs[i] = relocate(psItem->sCommand.vs[i]);
+    }
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+#if defined(uSHELL_IMPLEMENTS_BLOB)
+    for (unsigned int i = 0U; i < psItem->sCommand.iNrBlobs; ++i) {
+        psItem->sCommand.vx[i].pData = (const uint8_t *)relocate((const char *)psItem->sCommand.vx[i].pData);
+    }
+#endif /* defined(uSHELL_IMPLEMENTS_BLOB) */
+} /* m_CoreFanOutRelocate() */
+
+/*----------------------------------------------------------------------------*/
+/* a thread runs a line under the token of #p, with the timeout of the commands */
+void Microshell::m_CoreFanOutItem(size_t szItem, void *pvContext) {
+    const fanRun_s *psRun = static_cast<const fanRun_s *>(pvContext);
+    fanItem_s *psItem = &psRun->psItems[szItem];
+    fanResult_s *psResult = &m_vsFanOutResults[szItem];
+
+    if (uSHELL_ERR_OK != psResult->iError) {
+        return; /* not parsed */
+    }
+    outputSink_s *psPrevSink = output_redirect(&psItem->sOutput);
+    const uint64_t ullStartUs = fan_out_now_us();
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    ushell_cancel_adopt(psRun->psToken);
+    psResult->iError = m_CoreStopError(ushell_stop_reason());
+    if (uSHELL_ERR_OK == psResult->iError) {
+        cancelToken_s sToken;
+        cancel_token_init(&sToken, m_uCommandTimeoutMs);
+        cancelToken_s *psPrevious = ushell_cancel_enter(&sToken, false);
+        psResult->iRetVal = psItem->pfExec(&psItem->sCommand);
+        psResult->iError = m_CoreStopError(cancel_token_reason(&sToken));
+        ushell_cancel_leave(&sToken, psPrevious);
+        cancel_token_release(&sToken);
+    }
+#else
+    psResult->iRetVal = psItem->pfExec(&psItem->sCommand);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    psResult->uElapsedUs = (uint32_t)(fan_out_now_us() - ullStartUs);
+    output_redirect(psPrevSink);
+} /* m_CoreFanOutItem() */
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreFanOutResult(const fanOut_s *psFanOut, const size_t szItem) {
+    char vstrLine[uSHELL_MAX_INPUT_BUF_LEN];
+    const fanResult_s *psResult = &m_vsFanOutResults[szItem];
+
+    (void)fan_out_line(psFanOut, szItem, vstrLine, sizeof(vstrLine)); /* cut if it is too long */
+    if (uSHELL_ERR_OK != psResult->iError) {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r[%u] %s => error %d | %u us\n"), (unsigned int)szItem, vstrLine, psResult->iError, (unsigned int)psResult->uElapsedUs);
+    } else if (psResult->iRetVal >= 0) {
+        uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r[%u] %s => %d (0x%X) | %u us\n"), (unsigned int)szItem, vstrLine, psResult->iRetVal, psResult->iRetVal, (unsigned int)psResult->uElapsedUs);
+    } else {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r[%u] %s => %d | %u us\n"), (unsigned int)szItem, vstrLine, psResult->iRetVal, (unsigned int)psResult->uElapsedUs);
+    }
+} /* m_CoreFanOutResult() */
+
+/*----------------------------------------------------------------------------*/
+/* the lines which failed did not run or returned a negative value */
+void Microshell::m_CoreFanOutReport(const fanOut_s *psFanOut, const unsigned int uWorkers, const uint64_t ullElapsedUs) {
+    uint32_t uMinUs = UINT32_MAX;
+    uint32_t uMaxUs = 0U;
+    uint64_t ullSumUs = 0U;
+    unsigned int uFailed = 0U;
+
+    for (size_t i = 0U; i < psFanOut->szItems; ++i) {
+        const fanResult_s *psResult = &m_vsFanOutResults[i];
+        uMinUs = (psResult->uElapsedUs < uMinUs) ? psResult->uElapsedUs : uMinUs;
+        uMaxUs = (psResult->uElapsedUs > uMaxUs) ? psResult->uElapsedUs : uMaxUs;
+        ullSumUs += psResult->uElapsedUs;
+        uFailed += ((uSHELL_ERR_OK != psResult->iError) || (psResult->iRetVal < 0)) ? 1U : 0U;
+    }
+    const uint64_t ullRate = (0U != ullElapsedUs) ? (((uint64_t)psFanOut->szItems * 1000000U) / ullElapsedUs) : 0U;
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "%u lines | %u failed | %u threads | %u.%03u ms | %u lines/s\n"),
+                  (unsigned int)psFanOut->szItems, uFailed, uWorkers, (unsigned int)(ullElapsedUs / 1000U), (unsigned int)(ullElapsedUs % 1000U), (unsigned int)ullRate);
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "latency min %u | avg %u | max %u us\n"),
+                  (unsigned int)uMinUs, (unsigned int)(ullSumUs / psFanOut->szItems), (unsigned int)uMaxUs);
+} /* m_CoreFanOutReport() */
+#endif /* (1 == uSHELL_SUPPORTS_FAN_OUT) */
+
 /*----------------------------------------------------------------------------*/
 inline void Microshell::m_CorePutString(const char *pstrArray) {
     while (*pstrArray) {
@@ -579,8 +1699,34 @@ void Microshell::m_CoreProcessKeyPress(const char cKeyPressed) {
 
 } /* m_CoreProcessKeyPress() */
 
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_SUPPORTS_KEY_METER)
+keyClass_e Microshell::m_CoreKeyClass(const char cKeyPressed) {
+    switch (cKeyPressed) {
+    case uSHELL_KEY_TAB:
+        return KEY_CLASS_TAB;
+    case uSHELL_KEY_ENTER:
+        return KEY_CLASS_ENTER;
+    default:
+        break;
+    }
+    if (true == uSHELL_ISPRINT(cKeyPressed)) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+        if ((true == m_bEditMode) && (m_iCursorPos < m_iInputPos)) {
+            return KEY_CLASS_EDIT_INSERT;
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+        return KEY_CLASS_TYPING;
+    }
+    return KEY_CLASS_OTHER; /* the escape sequences are classified once decoded */
+} /* m_CoreKeyClass() */
+#endif /* (1 == uSHELL_SUPPORTS_KEY_METER) */
+
 /*----------------------------------------------------------------------------*/
 void Microshell::m_CoreExecuteEnterKey(void) {
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    m_CoreReloadInstance();
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
     if (false == m_CoreHandleShortcuts()) {
 #if (1 == uSHELL_IMPLEMENTS_HISTORY)
         m_HistoryWrite();
@@ -597,6 +1743,9 @@ void Microshell::m_CoreHandleKeyEnter(void) {
         if (m_iInputPos > 0) {
             m_CoreExecuteEnterKey();
             m_CoreResetInput(true);
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+            m_CoreReloadInstance(); /* the next command is typed against the new table */
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
             m_AutocomplReset(uSHELL_AUTOCOMPL_RELOAD);
         } else {
@@ -655,6 +1804,9 @@ void Microshell::m_CoreHandleKeyEscapeSeq(void) {
         switch (uSHELL_GETCH()) {             /* get the ecape sequence */
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)
         case uSHELL_KEY_ESCAPESEQ_ARROW_UP: {
+#if (1 == uSHELL_SUPPORTS_KEY_METER)
+            ushell_key_meter_class(KEY_CLASS_HISTORY_UP);
+#endif /* (1 == uSHELL_SUPPORTS_KEY_METER) */
             m_CoreHandleKeyArrowUpDown(uSHELL_DIR_FORWARD);
         } break;
         case uSHELL_KEY_ESCAPESEQ_ARROW_DOWN: {
@@ -887,7 +2039,7 @@ void Microshell::m_CoreHandleShortcut_Hash(const char *pstrArgs) {
     const char cKey = *pstrArgs;
 
     if ('\0' != cKey) {
-#if ((0 == uSHELL_IMPLEMENTS_COMMAND_HELP) || (1 == uSHELL_IMPLEMENTS_SHELL_EXIT) || (1 == uSHELL_IMPLEMENTS_KEY_DECODER) || (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) || (1 == uSHELL_IMPLEMENTS_HISTORY))
+#if ((0 == uSHELL_IMPLEMENTS_COMMAND_HELP) || (1 == uSHELL_IMPLEMENTS_SHELL_EXIT) || (1 == uSHELL_IMPLEMENTS_KEY_DECODER) || (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) || (1 == uSHELL_IMPLEMENTS_HISTORY) || (1 == uSHELL_SUPPORTS_COROUTINES) || (1 == uSHELL_SUPPORTS_CANCELLATION))
         bool bNoParams = ('\0' == *(pstrArgs + 1));
 #endif
         switch (cKey) {
@@ -924,6 +2076,32 @@ void Microshell::m_CoreHandleShortcut_Hash(const char *pstrArgs) {
             }
         } break; /* exit shell */
 #endif           /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT) */
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+        case 'j': {
+            if (bNoParams) {
+                m_CoreShowJobs();
+                iError = 0;
+            }
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+            else {
+                m_CoreCancelJob(pstrArgs + 1);
+                iError = 0;
+            }
+#endif /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+        } break; /* list the jobs, #j<id> stops one */
+#endif           /*(1 == uSHELL_SUPPORTS_COROUTINES)*/
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        case 't': {
+            m_CoreSetTimeout(bNoParams ? nullptr : (pstrArgs + 1));
+            iError = 0;
+        } break; /* timeout of the commands */
+#endif           /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+        case 'p': {
+            m_CoreFanOut(pstrArgs + 1);
+            iError = 0;
+        } break; /* one command over a range or a list of values */
+#endif           /*(1 == uSHELL_SUPPORTS_FAN_OUT)*/
 #if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
         case 'k': {
             if (bNoParams) {
@@ -1041,6 +2219,56 @@ int Microshell::m_CoreSearchFunction(const char *pstrFctName) {
     return uSHELL_ERR_FUNCTION_NOT_FOUND;
 } /* m_CoreSearchFunction() */
 
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreResolveFunction(const char *pstrFctName) {
+    int iFctIndex = uSHELL_ERR_FUNCTION_NOT_FOUND;
+    uShellInst_s *psOwner = nullptr;
+    if ((nullptr != pstrFctName) && (nullptr != m_pInst->pfResolve) &&
+        (nullptr != (psOwner = m_pInst->pfResolve(pstrFctName, &iFctIndex)))) {
+        if ((iFctIndex >= 0) && (iFctIndex < psOwner->iNrFunctions)) {
+            /* the command is parsed and executed in the context of its owner */
+            m_pInstCaller = m_pInst;
+            m_pInst = psOwner;
+        } else {
+            iFctIndex = uSHELL_ERR_FUNCTION_NOT_FOUND;
+        }
+    }
+    return iFctIndex;
+} /* m_CoreResolveFunction() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreRestoreInstance(void) {
+    if (nullptr != m_pInstCaller) {
+        m_pInst = m_pInstCaller;
+        m_pInstCaller = nullptr;
+    }
+} /* m_CoreRestoreInstance() */
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreReloadInstance(void) {
+    uShellInst_s *psShellInst = nullptr;
+    while ((nullptr != m_pInst->pfReload) && (nullptr != (psShellInst = m_pInst->pfReload(m_pInst))) && (psShellInst != m_pInst)) {
+        /* the new instance takes over the prompt; the history is kept as it is */
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+        psShellInst->pstrPromptName = m_pInst->pstrPromptName;
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
+        memcpy(psShellInst->vstrPrompt, m_pInst->vstrPrompt, sizeof(psShellInst->vstrPrompt));
+        psShellInst->iPromptLength = m_pInst->iPromptLength;
+        m_pInst = psShellInst;
+        m_pInst->psShortcutsArray[0] = {'#', m_CoreHandleShortcut_Hash};
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+        m_pInst->bKeepRuning = true;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplReset(uSHELL_AUTOCOMPL_RELOAD);
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+    }
+} /* m_CoreReloadInstance() */
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+
 /*----------------------------------------------------------------------------*/
 inline void Microshell::m_CoreSetPrompt(const char *pstrPromptExt) {
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
@@ -2091,10 +3319,29 @@ void Microshell::keydecoder(void) {
 ==============================================================================*/
 
 uShellInst_s *Microshell::m_pInst = nullptr;
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+uShellInst_s *Microshell::m_pInstCaller = nullptr;
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
 command_s Microshell::m_sCommand = {};
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+bool Microshell::m_bBatchMode = false;
+#endif /*(1 == uSHELL_SUPPORTS_BATCH_MODE)*/
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+uint32_t Microshell::m_uCommandTimeoutMs = uSHELL_COMMAND_TIMEOUT_MS;
+#endif /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+fanResult_s Microshell::m_vsFanOutResults[uSHELL_FAN_OUT_MAX_ITEMS] = {};
+#endif /*(1 == uSHELL_SUPPORTS_FAN_OUT)*/
 char Microshell::m_pstrInput[uSHELL_MAX_INPUT_BUF_LEN] = {0};
 int Microshell::m_iInputPos = 0;
 int Microshell::m_iCursorPos = 0;
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+fileview_t Microshell::m_vsFileArgs[uSHELL_MAX_FILE_ARGS] = {};
+unsigned int Microshell::m_iNrFileArgs = 0U;
+#endif /*(1 == uSHELL_SUPPORTS_FILE_ARGS)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+reader_t Microshell::m_sReader = {};
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
 
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
 uShellInst_s *Microshell::m_pInstBackup = nullptr;
@@ -2197,4 +3444,17 @@ const char *Microshell::m_pstrCoreShortcutCaption = "\t##|#|i|s : info short|all
 #if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
                                                     "\t#k : keydecoder\n\r"
 #endif /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+                                                    "\t#j|j<id> : jobs (coroutine commands waiting)|stop job <id>\n\r"
+#else
+                                                    "\t#j : jobs (coroutine commands waiting)\n\r"
+#endif /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+#endif /*(1 == uSHELL_SUPPORTS_COROUTINES)*/
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+                                                    "\t#t|t<ms> : timeout of the commands|set it (0: none), Ctrl-C stops a command\n\r"
+#endif /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+                                                    "\t#p<n> cmd {a..b[..s]}|{x,y} : a line per value, on n threads if cmd is thread safe\n\r"
+#endif /*(1 == uSHELL_SUPPORTS_FAN_OUT)*/
                                                     ;
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "ushell_core_settings.h"
 
 #include <cstddef>
+#include <cstdint>
 #if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
 #include <cstdio>
 #endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
@@ -28,11 +29,16 @@ enum {
     uSHELL_ERR_FUNCTION_NOT_FOUND        = -2,
     uSHELL_ERR_WRONG_NUMBER_ARGS         = -3,
     uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM     = -4,
-    uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM = -5,
+    /* -5: not used (pattern without dispatch code), a pattern is checked at build time now */
     uSHELL_ERR_STRING_NOT_CLOSED         = -6,
     uSHELL_ERR_TOO_MANY_ARGS             = -7,
     uSHELL_ERR_INVALID_NUMBER            = -8,
     uSHELL_ERR_VALUE_TOO_BIG             = -9,
+    uSHELL_ERR_FILE_NOT_READABLE         = -10,
+    uSHELL_ERR_INPUT_TOO_LONG            = -11,
+    uSHELL_ERR_NO_TASK_FRAME             = -12,
+    uSHELL_ERR_INTERRUPTED               = -13,
+    uSHELL_ERR_TIMEOUT                   = -14,
     uSHELL_ERR_LAST
 };
 
@@ -89,6 +95,64 @@ typedef struct {
 } autocomplete_s;
 #endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
 
+#if defined(uSHELL_IMPLEMENTS_BLOB)
+/** \brief binary blob, given in hex on the command line and decoded in place in the input buffer */
+typedef struct {
+    const uint8_t *pData;
+    size_t         szLength;
+} blob_t;
+#endif /* defined(uSHELL_IMPLEMENTS_BLOB) */
+
+#if (1 == uSHELL_SUPPORTS_READER)
+/** \brief input of a streaming command, read with ushell_read() (ushell_core_reader.h) */
+typedef struct reader_s reader_t;
+#endif /* (1 == uSHELL_SUPPORTS_READER) */
+
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+/** \brief item of the array buffer of an instance: the items of an array parameter are
+ *  stored contiguously, with the size of their type, starting at the beginning of the buffer */
+typedef union {
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+    num64_t      l;
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+    num32_t      i;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+    num16_t      w;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT) */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+    num8_t       b;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT) */
+#ifdef uSHELL_IMPLEMENTS_NUMBERS_FLOAT
+    numfp_t      f;
+#endif /* uSHELL_IMPLEMENTS_NUMBERS_FLOAT */
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+    str_t*       s;
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+} arrayItem_u;
+
+/** \brief array parameters as received by the commands: pointer to the first item and count */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)             /* 'L' */
+typedef struct { const num64_t *pItems; unsigned int iNrItems; } num64_span_t;
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)             /* 'I' */
+typedef struct { const num32_t *pItems; unsigned int iNrItems; } num32_span_t;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)             /* 'W' */
+typedef struct { const num16_t *pItems; unsigned int iNrItems; } num16_span_t;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT) */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)              /* 'B' */
+typedef struct { const num8_t *pItems; unsigned int iNrItems; } num8_span_t;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT) */
+#ifdef uSHELL_IMPLEMENTS_NUMBERS_FLOAT                   /* 'F' */
+typedef struct { const numfp_t *pItems; unsigned int iNrItems; } numfp_span_t;
+#endif /* uSHELL_IMPLEMENTS_NUMBERS_FLOAT */
+#if defined(uSHELL_IMPLEMENTS_STRINGS)                   /* 'S' */
+typedef struct { str_t* const *pItems; unsigned int iNrItems; } str_span_t;
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+
 /* parsing storage structure */
 typedef struct {
     const char*  pstrFctName;
@@ -120,6 +184,17 @@ typedef struct {
     bool         vo[uSHELL_MAX_PARAMS_BOOLEAN];
     unsigned int iNrBools;
 #endif /*defined(uSHELL_IMPLEMENTS_BOOLEAN)*/
+#if defined(uSHELL_IMPLEMENTS_BLOB)                      /* hex blob -> 'x' (he[x]) */
+    blob_t       vx[uSHELL_MAX_PARAMS_BLOB];
+    unsigned int iNrBlobs;
+#endif /*defined(uSHELL_IMPLEMENTS_BLOB)*/
+#if (1 == uSHELL_SUPPORTS_READER)                        /* reader -> 'r' ([r]eader), last parameter */
+    reader_t*    psReader;
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)                  /* L I W B F S, last parameter */
+    const void*  pvArray;
+    unsigned int iNrArrayItems;
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
     int         iFctIndex;
     int         iTypIndex;
     int         iErrorInfo;
@@ -129,6 +204,7 @@ typedef struct {
 typedef struct {
     const char* const pstrFctName;
     const char* const pstrFuncParamDef;
+    const bool        bThreadSafe;          /* uSHELL_COMMAND_MT: may run on several threads at once (#p) */
 } fctDef_s;
 
 /** \brief command execution function pointer */
@@ -143,8 +219,23 @@ typedef struct {
     PFSHORTCUT pfShortcut;
 } shortcut_s;
 
+struct uShellInst_s_;
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+/** \brief external command resolver: returns the instance owning the command (and sets
+ *  the index of the command in the table of that instance) or nullptr if the name is unknown */
+typedef struct uShellInst_s_ *(*PFRESOLVE)(const char *pstrFctName, int *piFctIndex);
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+/** \brief reload hook, called between two commands: returns the instance to continue with,
+ *  a different one if the instance was replaced; it is called again on the new instance,
+ *  which lets the owner release the replaced one */
+typedef struct uShellInst_s_ *(*PFRELOAD)(struct uShellInst_s_ *psShellInst);
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+
 /** \brief main structure */
-typedef struct {
+typedef struct uShellInst_s_ {
     const fctDef_s         *const psFuncDefArray;
     shortcut_s             *psShortcutsArray;
 #if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
@@ -165,6 +256,16 @@ typedef struct {
     const int               iNrFunctions;
     const int               iNrShortcuts;
     PFEXEC                  pfExec;
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    PFRESOLVE               pfResolve;
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    PFRELOAD                pfReload;
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+    arrayItem_u            *puArrayBuffer;
+    const int               iArrayBufferItems;
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
     char                    vstrPrompt[uSHELL_PROMPT_MAX_LEN];
     int                     iPromptLength;
 } uShellInst_s;
@@ -190,6 +291,17 @@ typedef struct {
     #endif
 #endif
 
+/** \brief plugin manifest: the command table of a plugin stored as plain data in a
+ *  dedicated section of the plugin image, so that it can be read without loading the plugin.
+ *  Layout: the magic string followed by one "name\0pattern\0help\0" triplet per command,
+ *  terminated by an empty name */
+#define uSHELL_MANIFEST_SECTION_NAME  ".ushell_manifest"
+#define uSHELL_MANIFEST_MAGIC         "uSHELL-MANIFEST-1"
+
+#if (defined(__GNUC__) && defined(__ELF__))
+    #define uSHELL_MANIFEST_ATTRIBUTE __attribute__ ((used, section (uSHELL_MANIFEST_SECTION_NAME)))
+#endif
+
 
 using uShellPluginInterface = uShellInst_s;
 
@@ -0,0 +1,232 @@
+#ifndef USHELL_CORE_DISPATCH_H
+#define USHELL_CORE_DISPATCH_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+
+#include <cstddef>
+#include <utility>
+
+/*
+ * Compile-time binding of the user functions to the parsed command.
+ *
+ * uShellCommand<function> deduces the parameter types of a command function and
+ * generates both its parameters pattern (the letters used by the parser, i.e.
+ * "is" for int f(num32_t, str_t*)) and a thunk with the PFEXEC signature which
+ * reads the arguments straight from the command_s slots of their types: the
+ * first 'i' is vi[0], the second 'i' is vi[1], the first 's' is vs[0], ...
+ */
+
+/** \brief letter and command_s slot of a parameter type */
+template <typename T>
+struct uShellParam {
+    static_assert(sizeof(T) == 0U, "parameter type not supported by the shell");
+};
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+template <>
+struct uShellParam<num64_t> {
+    static constexpr char cType = 'l';
+    template <std::size_t szIndex> static num64_t get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_NUM64, "too many 'l' parameters, see uSHELL_MAX_PARAMS_NUM64");
+        return psCmd->vl[szIndex];
+    }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+template <>
+struct uShellParam<num32_t> {
+    static constexpr char cType = 'i';
+    template <std::size_t szIndex> static num32_t get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_NUM32, "too many 'i' parameters, see uSHELL_MAX_PARAMS_NUM32");
+        return psCmd->vi[szIndex];
+    }
+};
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+template <>
+struct uShellParam<num16_t> {
+    static constexpr char cType = 'w';
+    template <std::size_t szIndex> static num16_t get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_NUM16, "too many 'w' parameters, see uSHELL_MAX_PARAMS_NUM16");
+        return psCmd->vw[szIndex];
+    }
+};
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+template <>
+struct uShellParam<num8_t> {
+    static constexpr char cType = 'b';
+    template <std::size_t szIndex> static num8_t get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_NUM8, "too many 'b' parameters, see uSHELL_MAX_PARAMS_NUM8");
+        return psCmd->vb[szIndex];
+    }
+};
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+template <>
+struct uShellParam<numfp_t> {
+    static constexpr char cType = 'f';
+    template <std::size_t szIndex> static numfp_t get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_FLOAT, "too many 'f' parameters, see uSHELL_MAX_PARAMS_FLOAT");
+        return psCmd->vf[szIndex];
+    }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT) */
+
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+template <>
+struct uShellParam<str_t*> {
+    static constexpr char cType = 's';
+    template <std::size_t szIndex> static str_t* get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_STRING, "too many 's' parameters, see uSHELL_MAX_PARAMS_STRING");
+        return psCmd->vs[szIndex];
+    }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+
+#if defined(uSHELL_IMPLEMENTS_BOOLEAN)
+template <>
+struct uShellParam<bool> {
+    static constexpr char cType = 'o';
+    template <std::size_t szIndex> static bool get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_BOOLEAN, "too many 'o' parameters, see uSHELL_MAX_PARAMS_BOOLEAN");
+        return psCmd->vo[szIndex];
+    }
+};
+#endif /*defined(uSHELL_IMPLEMENTS_BOOLEAN)*/
+
+#if defined(uSHELL_IMPLEMENTS_BLOB)
+template <>
+struct uShellParam<blob_t> {
+    static constexpr char cType = 'x';
+    template <std::size_t szIndex> static blob_t get(const command_s *psCmd) {
+        static_assert(szIndex < uSHELL_MAX_PARAMS_BLOB, "too many 'x' parameters, see uSHELL_MAX_PARAMS_BLOB");
+        return psCmd->vx[szIndex];
+    }
+};
+#endif /*defined(uSHELL_IMPLEMENTS_BLOB)*/
+
+#if (1 == uSHELL_SUPPORTS_READER)
+template <>
+struct uShellParam<reader_t*> {
+    static constexpr char cType = 'r';
+    template <std::size_t szIndex> static reader_t* get(const command_s *psCmd) {
+        static_assert(0U == szIndex, "only one reader parameter is supported");
+        return psCmd->psReader;
+    }
+};
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+/** \brief array parameters: one per command, the last one, read from the array slot */
+#define uSHELL_ARRAY_PARAM(span_t, item_t, letter)                                                          \
+template <>                                                                                                \
+struct uShellParam<span_t> {                                                                               \
+    static constexpr char cType = letter;                                                                  \
+    template <std::size_t szIndex> static span_t get(const command_s *psCmd) {                             \
+        static_assert(0U == szIndex, "only one array parameter is supported");                             \
+        return span_t{ static_cast<item_t>(psCmd->pvArray), psCmd->iNrArrayItems };                        \
+    }                                                                                                      \
+};
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+uSHELL_ARRAY_PARAM(num64_span_t, const num64_t*, 'L')
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+uSHELL_ARRAY_PARAM(num32_span_t, const num32_t*, 'I')
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+uSHELL_ARRAY_PARAM(num16_span_t, const num16_t*, 'W')
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT) */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+uSHELL_ARRAY_PARAM(num8_span_t, const num8_t*, 'B')
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT) */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+uSHELL_ARRAY_PARAM(numfp_span_t, const numfp_t*, 'F')
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT) */
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+uSHELL_ARRAY_PARAM(str_span_t, str_t* const*, 'S')
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+
+#undef uSHELL_ARRAY_PARAM
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+
+/** \brief parameters pattern of a list of parameter types ("v" for none) */
+template <typename... Args>
+struct uShellPattern {
+    static constexpr char vstrPattern[] = { uShellParam<Args>::cType..., '\0' };
+};
+
+template <>
+struct uShellPattern<> {
+    static constexpr char vstrPattern[] = { 'v', '\0' };
+};
+
+/** \brief binder of a command function */
+template <auto pfFunction>
+struct uShellCommand {
+    static_assert(sizeof(pfFunction) == 0U, "a shell command must be a function returning int");
+};
+
+template <typename... Args, int (*pfFunction)(Args...)>
+struct uShellCommand<pfFunction> {
+    /** \brief parameters pattern deduced from the signature of the function */
+    static constexpr const char *pstrPattern = uShellPattern<Args...>::vstrPattern;
+
+    /** \brief true if no parameter taking the rest of the input (array: upper case letter,
+     *  reader: 'r') is followed by another parameter */
+    static constexpr bool restIsLast()
+    {
+        for (std::size_t i = 0U; ('\0' != pstrPattern[i]) && ('\0' != pstrPattern[i + 1U]); ++i) {
+            if (((pstrPattern[i] >= 'A') && (pstrPattern[i] <= 'Z')) || ('r' == pstrPattern[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** \brief true if the pattern given in the commands config is the deduced one */
+    static constexpr bool matches(const char *pstrConfigPattern)
+    {
+        std::size_t i = 0U;
+        for (; '\0' != pstrPattern[i]; ++i) {
+            if (pstrConfigPattern[i] != pstrPattern[i]) {
+                return false;
+            }
+        }
+        return ('\0' == pstrConfigPattern[i]);
+    }
+
+    /** \brief call the function with the arguments of the parsed command */
+    static int thunk(const command_s *psCmd)
+    {
+        static_assert(restIsLast(), "an array or reader parameter must be the last parameter of a command");
+        return call(psCmd, std::index_sequence_for<Args...>{});
+    }
+
+private:
+    /* index of the parameter at szPos among the parameters of the same type */
+    static constexpr std::size_t slot(std::size_t szPos)
+    {
+        std::size_t szIndex = 0U;
+        for (std::size_t i = 0U; i < szPos; ++i) {
+            if (pstrPattern[i] == pstrPattern[szPos]) {
+                ++szIndex;
+            }
+        }
+        return szIndex;
+    }
+
+    template <std::size_t... szPos>
+    static int call([[maybe_unused]] const command_s *psCmd, std::index_sequence<szPos...>)
+    {
+        return pfFunction(uShellParam<Args>::template get<slot(szPos)>(psCmd)...);
+    }
+};
+
+#endif /* USHELL_CORE_DISPATCH_H */
@@ -11,6 +11,8 @@
 #define uSHELL_KEY_ESCAPE                    (0x1B)
 #define uSHELL_KEY_CTRL_U                    (0x15)
 #define uSHELL_KEY_CTRL_K                    (0x0B)
+#define uSHELL_KEY_CTRL_D                    (0x04)
+#define uSHELL_KEY_CTRL_C                    (0x03)
 #define uSHELL_KEY_QUOTATION_MARK            '"'
 
 /*key codes specific to the build environment */
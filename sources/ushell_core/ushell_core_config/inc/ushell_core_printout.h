@@ -1,6 +1,7 @@
 #ifndef USHELL_CORE_PRINTOUT_H
 #define USHELL_CORE_PRINTOUT_H
 
+#include "ushell_core_settings.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,7 +17,7 @@ extern "C" {
     int  uart_printf        (const char *format, ...);
     #define uSHELL_PRINTF   uart_printf
     #define uSHELL_SNPRINTF mini_snprintf
-    #define uSHELL_GETCH()  uart_getchar()
+    #define uSHELL_TERMINAL_GETCH() uart_getchar()
     #define uSHELL_PUTCH(x) uart_putchar(x)
 
 /* linux PC terminal */
@@ -27,7 +28,7 @@ extern "C" {
     #define uSHELL_PRINTF   printf
     #define uSHELL_SNPRINTF snprintf
     #define uSHELL_VPRINTF  vprintf
-    #define uSHELL_GETCH()  fgetc(stdin)
+    #define uSHELL_TERMINAL_GETCH() fgetc(stdin)
     #define uSHELL_PUTCH(x) putchar(x)
 
 /* i.e MinGW or Microsoft VisualStudio for Windows terminal */
@@ -39,7 +40,7 @@ extern "C" {
     #define uSHELL_PRINTF    printf
     #define uSHELL_SNPRINTF  snprintf
     #define uSHELL_VPRINTF   vprintf
-    #define uSHELL_GETCH()  _getch()
+    #define uSHELL_TERMINAL_GETCH() _getch()
     #define uSHELL_PUTCH(x) _putch(x)
 
 #else /* build environment not defined  */
@@ -49,16 +50,56 @@ extern "C" {
 /* if crosscompiled for microcontroller */
 #if defined (SERIAL_TERMINAL)
     #undef  uSHELL_PRINTF
-    #undef  uSHELL_GETCH
+    #undef  uSHELL_TERMINAL_GETCH
     #undef  uSHELL_PUTCH
     #define uSHELL_PRINTF   uart_printf
     #ifndef uSHELL_SNPRINTF
         #define uSHELL_SNPRINTF snprintf
     #endif
-    #define uSHELL_GETCH()  uart_getchar()
+    #define uSHELL_TERMINAL_GETCH() uart_getchar()
     #define uSHELL_PUTCH(x) uart_putchar(x)
 #endif /*defined (SERIAL_TERMINAL) */
 
+/* serial terminal: the output can go through a TX ring drained by DMA or the TX-empty interrupt (see ushell_core_txring.h) */
+#if (defined (SERIAL_TERMINAL) && (1 == uSHELL_SUPPORTS_TX_RING))
+    void uart_putchar       (char data);
+    #if defined(__GNUC__)
+    int  ushell_tx_printf   (const char *format, ...) __attribute__((format(printf, 1, 2)));
+    #else
+    int  ushell_tx_printf   (const char *format, ...);
+    #endif /* defined(__GNUC__) */
+    int  ushell_tx_putch    (int c);
+    #undef  uSHELL_PRINTF
+    #undef  uSHELL_PUTCH
+    #define uSHELL_PRINTF   ushell_tx_printf
+    #define uSHELL_PUTCH(x) ushell_tx_putch(x)
+#endif /* (defined (SERIAL_TERMINAL) && (1 == uSHELL_SUPPORTS_TX_RING)) */
+
+/* the input comes from the terminal or from an input ring (see ushell_core_input.h) */
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+    int  ushell_getch       (void);
+    #define uSHELL_GETCH()  ushell_getch()
+#else
+    #define uSHELL_GETCH()  uSHELL_TERMINAL_GETCH()
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+
+/* hosted builds: the output goes through the capture layer (see ushell_core_output.h) */
+#if ((1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) && !defined (SERIAL_TERMINAL))
+    #if defined(__GNUC__)
+    int  ushell_printf      (const char *format, ...) __attribute__((format(printf, 1, 2)));
+    #else
+    int  ushell_printf      (const char *format, ...);
+    #endif /* defined(__GNUC__) */
+    int  ushell_vprintf     (const char *format, va_list args);
+    int  ushell_putch       (int c);
+    #undef  uSHELL_PRINTF
+    #undef  uSHELL_VPRINTF
+    #undef  uSHELL_PUTCH
+    #define uSHELL_PRINTF   ushell_printf
+    #define uSHELL_VPRINTF  ushell_vprintf
+    #define uSHELL_PUTCH(x) ushell_putch(x)
+#endif /* ((1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) && !defined (SERIAL_TERMINAL)) */
+
 #ifdef __cplusplus
 }
 #endif
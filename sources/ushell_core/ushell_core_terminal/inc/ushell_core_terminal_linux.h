@@ -65,6 +65,11 @@ private:
     }
 
 public:
+    /* true if the input is typed by a user (not a pipe or a file) */
+    static bool isInteractive() {
+        return (1 == isatty(STDIN_FILENO));
+    }
+
     void clear() {
         uSHELL_PRINTF("\033[H\033[J");
         fflush(stdout);
@@ -4,6 +4,8 @@
 
 #include <ushell_core_printout.h>
 #include <windows.h>
+#include <io.h>
+#include <stdio.h>
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4710)
@@ -75,6 +77,11 @@ public:
 
         uSHELL_PRINTF("Terminal restored ok\n");
     }
+
+    // True if the input is typed by a user (not a pipe or a file)
+    static bool isInteractive() {
+        return (0 != _isatty(_fileno(stdin)));
+    }
 };
 
 #endif // USHELL_CORE_TERMINAL_WINDOWS_H
\ No newline at end of file
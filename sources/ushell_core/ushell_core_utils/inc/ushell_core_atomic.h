@@ -0,0 +1,15 @@
+#ifndef USHELL_CORE_ATOMIC_H
+#define USHELL_CORE_ATOMIC_H
+
+/* indexes of the lock-free rings: published with release stores, read with acquire loads */
+#if defined(_MSC_VER)
+    /* volatile has acquire/release semantics on x86/x64 (/volatile:ms) */
+    #include <type_traits>
+    #define uSHELL_LOAD_ACQUIRE(p)      (*(volatile const std::remove_reference<decltype(*(p))>::type *)(p))
+    #define uSHELL_STORE_RELEASE(p, v)  (*(volatile std::remove_reference<decltype(*(p))>::type *)(p) = (v))
+#else
+    #define uSHELL_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+    #define uSHELL_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif /* defined(_MSC_VER) */
+
+#endif /* USHELL_CORE_ATOMIC_H */
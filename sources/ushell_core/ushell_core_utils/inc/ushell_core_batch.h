@@ -0,0 +1,39 @@
+#ifndef USHELL_CORE_BATCH_H
+#define USHELL_CORE_BATCH_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+
+/** \brief lines of a script or of a pipe, read in large blocks and split in place */
+typedef struct {
+    int     iFd;
+    char   *pBuffer;
+    size_t  szSize;
+    size_t  szStart;    /* first byte not returned yet */
+    size_t  szEnd;      /* end of the data read */
+    bool    bEof;
+} lineReader_s;
+
+/** \brief read the lines of a file descriptor in blocks of szSize bytes
+ *  \return false if the buffer cannot be allocated */
+bool linereader_open(lineReader_s *psReader, int iFd, size_t szSize);
+
+/** \brief the next line, '\0' terminated in the buffer of the reader (no "\n" or "\r\n"),
+ *  valid until the next call; a line longer than the buffer is returned in pieces
+ *  \return nullptr at the end of the input */
+char *linereader_next(lineReader_s *psReader);
+
+/** \brief free the buffer, the file descriptor is not closed */
+void linereader_close(lineReader_s *psReader);
+
+/** \brief next command of a "cmd; cmd" list, split in place at the ';' which are not
+ *  inside a bordered string
+ *  \return nullptr when there are no more commands */
+char *batch_next_command(char **ppstrRest, const char cStringBorder);
+
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+
+#endif /* USHELL_CORE_BATCH_H */
@@ -0,0 +1,102 @@
+#ifndef USHELL_CORE_CANCEL_H
+#define USHELL_CORE_CANCEL_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+
+/*
+ * Cooperative cancellation: each command runs with a token of the calling thread, a long command
+ * polls ushell_should_stop() in its loop (a few loads, no clock and no lock) and returns early.
+ *
+ * - Ctrl-C fires the token of the command in the foreground: SIGINT on hosted builds (the
+ *   terminal keeps ISIG), the Ctrl-C byte given to input_ring_put() on targets (the UART RX
+ *   interrupt); with no command running Ctrl-C is what it was (it ends a hosted shell)
+ * - a timeout arms the watchdog which fires the token at its deadline: a thread on hosted
+ *   builds, ushell_watchdog_tick() called by a timer interrupt on targets
+ * - a command run by another command (Execute() from a command) has its own token, the one of
+ *   the outer command stops it as well
+ * - a thread started by a command adopts its token (ushell_cancel_current(), ushell_cancel_adopt()):
+ *   the commands run on the thread stop with the command
+ * - nothing is interrupted: a command blocked in a read or a sleep sees the token when it returns
+ */
+
+/* why a token fired: id, text */
+#define CANCEL_REASON_TABLE                               \
+    CANCEL_REASON(CANCEL_NONE,         "none")            \
+    CANCEL_REASON(CANCEL_INTERRUPT,    "interrupted")     \
+    CANCEL_REASON(CANCEL_TIMEOUT,      "timed out")       \
+    CANCEL_REASON(CANCEL_REQUEST,      "cancelled")
+
+typedef enum {
+#define CANCEL_REASON(id, name) id,
+    CANCEL_REASON_TABLE
+#undef CANCEL_REASON
+    CANCEL_REASON_LAST
+} cancelReason_e;
+
+#define CANCEL_WATCHDOG_SLOTS      (16U)    /* tokens with a timeout at the same time, the next ones run without it */
+
+typedef struct cancelToken_s {
+    uint32_t               uReason;         /* cancelReason_e, written by a signal handler, the watchdog or a thread */
+    struct cancelToken_s  *psParent;        /* token of the enclosing command, it stops this one too */
+} cancelToken_s;
+
+/** \brief a token not fired, the watchdog fires it after uTimeoutMs (0: never, see cancel_token_release()) */
+void cancel_token_init(cancelToken_s *psToken, uint32_t uTimeoutMs);
+
+/** \brief the token is not used any more: its watchdog is disarmed */
+void cancel_token_release(cancelToken_s *psToken);
+
+/** \brief ask the command of the token to stop, from any thread, a signal handler or an interrupt */
+void cancel_token_fire(cancelToken_s *psToken, cancelReason_e eReason);
+
+/** \brief why the token or one of its parents fired, CANCEL_NONE if none did */
+cancelReason_e cancel_token_reason(const cancelToken_s *psToken);
+
+/** \brief milliseconds left to the token or its parents before their timeout, 0: none */
+uint32_t cancel_token_left_ms(const cancelToken_s *psToken);
+
+/** \brief the commands of the calling thread run with psToken (bForeground: Ctrl-C fires it)
+ *  \return the previous token, given back to ushell_cancel_leave() */
+cancelToken_s *ushell_cancel_enter(cancelToken_s *psToken, bool bForeground);
+
+/** \brief back to the token before ushell_cancel_enter() */
+void ushell_cancel_leave(cancelToken_s *psToken, cancelToken_s *psPrevious);
+
+/** \brief the token of the calling thread, nullptr if none: the one to give to the threads a command starts */
+cancelToken_s *ushell_cancel_current(void);
+
+/** \brief a thread started by a command runs under psToken, the commands it runs stop with it */
+void ushell_cancel_adopt(cancelToken_s *psToken);
+
+/** \brief command: true once it has to stop (Ctrl-C, timeout, request) */
+bool ushell_should_stop(void);
+
+/** \brief command: why it has to stop, CANCEL_NONE if it goes on */
+cancelReason_e ushell_stop_reason(void);
+
+/** \brief milliseconds left to the command before its timeout, 0: none */
+uint32_t ushell_cancel_left_ms(void);
+
+/** \brief Ctrl-C: fire the token of the foreground command (async signal safe)
+ *  \return false if no command runs in the foreground */
+bool ushell_cancel_interrupt(void);
+
+/** \brief text of a reason, "unknown" if it is not one */
+const char *cancel_reason_name(cancelReason_e eReason);
+
+#if defined(SERIAL_TERMINAL)
+/** \brief target: uElapsedMs passed since the last tick (i.e. from a SysTick handler), the tokens at their deadline fire */
+void ushell_watchdog_tick(uint32_t uElapsedMs);
+#else
+/** \brief hosted: Ctrl-C (SIGINT) fires the foreground token, with no command running it keeps its default action */
+void ushell_cancel_catch_sigint(void);
+#endif /* defined(SERIAL_TERMINAL) */
+
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+#endif /* USHELL_CORE_CANCEL_H */
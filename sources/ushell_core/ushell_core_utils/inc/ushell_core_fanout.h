@@ -0,0 +1,80 @@
+#ifndef USHELL_CORE_FANOUT_H
+#define USHELL_CORE_FANOUT_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+
+/*
+ * Fan-out of one command (#p): a command line with one placeholder makes a line per value
+ *
+ *   test.itest {0..31}                  0 1 2 ... 31
+ *   test.iitest 1 {0x100..0x1F0..0x10}  0x100 0x110 ... 0x1F0 (hexadecimal bounds: hexadecimal values)
+ *   test.stest {eth0,eth1,wlan0}        the words as they are
+ *
+ * - a range counts down when its end is below its start, the step is always positive
+ * - the lines of a command marked thread safe (uSHELL_COMMAND_MT) run on a pool of threads, each
+ *   one writes into its own sink; the other commands run one line after the other
+ * - the results are given in the order of the values, whatever the order the lines ended in
+ */
+
+/* the lines may run on threads (hosted builds, the output of each one is captured) */
+#if (!defined(SERIAL_TERMINAL) && (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE))
+    #define uSHELL_FAN_OUT_THREADS
+#endif /* (!defined(SERIAL_TERMINAL) && (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)) */
+
+#define FAN_OUT_MAX_WORKERS        (64U)    /* threads of one fan-out at most */
+
+typedef struct {
+    const char *pstrTemplate;   /* the command line, not copied */
+    size_t      szPrefix;       /* length of the text before '{' */
+    const char *pstrSuffix;     /* the text after '}' */
+    const char *pstrList;       /* a list: the text after '{', nullptr: a range */
+    uint64_t    ullFirst;
+    uint64_t    ullStep;
+    bool        bDown;
+    bool        bHex;
+    size_t      szItems;
+    uint64_t    ullValues;      /* values of the placeholder, also when there are too many */
+} fanOut_s;
+
+/* why a template can not be fanned out */
+typedef enum {
+    FAN_OUT_OK,
+    FAN_OUT_INVALID,            /* no placeholder, or one not valid */
+    FAN_OUT_TOO_MANY            /* more than uSHELL_FAN_OUT_MAX_ITEMS values (ullValues) */
+} fanOutError_e;
+
+/** \brief result of one line */
+typedef struct {
+    int         iRetVal;        /* value returned by the command, 0 if it did not run */
+    int         iError;         /* uSHELL_ERR_OK, the parsing error or why it stopped */
+    uint32_t    uElapsedUs;
+} fanResult_s;
+
+/** \brief find and check the placeholder of a template
+ *  \return FAN_OUT_OK, or why the template can not be fanned out */
+fanOutError_e fan_out_parse(fanOut_s *psFanOut, const char *pstrTemplate);
+
+/** \brief the command line of the value szItem, into szSize bytes
+ *  \return false if it does not fit */
+bool fan_out_line(const fanOut_s *psFanOut, size_t szItem, char *pstrLine, size_t szSize);
+
+/** \brief microseconds of a monotonic clock (targets: uSHELL_FAN_OUT_NOW_US() if given, else 0) */
+uint64_t fan_out_now_us(void);
+
+#if defined(uSHELL_FAN_OUT_THREADS)
+/** \brief runs one item, on one of the threads */
+typedef void (*PFFANITEM)(size_t szItem, void *pvContext);
+
+/** \brief run the items 0 .. szItems - 1 on uWorkers threads, each one takes the next item left;
+ *  the call returns once all of them ended */
+void fan_out_run(size_t szItems, unsigned int uWorkers, PFFANITEM pfItem, void *pvContext);
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+
+#endif /* (1 == uSHELL_SUPPORTS_FAN_OUT) */
+
+#endif /* USHELL_CORE_FANOUT_H */
@@ -0,0 +1,30 @@
+#ifndef USHELL_CORE_FILEVIEW_H
+#define USHELL_CORE_FILEVIEW_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+
+/** \brief contents of a file (or of the standard input) used as a command argument;
+ *  the data is always followed by a '\0' so that it can be passed as a string */
+typedef struct {
+    char   *pData;
+    size_t  szLength;
+    void   *pvBase;     /* mapping or allocation released by fileview_close() */
+    size_t  szMapped;   /* size of the mapping, 0 if pvBase is an allocation */
+} fileview_t;
+
+/** \brief open a view on a file: regular files are mapped (private, copy on write, no copy),
+ *  pipes and devices are read until their end; "-" is the standard input, which must not
+ *  be the interactive terminal
+ *  \return false if the file cannot be read */
+bool fileview_open(const char *pstrPath, fileview_t *psView);
+
+/** \brief release the view */
+void fileview_close(fileview_t *psView);
+
+#endif /* (1 == uSHELL_SUPPORTS_FILE_ARGS) */
+
+#endif /* USHELL_CORE_FILEVIEW_H */
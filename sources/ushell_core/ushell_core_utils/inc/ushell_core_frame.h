@@ -0,0 +1,117 @@
+#ifndef USHELL_CORE_FRAME_H
+#define USHELL_CORE_FRAME_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_output.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+
+/*
+ * Binary requests of the machine clients, all the numbers are little endian:
+ *
+ * request  : u32 length | u16 tag | u8 selector | u8 nr args | command | args
+ *   command: FRAME_BY_INDEX  u32 index in the table of the shell
+ *            FRAME_BY_HASH   u32 frame_hash() of the name, in the table of the shell
+ *            FRAME_BY_NAME   u8 length | name '\0' (resolved like a typed command, i.e. plugin.command)
+ *            FRAME_LIST      nothing, the output lists "index hash pattern name" of the table
+ *   arg    : u8 type (the letter of the pattern) | value
+ *            l w i b o       8, 2, 4, 1, 1 bytes
+ *            f               4 bytes, IEEE 754 single precision
+ *            s r             u32 length | text '\0' (r: "-" the shell input or "<path")
+ *            x               u32 length | bytes
+ *            L I W B F       u32 count | count items of the size of their type
+ *            S               u32 count | count times (u32 length | text '\0')
+ *
+ * response : u32 length | u16 tag | i32 error | i32 result | i32 error arg | u32 elapsed us | output
+ */
+
+#define FRAME_LENGTH_SIZE          (4U)     /* the length prefix, not counted in the length */
+#define FRAME_REQUEST_HEADER_SIZE  (4U)     /* tag, selector, nr args */
+#define FRAME_RESPONSE_HEADER_SIZE (18U)    /* tag, error, result, error arg, elapsed */
+
+typedef enum {
+    FRAME_BY_INDEX = 0,
+    FRAME_BY_HASH,
+    FRAME_BY_NAME,
+    FRAME_LIST,
+    FRAME_SELECTOR_LAST
+} frameSelector_e;
+
+/** \brief request decoded in place, the arguments are read with frame_next_arg() */
+typedef struct {
+    uint16_t  uTag;         /* echoed in the response */
+    uint8_t   uSelector;
+    uint8_t   uNrArgs;
+    uint32_t  uCommand;     /* FRAME_BY_INDEX, FRAME_BY_HASH */
+    char     *pstrName;     /* FRAME_BY_NAME */
+    uint8_t  *pArgs;
+    size_t    szArgs;
+} frameRequest_s;
+
+/** \brief one argument slot, the data stays in the request */
+typedef struct {
+    char      cType;
+    uint8_t  *pData;        /* the value, the bytes/text or the first item */
+    uint32_t  uLength;      /* s r x: bytes (text: with its '\0'), arrays: items */
+} frameArg_s;
+
+/** \brief result sent back with the captured output */
+typedef struct {
+    uint16_t  uTag;
+    int32_t   iError;
+    int32_t   iRetVal;
+    int32_t   iErrorArg;
+    uint32_t  uElapsedUs;
+} frameResponse_s;
+
+/** \brief frames of a byte stream: the length prefix, then the request in a buffer kept between frames */
+typedef struct {
+    uint8_t   vLength[FRAME_LENGTH_SIZE];
+    size_t    szLengthFill;
+    uint8_t  *pFrame;
+    size_t    szSize;
+    size_t    szLength;
+    size_t    szFill;
+} frameAssembler_s;
+
+/** \brief FNV-1a hash of a command name */
+uint32_t frame_hash(const char *pstrName);
+
+/** \brief little endian values of the frames */
+uint16_t frame_get_u16(const uint8_t *pData);
+uint32_t frame_get_u32(const uint8_t *pData);
+uint64_t frame_get_u64(const uint8_t *pData);
+
+/** \brief decode the header of a request of szLength bytes (without its length prefix), the tag
+ *  is set even when the rest is malformed
+ *  \return false if the request is malformed */
+bool frame_decode_request(uint8_t *pRequest, size_t szLength, frameRequest_s *psRequest);
+
+/** \brief the next argument slot of a request, checked against the end of the request
+ *  \return false if there are no more arguments or the slot is malformed */
+bool frame_next_arg(frameRequest_s *psRequest, frameArg_s *psArg);
+
+/** \brief the next text of an S argument (checked by frame_next_arg()), moves ppData after it */
+char *frame_next_string(uint8_t **ppData);
+
+/** \brief reserve the header of a response in an arena sink, the output of the command follows it
+ *  \return the position of the response in the sink */
+size_t frame_begin_response(outputSink_s *psSink);
+
+/** \brief fill the header reserved by frame_begin_response(), the response ends at the end of the sink */
+void frame_end_response(outputSink_s *psSink, size_t szStart, const frameResponse_s *psResponse);
+
+/** \brief take bytes of a stream until a request is complete, *ppData and *pszAvail are advanced
+ *  \return 1: a request of psAssembler->szLength bytes is in psAssembler->pFrame, 0: more bytes are
+ *  needed, -1: the length is not valid (0 or above uSHELL_MAX_FRAME_LEN) or out of memory */
+int frame_feed(frameAssembler_s *psAssembler, const uint8_t **ppData, size_t *pszAvail);
+
+/** \brief free the buffer of the assembler */
+void frame_assembler_release(frameAssembler_s *psAssembler);
+
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
+#endif /* USHELL_CORE_FRAME_H */
@@ -0,0 +1,91 @@
+#ifndef USHELL_CORE_INPUT_H
+#define USHELL_CORE_INPUT_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+
+/*
+ * Single producer / single consumer ring of input bytes, wait-free on both sides: the producer
+ * (an UART RX interrupt, a network thread, a test harness) puts keystrokes or whole command lines,
+ * the shell takes them through uSHELL_GETCH() once the ring is attached with ushell_input_attach().
+ *
+ * - no lock and no allocation: the buffer is given by the caller, its size is a power of two
+ * - each side only writes its own index and keeps a copy of the other one: the consumer reloads
+ *   the index of the producer once per batch of bytes, the producer the one of the consumer only
+ *   when the ring looks full
+ * - a line is published at once with its ENTER key, the shell never sees half of it
+ * - a Ctrl-C given to input_ring_put() while a command runs stops it (see ushell_core_cancel.h),
+ *   it does not go into the ring
+ */
+
+#if !defined(SERIAL_TERMINAL)
+#define INPUT_RING_PAD_SIZE        (64U)    /* the two indexes on their own cache lines */
+#else
+#define INPUT_RING_PAD_SIZE        (1U)
+#endif /* !defined(SERIAL_TERMINAL) */
+
+typedef struct {
+    uint8_t  *pBuffer;
+    size_t    szMask;           /* size - 1 */
+    /* producer side */
+    size_t    szHead;           /* next byte to write, published to the consumer */
+    size_t    szTailCache;      /* the index of the consumer seen at the last check */
+    uint32_t  uOverruns;        /* bytes dropped by input_ring_put() on a full ring */
+    bool      bClosed;          /* no more input after the bytes in the ring */
+    uint8_t   vPadProducer[INPUT_RING_PAD_SIZE];
+    /* consumer side */
+    size_t    szTail;           /* next byte to read, published to the producer */
+    size_t    szHeadCache;      /* the bytes up to there are readable without reloading szHead */
+    uint8_t   vPadConsumer[INPUT_RING_PAD_SIZE];
+} inputRing_s;
+
+/** \brief use szSize bytes of pBuffer as ring (szSize: power of two, at least 2)
+ *  \return false if the size is not valid */
+bool input_ring_init(inputRing_s *psRing, uint8_t *pBuffer, size_t szSize);
+
+/** \brief producer: add one byte (i.e. from the UART RX interrupt)
+ *  \return false if the ring is full, the byte is dropped and counted in uOverruns */
+bool input_ring_put(inputRing_s *psRing, uint8_t uByte);
+
+/** \brief producer: add szLength bytes, all or nothing
+ *  \return false if they do not fit */
+bool input_ring_write(inputRing_s *psRing, const void *pvData, size_t szLength);
+
+/** \brief producer: add a command line followed by the ENTER key, all or nothing
+ *  \return false if it does not fit */
+bool input_ring_put_line(inputRing_s *psRing, const char *pstrLine);
+
+/** \brief producer: end of the input, the consumer gets EOF once the ring is drained */
+void input_ring_close(inputRing_s *psRing);
+
+/** \brief consumer: the next byte, without waiting
+ *  \return the byte, -1 if the ring is empty */
+int input_ring_get(inputRing_s *psRing);
+
+/** \brief consumer: up to szSize bytes, without waiting
+ *  \return the number of bytes read */
+size_t input_ring_read(inputRing_s *psRing, uint8_t *pBuffer, size_t szSize);
+
+/** \brief consumer: the next byte, waits for the producer (see uSHELL_INPUT_RING_IDLE())
+ *  \return the byte, EOF if the ring is closed and empty */
+int input_ring_wait_get(inputRing_s *psRing);
+
+/** \brief read the input of the shell from a ring instead of the terminal (nullptr: the terminal) */
+void ushell_input_attach(inputRing_s *psRing);
+
+/** \brief true if the shell input is a closed and drained ring (the interactive loop ends) */
+bool ushell_input_ended(void);
+
+/** \brief true if the shell reads from a ring */
+bool ushell_input_attached(void);
+
+/** \brief true if uSHELL_GETCH() returns without waiting: a byte is in the ring or it is closed */
+bool ushell_input_ready(void);
+
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+
+#endif /* USHELL_CORE_INPUT_H */
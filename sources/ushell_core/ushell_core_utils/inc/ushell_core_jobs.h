@@ -0,0 +1,127 @@
+#ifndef USHELL_CORE_JOBS_H
+#define USHELL_CORE_JOBS_H
+
+#include "ushell_core_settings.h"
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+#include "ushell_core_cancel.h"
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+
+/*
+ * Scheduler of the coroutine commands (see ushell_core_task.h), single threaded: it runs in the
+ * interactive loop of the shell while it waits for the next key.
+ *
+ * - a command which suspends on a timer, a file descriptor or a sub-command becomes a job, the
+ *   shell gives back the prompt and the job is resumed once its wait is over
+ * - the jobs live in a table of uSHELL_MAX_JOBS slots, nothing is allocated but the coroutine
+ *   frames (from a pool if uSHELL_TASK_FRAME_SIZE is defined)
+ * - outside of the interactive loop (batch, server, Execute()) or with the table full, the
+ *   command is driven to its end before the call returns, like a blocking one
+ * - the scheduler sleeps until the nearest timer, the readiness of the file descriptors or a key
+ *   (one poll() for all of them on hosted builds)
+ * - a job has its own cancellation token (ushell_should_stop() in the coroutine): it takes the
+ *   time left to the timeout of its command, #j<id> fires it, a job stopped is resumed at once
+ */
+
+/* the file descriptors are waited for with poll() */
+#if (!defined(SERIAL_TERMINAL) && (defined(__linux__) || defined(__APPLE__)))
+    #define uSHELL_JOBS_FD_WAITS
+#endif /* (!defined(SERIAL_TERMINAL) && (defined(__linux__) || defined(__APPLE__))) */
+
+/* waits of a job: id, name */
+#define JOB_WAIT_TABLE                                    \
+    JOB_WAIT(JOB_WAIT_NONE,    "ready")                   \
+    JOB_WAIT(JOB_WAIT_TIMER,   "timer")                   \
+    JOB_WAIT(JOB_WAIT_READ,    "read")                    \
+    JOB_WAIT(JOB_WAIT_WRITE,   "write")
+
+typedef enum {
+#define JOB_WAIT(id, name) id,
+    JOB_WAIT_TABLE
+#undef JOB_WAIT
+    JOB_WAIT_LAST
+} jobWait_e;
+
+/** \brief takes the result of an ended coroutine and destroys its frame */
+typedef int (*PFJOBEND)(void *pvFrame);
+
+typedef struct {
+    void        *pvFrame;       /* frame of the command, nullptr: free slot */
+    void        *pvResume;      /* frame waiting: the command or one of its sub-commands */
+    PFJOBEND     pfEnd;
+    const char  *pstrName;
+    uint32_t     uId;
+    jobWait_e    eWait;
+    int          iFd;           /* JOB_WAIT_READ, JOB_WAIT_WRITE */
+    uint64_t     ullDeadlineMs; /* JOB_WAIT_TIMER: the end, an fd wait: its timeout (0: none) */
+    uint32_t     uResumes;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    cancelToken_s sToken;       /* in the background: fired by its timeout or #j<id> */
+    bool         bStopSeen;     /* resumed once since the token fired, then only by its waits */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+} job_s;
+
+/** \brief a job which ended */
+typedef struct {
+    uint32_t     uId;
+    const char  *pstrName;
+    int          iResult;
+} jobEnd_s;
+
+/** \brief coroutine: the frame pvResume suspends until the wait is over (uTimeoutMs 0: none) */
+void ushell_job_wait(void *pvResume, jobWait_e eWait, int iFd, uint32_t uTimeoutMs);
+
+/** \brief coroutine: false if the last fd wait ended by its timeout */
+bool ushell_job_ready(void);
+
+/** \brief a command suspended on its first wait: make it a job, or drive it to its end
+ *  \return the id of the job (> 0), or the result of the command */
+int ushell_job_start(void *pvFrame, PFJOBEND pfEnd, const char *pstrName);
+
+/** \brief shell: the commands may go on as jobs (only while the interactive loop runs them) */
+void ushell_jobs_background(bool bAllowed);
+
+/** \brief shell: true if a job waits */
+bool ushell_jobs_pending(void);
+
+/** \brief shell: resume once each job whose wait is over
+ *  \return the number of jobs which ended, put in psEnded (room for uSHELL_MAX_JOBS), their slots are free again */
+size_t ushell_jobs_run(jobEnd_s *psEnded);
+
+/** \brief shell: sleep until a job can run or a key comes
+ *  \return true if a key is there */
+bool ushell_jobs_wait_key(void);
+
+/** \brief shell: destroy the jobs without resuming them (the shell exits) */
+void ushell_jobs_drop(void);
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/** \brief ask a job to stop, it is resumed at the next pass
+ *  \return false if there is no job uId */
+bool ushell_job_cancel(uint32_t uId);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+/** \brief the job of a slot (0 .. uSHELL_MAX_JOBS - 1), nullptr if it is free */
+const job_s *ushell_job_get(size_t szSlot);
+
+/** \brief name of a wait, "unknown" if it is not one */
+const char *job_wait_name(jobWait_e eWait);
+
+/** \brief milliseconds until the wait of a job is over, 0 if it is (or has no timer) */
+uint32_t ushell_job_remaining_ms(const job_s *psJob);
+
+#if defined(uSHELL_TASK_FRAME_SIZE)
+/** \brief frame of a coroutine from the pool, nullptr if it is exhausted or the frame is too big */
+void *ushell_task_frame_alloc(size_t szSize);
+
+/** \brief give a frame back to the pool */
+void ushell_task_frame_free(void *pvFrame);
+#endif /* defined(uSHELL_TASK_FRAME_SIZE) */
+
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
+
+#endif /* USHELL_CORE_JOBS_H */
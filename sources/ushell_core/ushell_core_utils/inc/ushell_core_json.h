@@ -0,0 +1,55 @@
+#ifndef USHELL_CORE_JSON_H
+#define USHELL_CORE_JSON_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_output.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_JSON_OUTPUT)
+
+/*
+ * One JSON line per executed command, the keys are always present and in this order:
+ *
+ * {"seq":3,"cmd":"name","args":["1","a b"],"ok":false,"ret":0,"error":"invalid_number",
+ *  "error_arg":1,"us":12,"output":"..."}
+ *
+ *   cmd, args  the command line split like the shell does (bordered strings are one argument)
+ *   ok         the error is "ok" and the returned value is not negative
+ *   error_arg  index of the argument the parsing failed on, -1: none
+ *   output     the captured output, the error text of the shell included, without the colours
+ */
+
+/** \brief a command and its result, the texts are not copied */
+typedef struct {
+    uint32_t    uSeq;           /* number of the command in its batch or session */
+    const char *pstrCommand;    /* the command line as it was run */
+    char        cStringBorder;  /* the string border of the shell */
+    int         iRetVal;
+    int         iError;         /* uSHELL_ERR_... */
+    int         iErrorArg;
+    uint32_t    uElapsedUs;
+    const char *pOutput;        /* not '\0' terminated, may be nullptr if szOutput is 0 */
+    size_t      szOutput;
+} jsonRecord_s;
+
+/** \brief name of a uSHELL_ERR_... code, "unknown" if it is not one */
+const char *json_error_kind(int iError);
+
+/** \brief append szLength bytes as a quoted JSON string: '"' and '\' escaped, the control
+ *  characters as \n \r \t or \u00XX, the other bytes unchanged (the text is taken as UTF-8) */
+bool json_write_string(outputSink_s *psSink, const char *pstrText, size_t szLength);
+
+/** \brief append the output of a command as a JSON string, like json_write_string() without
+ *  the terminal sequences (ESC [ ... colours) and the '\r' */
+bool json_write_output(outputSink_s *psSink, const char *pstrText, size_t szLength);
+
+/** \brief append the record and its '\n' to the sink: nothing is allocated, an arena sink is only
+ *  grown while the records get longer
+ *  \return false if the sink truncated the record */
+bool json_write_record(outputSink_s *psSink, const jsonRecord_s *psRecord);
+
+#endif /* (1 == uSHELL_SUPPORTS_JSON_OUTPUT) */
+
+#endif /* USHELL_CORE_JSON_H */
@@ -0,0 +1,86 @@
+#ifndef USHELL_CORE_KEYMETER_H
+#define USHELL_CORE_KEYMETER_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_input.h"
+#include "ushell_core_txring.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_KEY_METER)
+
+/*
+ * Cost of each keystroke on a serial line: the shell reads the input ring and writes the output
+ * ring, the meter charges the wire time of the baud rate to the bytes of both directions.
+ *
+ *   bytes in    the bytes of the key (3 for an escape sequence)
+ *   bytes out   the bytes the shell wrote into the output ring while processing it
+ *   cpu         CPU time of the shell thread while processing it
+ *   latency     wire time of the key + processing time + wire time of its output, on an idle line
+ *   queued      the latency with the bytes of the previous keys still in the output ring at its
+ *               end, i.e. until the last byte of the answer left the line (keys typed ahead, pasted)
+ */
+
+/* classes of keystrokes: id, name */
+#define KEY_METER_CLASS_TABLE                             \
+    KEY_METER_CLASS(KEY_CLASS_TYPING,      "typing")      \
+    KEY_METER_CLASS(KEY_CLASS_TAB,         "tab")         \
+    KEY_METER_CLASS(KEY_CLASS_HISTORY_UP,  "history-up")  \
+    KEY_METER_CLASS(KEY_CLASS_EDIT_INSERT, "edit-insert") \
+    KEY_METER_CLASS(KEY_CLASS_ENTER,       "enter")       \
+    KEY_METER_CLASS(KEY_CLASS_OTHER,       "other")
+
+typedef enum {
+#define KEY_METER_CLASS(id, name) id,
+    KEY_METER_CLASS_TABLE
+#undef KEY_METER_CLASS
+    KEY_CLASS_LAST
+} keyClass_e;
+
+/** \brief totals of one class of keystrokes */
+typedef struct {
+    uint32_t  uKeys;
+    uint64_t  ullBytesIn;
+    uint64_t  ullBytesOut;
+    uint64_t  ullCpuNs;
+    uint64_t  ullLatencyNs;     /* sum, divided by uKeys for the mean */
+    uint64_t  ullMaxLatencyNs;
+    uint64_t  ullMaxQueuedNs;
+} keyMeterStats_s;
+
+typedef struct {
+    uint64_t         ullByteNs;     /* wire time of one byte (start, 8 data and stop bits) */
+    inputRing_s     *psInput;       /* the rings the shell reads and writes */
+    txRing_s        *psOutput;
+    keyMeterStats_s  vStats[KEY_CLASS_LAST];
+    /* keystroke being processed */
+    bool             bActive;
+    keyClass_e       eClass;
+    size_t           szInputTail;   /* positions in the rings at its start */
+    size_t           szOutputHead;
+    uint64_t         ullStartNs;
+    uint64_t         ullStartCpuNs;
+} keyMeter_s;
+
+/** \brief measure the keystrokes read from psInput, their output written to psOutput at uBaud */
+void key_meter_init(keyMeter_s *psMeter, unsigned int uBaud, inputRing_s *psInput, txRing_s *psOutput);
+
+/** \brief name of a class, "unknown" if it is not one */
+const char *key_meter_class_name(keyClass_e eClass);
+
+/** \brief measure the keystrokes of the shell (nullptr: stop measuring) */
+void ushell_key_meter_attach(keyMeter_s *psMeter);
+
+/** \brief shell: the first byte of a keystroke was read, its processing starts */
+void ushell_key_meter_begin(keyClass_e eClass);
+
+/** \brief shell: the keystroke is of another class than the one given at its start (escape sequences) */
+void ushell_key_meter_class(keyClass_e eClass);
+
+/** \brief shell: the keystroke is processed */
+void ushell_key_meter_end(void);
+
+#endif /* (1 == uSHELL_SUPPORTS_KEY_METER) */
+
+#endif /* USHELL_CORE_KEYMETER_H */
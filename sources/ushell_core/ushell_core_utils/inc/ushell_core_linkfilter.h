@@ -0,0 +1,73 @@
+#ifndef USHELL_CORE_LINKFILTER_H
+#define USHELL_CORE_LINKFILTER_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_LINK_FILTER)
+
+/*
+ * Output of the shell minimised for a slow link: the escape sequences are decoded on the fly
+ * (they may be split over several writes) and only what changes the screen is sent.
+ *
+ * - colours (SGR): the attributes asked for are tracked and sent just before the next visible
+ *   character, as the shortest change from the attributes of the terminal ("\033[0m\033[96m"
+ *   without text between them is "\033[96m", a colour set twice is sent once)
+ * - cursor hide/show: the hide is held back, and the first cursor movement with it, until more
+ *   output follows; a show coming first drops the hide (the echo of a key is then one byte
+ *   instead of 13, a single movement is sent without the 12 bytes around it)
+ * - cursor movements: the shortest encoding ("\033[1C" is "\033[C", a move left by up to 3
+ *   columns is sent as backspaces)
+ * - everything else is passed as it is
+ */
+
+#define LINK_FILTER_SEQ_LEN        (32U)    /* longest escape sequence decoded, the longer ones are passed */
+#define LINK_FILTER_OUT_LEN        (128U)   /* bytes collected before they are passed on */
+
+/** \brief receives the minimised output, the text is not '\0' terminated */
+typedef void (*PFLINKOUTPUT)(const char *pstrText, size_t szLength, void *pvContext);
+
+/** \brief graphic attributes of the terminal */
+typedef struct {
+    uint16_t  uFlags;           /* bit n: SGR n is on (1 bold ... 9 crossed out) */
+    uint8_t   uFg;              /* SGR code of the foreground (30..37, 90..97), 0: default */
+    uint8_t   uBg;              /* SGR code of the background (40..47, 100..107), 0: default */
+} linkAttr_s;
+
+typedef struct {
+    PFLINKOUTPUT  pfOutput;
+    void         *pvContext;
+    /* escape sequence being received */
+    uint8_t       uState;
+    char          vSeq[LINK_FILTER_SEQ_LEN];
+    size_t        szSeq;
+    /* terminal */
+    linkAttr_s    sShown;       /* attributes the terminal has */
+    linkAttr_s    sWanted;      /* attributes the next visible character needs */
+    bool          bShownKnown;  /* false after attributes the filter does not decode */
+    bool          bWantedRaw;   /* the shell asked for them, they are sent as they came */
+    bool          bHidden;      /* the cursor is hidden on the terminal */
+    bool          bHidePending; /* hidden for the shell, not sent yet */
+    char          vHeld[LINK_FILTER_SEQ_LEN]; /* movement following the hide, not sent yet */
+    size_t        szHeld;
+    /* output */
+    char          vOut[LINK_FILTER_OUT_LEN];
+    size_t        szOut;
+    uint64_t      ullBytesIn;   /* written by the shell */
+    uint64_t      ullBytesOut;  /* passed to pfOutput */
+} linkFilter_s;
+
+/** \brief start with a terminal in its default state, the output goes to pfOutput */
+void link_filter_init(linkFilter_s *psFilter, PFLINKOUTPUT pfOutput, void *pvContext);
+
+/** \brief filter szLength bytes of the shell output, what is decided is passed on at the end */
+void link_filter_write(linkFilter_s *psFilter, const char *pstrText, size_t szLength);
+
+/** \brief end of the output: send the attributes asked for and the cursor state, then the rest */
+void link_filter_flush(linkFilter_s *psFilter);
+
+#endif /* (1 == uSHELL_SUPPORTS_LINK_FILTER) */
+
+#endif /* USHELL_CORE_LINKFILTER_H */
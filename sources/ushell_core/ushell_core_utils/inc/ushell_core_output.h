@@ -0,0 +1,58 @@
+#ifndef USHELL_CORE_OUTPUT_H
+#define USHELL_CORE_OUTPUT_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+
+/** \brief callback receiving the captured output, the text is not '\0' terminated */
+typedef void (*PFOUTPUT)(const char *pstrText, size_t szLength, void *pvContext);
+
+/** \brief destination of the output of the commands run with a sink: a fixed buffer (truncated
+ *  when full), a growable arena (heap, kept between commands) or a callback */
+typedef struct {
+    char    *pBuffer;     /* buffer and arena: the text, always '\0' terminated (arena: nullptr until used) */
+    size_t   szSize;
+    size_t   szLength;
+    bool     bGrowable;
+    bool     bTruncated;
+    PFOUTPUT pfOutput;    /* callback: used instead of the buffer */
+    void    *pvContext;
+} outputSink_s;
+
+/** \brief sink writing into a caller buffer of szSize bytes */
+outputSink_s output_sink_buffer(char *pBuffer, size_t szSize);
+
+/** \brief sink writing into a heap buffer grown as needed, freed by output_sink_release() */
+outputSink_s output_sink_arena(void);
+
+/** \brief sink passing each printed piece to a callback */
+outputSink_s output_sink_callback(PFOUTPUT pfOutput, void *pvContext);
+
+/** \brief empty the sink, the arena keeps its memory for the next command */
+void output_sink_reset(outputSink_s *psSink);
+
+/** \brief free the memory of an arena */
+void output_sink_release(outputSink_s *psSink);
+
+/** \brief print into a sink, independently of the sink of the calling thread
+ *  \return the length of the formatted text */
+#if defined(__GNUC__)
+int output_sink_printf(outputSink_s *psSink, const char *format, ...) __attribute__((format(printf, 2, 3)));
+#else
+int output_sink_printf(outputSink_s *psSink, const char *format, ...);
+#endif /* defined(__GNUC__) */
+
+/** \brief append szLength raw bytes to a sink (the bytes may hold '\0')
+ *  \return false if they were truncated */
+bool output_sink_write(outputSink_s *psSink, const void *pvData, size_t szLength);
+
+/** \brief send the output of the calling thread to a sink (nullptr: the terminal)
+ *  \return the previous sink */
+outputSink_s *output_redirect(outputSink_s *psSink);
+
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+
+#endif /* USHELL_CORE_OUTPUT_H */
@@ -0,0 +1,38 @@
+#ifndef USHELL_CORE_READER_H
+#define USHELL_CORE_READER_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#if (1 == uSHELL_SUPPORTS_READER)
+
+/** \brief input of a streaming command ('r' parameter): the command pulls the data when it
+ *  is ready for it, so a producer writing into a pipe is held back by the pipe buffer */
+struct reader_s {
+    FILE *pFile;          /* file source, nullptr: the shell input */
+    bool  bInteractive;   /* the shell input is a terminal: echo, one line per read, Ctrl-D ends */
+    bool  bEnd;
+};
+
+/** \brief read the next chunk of the command input
+ *  \param psReader the reader received by the command
+ *  \param pvBuffer destination
+ *  \param szSize size of the destination; from a terminal a read returns at the end of a line
+ *  \return number of bytes read, 0 at the end of the input, negative on error */
+int ushell_read(reader_t *psReader, void *pvBuffer, size_t szSize);
+
+/** \brief use the shell input (terminal, pipe or redirect) until its end or Ctrl-D */
+void reader_open_input(reader_t *psReader);
+
+/** \brief use a file; false if the file cannot be opened */
+bool reader_open_file(reader_t *psReader, const char *pstrPath);
+
+/** \brief release the source */
+void reader_close(reader_t *psReader);
+
+#endif /* (1 == uSHELL_SUPPORTS_READER) */
+
+#endif /* USHELL_CORE_READER_H */
@@ -0,0 +1,38 @@
+#ifndef USHELL_CORE_SERVER_H
+#define USHELL_CORE_SERVER_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_output.h"
+#include "ushell_core_frame.h"
+
+#include <stddef.h>
+
+#if (1 == uSHELL_SUPPORTS_SERVER_MODE)
+
+/** \brief run one command line of a client, its output is appended to the sink */
+typedef void (*PFSERVEREXEC)(const char *pstrCommand, outputSink_s *psSink, void *pvContext);
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+/** \brief run one binary request of a client, its response is appended to the sink */
+typedef void (*PFSERVERFRAME)(uint8_t *pRequest, size_t szLength, outputSink_s *psSink, void *pvContext);
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
+/** \brief server of the clients connected on a UNIX socket: each client has its own line and
+ *  history, all the commands run on the thread of the server (one command at a time) */
+typedef struct {
+    const char  *pstrPath;      /* path of the socket, a stale one is replaced */
+    const char  *pstrPrompt;    /* sent after each command, nullptr: none */
+    PFSERVEREXEC pfExec;
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    PFSERVERFRAME pfFrame;      /* not nullptr: the clients send binary requests instead of lines */
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+    void        *pvContext;
+} serverConfig_s;
+
+/** \brief serve the clients until SIGINT or SIGTERM, the socket is removed at the end
+ *  \return false if the socket cannot be created */
+bool server_run(const serverConfig_s *psConfig);
+
+#endif /* (1 == uSHELL_SUPPORTS_SERVER_MODE) */
+
+#endif /* USHELL_CORE_SERVER_H */
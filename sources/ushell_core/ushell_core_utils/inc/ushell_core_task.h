@@ -0,0 +1,149 @@
+#ifndef USHELL_CORE_TASK_H
+#define USHELL_CORE_TASK_H
+
+#include "ushell_core_datatypes.h"
+#include "ushell_core_jobs.h"
+
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/*
+ * Coroutine commands (C++20): a function returning uShellTask runs until its first co_await, the
+ * shell then resumes it from the interactive loop between two keys (see ushell_core_jobs.h).
+ *
+ *   uShellTask waitbit_task(num32_t addr, num32_t mask)
+ *   {
+ *       while (0U == (read_register(addr) & mask)) {
+ *           co_await ushell_sleep(10U);
+ *       }
+ *       co_return 0;
+ *   }
+ *   int waitbit(num32_t addr, num32_t mask)        // the command of the table
+ *   {
+ *       return ushell_task_start(waitbit_task(addr, mask), "waitbit");
+ *   }
+ *
+ * - co_await ushell_sleep(ms), ushell_yield(): a timer, the next pass of the scheduler
+ * - co_await ushell_readable(fd, ms), ushell_writable(fd, ms): the readiness of a file descriptor,
+ *   true if it is ready, false at the timeout (hosted builds)
+ * - co_await sub_task(...): another coroutine, its co_return value is the result
+ * - the arguments are copied into the frame, the strings of the command line are not: a coroutine
+ *   which keeps a str_t* after its first co_await copies the text first
+ */
+
+class uShellTask {
+  public:
+    struct promise_type;
+    using handle_t = std::coroutine_handle<promise_type>;
+
+    /** \brief wait of a coroutine on the scheduler */
+    struct Wait {
+        jobWait_e  eWait;
+        int        iFd;
+        uint32_t   uTimeoutMs;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> hWaiting) const noexcept { ushell_job_wait(hWaiting.address(), eWait, iFd, uTimeoutMs); }
+        bool await_resume() const noexcept { return ushell_job_ready(); }
+    };
+
+    /** \brief a sub-command awaited: it resumes the caller when it ends */
+    struct Awaiter {
+        handle_t hTask;
+
+        bool await_ready() const noexcept { return (!hTask) || hTask.done(); }
+        void await_suspend(std::coroutine_handle<> hCaller) const noexcept { hTask.promise().hCaller = hCaller; }
+        int await_resume() const noexcept { return hTask ? hTask.promise().iResult : uSHELL_ERR_NO_TASK_FRAME; }
+    };
+
+    struct promise_type {
+        int                      iResult = 0;
+        std::coroutine_handle<>  hCaller;   /* coroutine awaiting this one, none: a command */
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(handle_t hTask) const noexcept {
+                std::coroutine_handle<> hCaller = hTask.promise().hCaller;
+                return hCaller ? hCaller : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        uShellTask get_return_object() noexcept { return uShellTask(handle_t::from_promise(*this)); }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_value(int iValue) noexcept { iResult = iValue; }
+        void unhandled_exception() const noexcept {}
+
+        /* only the waits of the scheduler can be awaited, the jobs know what they wait for */
+        Wait await_transform(Wait sWait) const noexcept { return sWait; }
+        Awaiter await_transform(uShellTask &&task) const noexcept { return Awaiter{ task.m_hTask }; }
+
+#if defined(uSHELL_TASK_FRAME_SIZE)
+        static void *operator new(std::size_t szSize) noexcept { return ushell_task_frame_alloc(szSize); }
+        static void operator delete(void *pvFrame) noexcept { ushell_task_frame_free(pvFrame); }
+        static uShellTask get_return_object_on_allocation_failure() noexcept { return uShellTask(handle_t()); }
+#endif /* defined(uSHELL_TASK_FRAME_SIZE) */
+    };
+
+    uShellTask(uShellTask &&other) noexcept : m_hTask(std::exchange(other.m_hTask, handle_t())) {}
+    uShellTask(const uShellTask &) = delete;
+    uShellTask &operator=(const uShellTask &) = delete;
+    uShellTask &operator=(uShellTask &&) = delete;
+    ~uShellTask() {
+        if (m_hTask) {
+            m_hTask.destroy();
+        }
+    }
+
+    /** \brief the frame, given to the scheduler (nullptr if it was not allocated) */
+    void *release() noexcept { return std::exchange(m_hTask, handle_t()).address(); }
+
+    /** \brief the result of an ended coroutine, its frame is destroyed */
+    static int end(void *pvFrame) noexcept {
+        handle_t hTask = handle_t::from_address(pvFrame);
+        const int iResult = hTask.promise().iResult;
+        hTask.destroy();
+        return iResult;
+    }
+
+  private:
+    explicit uShellTask(handle_t hTask) noexcept : m_hTask(hTask) {}
+    handle_t m_hTask;
+};
+
+/** \brief resume after uMs milliseconds */
+inline uShellTask::Wait ushell_sleep(uint32_t uMs) { return uShellTask::Wait{ JOB_WAIT_TIMER, -1, uMs }; }
+
+/** \brief resume at the next pass of the scheduler, after the keys typed meanwhile */
+inline uShellTask::Wait ushell_yield(void) { return uShellTask::Wait{ JOB_WAIT_NONE, -1, 0U }; }
+
+#if defined(uSHELL_JOBS_FD_WAITS)
+/** \brief resume when iFd is readable (true) or after uTimeoutMs (false, 0: no timeout) */
+inline uShellTask::Wait ushell_readable(int iFd, uint32_t uTimeoutMs = 0U) { return uShellTask::Wait{ JOB_WAIT_READ, iFd, uTimeoutMs }; }
+
+/** \brief resume when iFd is writable (true) or after uTimeoutMs (false, 0: no timeout) */
+inline uShellTask::Wait ushell_writable(int iFd, uint32_t uTimeoutMs = 0U) { return uShellTask::Wait{ JOB_WAIT_WRITE, iFd, uTimeoutMs }; }
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+
+/** \brief run a coroutine command: its result if it ended without waiting, else the id of its job
+ *  (interactive loop) or its result once driven to the end (batch, server, full job table) */
+inline int ushell_task_start(uShellTask &&task, const char *pstrName)
+{
+    void *pvFrame = task.release();
+    if (nullptr == pvFrame) {
+        return uSHELL_ERR_NO_TASK_FRAME;
+    }
+    if (true == std::coroutine_handle<>::from_address(pvFrame).done()) {
+        return uShellTask::end(pvFrame);
+    }
+    return ushell_job_start(pvFrame, uShellTask::end, pstrName);
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
+
+#endif /* USHELL_CORE_TASK_H */
@@ -0,0 +1,105 @@
+#ifndef USHELL_CORE_TXRING_H
+#define USHELL_CORE_TXRING_H
+
+#include "ushell_core_settings.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (1 == uSHELL_SUPPORTS_TX_RING)
+
+/*
+ * Single producer / single consumer ring of output bytes: the shell writes, the DMA completion
+ * or the TX-empty interrupt drains; no lock and no allocation (the buffer is given by the caller).
+ *
+ * - the consumer takes linear blocks (tx_ring_peek() / tx_ring_consume()), ready for a DMA transfer
+ * - pfKick is called by the producer after each write: start the DMA or enable the TX-empty
+ *   interrupt if the transmitter is idle (it may be called while a transfer is running)
+ * - pfWatermark reports the fill level crossing the high watermark upwards (producer context)
+ *   and then the low watermark downwards (consumer context, i.e. the interrupt), alternately
+ * - the policy decides what a write does when the bytes do not fit
+ */
+
+#if !defined(SERIAL_TERMINAL)
+#define TX_RING_PAD_SIZE           (64U)    /* the two indexes on their own cache lines */
+#else
+#define TX_RING_PAD_SIZE           (1U)
+#endif /* !defined(SERIAL_TERMINAL) */
+
+typedef enum {
+    TX_RING_BLOCK = 0,      /* wait for the consumer (uSHELL_TX_RING_IDLE() between the checks) */
+    TX_RING_DROP,           /* a write which does not fit is dropped entirely */
+    TX_RING_TRUNCATE,       /* a write is cut to the room left */
+    TX_RING_POLICY_LAST
+} txRingPolicy_e;
+
+typedef enum {
+    TX_RING_HIGH_WATERMARK = 0,
+    TX_RING_LOW_WATERMARK
+} txRingEvent_e;
+
+struct txRing_s;
+
+/** \brief start the transmission if the transmitter is idle */
+typedef void (*PFTXKICK)(struct txRing_s *psRing, void *pvContext);
+
+/** \brief the fill level crossed a watermark */
+typedef void (*PFTXWATERMARK)(struct txRing_s *psRing, txRingEvent_e eEvent, void *pvContext);
+
+typedef struct txRing_s {
+    uint8_t        *pBuffer;
+    size_t          szMask;         /* size - 1 */
+    size_t          szHighWatermark;
+    size_t          szLowWatermark;
+    txRingPolicy_e  ePolicy;
+    PFTXKICK        pfKick;
+    PFTXWATERMARK   pfWatermark;
+    void           *pvContext;
+    /* producer side */
+    size_t          szHead;         /* next byte to write, published to the consumer */
+    size_t          szTailCache;    /* the index of the consumer seen at the last check */
+    uint32_t        uHighEvents;    /* high watermarks reported, one more than uLowEvents while above */
+    uint32_t        uDropped;       /* bytes lost by TX_RING_DROP and TX_RING_TRUNCATE */
+    uint32_t        uBlocked;       /* writes which waited for the consumer (TX_RING_BLOCK) */
+    uint8_t         vPadProducer[TX_RING_PAD_SIZE];
+    /* consumer side */
+    size_t          szTail;         /* next byte to send, published to the producer */
+    uint32_t        uLowEvents;     /* low watermarks reported */
+    uint8_t         vPadConsumer[TX_RING_PAD_SIZE];
+} txRing_s;
+
+/** \brief use szSize bytes of pBuffer as ring (power of two, at least 2), policy TX_RING_BLOCK,
+ *  watermarks at 3/4 and 1/4 of the size, no callbacks
+ *  \return false if the size is not valid */
+bool tx_ring_init(txRing_s *psRing, uint8_t *pBuffer, size_t szSize);
+
+/** \brief producer: write szLength bytes according to the policy
+ *  \return the number of bytes written */
+size_t tx_ring_write(txRing_s *psRing, const void *pvData, size_t szLength);
+
+/** \brief producer: bytes waiting to be sent */
+size_t tx_ring_pending(txRing_s *psRing);
+
+/** \brief producer: wait until all the bytes are sent */
+void tx_ring_flush(txRing_s *psRing);
+
+/** \brief consumer: the longest linear block to send
+ *  \return its length, 0 if the ring is empty */
+size_t tx_ring_peek(txRing_s *psRing, const uint8_t **ppData);
+
+/** \brief consumer: szLength bytes of the block returned by tx_ring_peek() are sent */
+void tx_ring_consume(txRing_s *psRing, size_t szLength);
+
+/** \brief consumer: the next byte (TX-empty interrupt)
+ *  \return the byte, -1 if the ring is empty */
+int tx_ring_getc(txRing_s *psRing);
+
+#if defined(SERIAL_TERMINAL)
+/** \brief send the output of the shell through the ring instead of uart_putchar() / uart_printf()
+ *  (nullptr: back to them) */
+void ushell_output_attach_tx(txRing_s *psRing);
+#endif /* defined(SERIAL_TERMINAL) */
+
+#endif /* (1 == uSHELL_SUPPORTS_TX_RING) */
+
+#endif /* USHELL_CORE_TXRING_H */
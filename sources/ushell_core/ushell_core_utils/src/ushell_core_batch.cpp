@@ -0,0 +1,97 @@
+#include "ushell_core_batch.h"
+
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <io.h>
+    #define BATCH_READ(fd, buf, len)  _read((fd), (buf), (unsigned int)(len))
+#else
+    #include <unistd.h>
+    #define BATCH_READ(fd, buf, len)  read((fd), (buf), (len))
+#endif
+
+#define BATCH_COMMAND_SEPARATOR    ';'
+
+/*----------------------------------------------------------------------------*/
+bool linereader_open(lineReader_s *psReader, int iFd, size_t szSize) {
+    psReader->iFd = iFd;
+    psReader->pBuffer = (char *)malloc(szSize + 1U); /* room for the '\0' of a last line without '\n' */
+    psReader->szSize = szSize;
+    psReader->szStart = 0;
+    psReader->szEnd = 0;
+    psReader->bEof = false;
+    return (nullptr != psReader->pBuffer);
+}
+
+/*----------------------------------------------------------------------------*/
+char *linereader_next(lineReader_s *psReader) {
+    for (;;) {
+        char *pstrLine = psReader->pBuffer + psReader->szStart;
+        char *pEol = (char *)memchr(pstrLine, '\n', psReader->szEnd - psReader->szStart);
+
+        if ((nullptr == pEol) && (true == psReader->bEof) && (psReader->szStart < psReader->szEnd)) {
+            pEol = psReader->pBuffer + psReader->szEnd; /* last line without '\n' */
+        }
+        if ((nullptr == pEol) && (0U == psReader->szStart) && (psReader->szEnd == psReader->szSize)) {
+            pEol = psReader->pBuffer + psReader->szEnd; /* longer than the buffer */
+        }
+        if (nullptr != pEol) {
+            psReader->szStart = (size_t)(pEol - psReader->pBuffer) + ((pEol < psReader->pBuffer + psReader->szEnd) ? 1U : 0U);
+            if ((pEol > pstrLine) && ('\r' == pEol[-1])) {
+                --pEol;
+            }
+            *pEol = '\0';
+            return pstrLine;
+        }
+        if (true == psReader->bEof) {
+            return nullptr;
+        }
+
+        /* keep the incomplete line and fill the rest of the buffer */
+        memmove(psReader->pBuffer, pstrLine, psReader->szEnd - psReader->szStart);
+        psReader->szEnd -= psReader->szStart;
+        psReader->szStart = 0;
+        long lRead = (long)BATCH_READ(psReader->iFd, psReader->pBuffer + psReader->szEnd, psReader->szSize - psReader->szEnd);
+        if (lRead <= 0) {
+            psReader->bEof = true;
+        } else {
+            psReader->szEnd += (size_t)lRead;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+void linereader_close(lineReader_s *psReader) {
+    free(psReader->pBuffer);
+    psReader->pBuffer = nullptr;
+}
+
+/*----------------------------------------------------------------------------*/
+char *batch_next_command(char **ppstrRest, const char cStringBorder) {
+    char *pstrCommand = *ppstrRest;
+    if (nullptr == pstrCommand) {
+        return nullptr;
+    }
+
+    bool bInString = false;
+    char *pstrPos = pstrCommand;
+    for (; '\0' != *pstrPos; ++pstrPos) {
+        if (cStringBorder == *pstrPos) {
+            bInString = !bInString;
+        } else if ((BATCH_COMMAND_SEPARATOR == *pstrPos) && (false == bInString)) {
+            break;
+        }
+    }
+    if ('\0' != *pstrPos) {
+        *pstrPos = '\0';
+        *ppstrRest = pstrPos + 1;
+    } else {
+        *ppstrRest = nullptr;
+    }
+    return pstrCommand;
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
@@ -0,0 +1,294 @@
+#include "ushell_core_cancel.h"
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+
+#include "ushell_core_atomic.h"
+
+#include <signal.h>
+#include <string.h>
+
+#if !defined(SERIAL_TERMINAL)
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+    #if !(defined(__MINGW32__) || defined(_MSC_VER))
+        #include <pthread.h>
+    #endif /* !(defined(__MINGW32__) || defined(_MSC_VER)) */
+    #define CANCEL_NOW_MS()            ((uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#endif /* !defined(SERIAL_TERMINAL) */
+
+/* a token armed with its timeout */
+typedef struct {
+    cancelToken_s *psToken;         /* nullptr: free slot */
+#if defined(SERIAL_TERMINAL)
+    uint32_t       uLeftMs;         /* counted down by the ticks */
+#else
+    uint64_t       ullDeadlineMs;
+#endif /* defined(SERIAL_TERMINAL) */
+} watchdogSlot_s;
+
+/* token of the commands of the calling thread, and the one Ctrl-C fires */
+static thread_local cancelToken_s *g_psToken = nullptr;
+static cancelToken_s *g_psForeground = nullptr;
+
+/* the watchdog: a thread on hosted builds (the objects are never destroyed, it may wait at exit),
+ * the tick interrupt on targets (it runs to its end between two statements of the shell) */
+static watchdogSlot_s g_vsWatchdog[CANCEL_WATCHDOG_SLOTS];
+#if !defined(SERIAL_TERMINAL)
+static std::mutex              *g_pWatchdogLock = new std::mutex();
+static std::condition_variable *g_pWatchdogWake = new std::condition_variable();
+static bool                     g_bWatchdogStarted = false;
+#endif /* !defined(SERIAL_TERMINAL) */
+
+#if !defined(SERIAL_TERMINAL)
+/*----------------------------------------------------------------------------*/
+/* fire the tokens at their deadline, sleep until the nearest one */
+static void watchdog_main(void) {
+    std::unique_lock<std::mutex> lock(*g_pWatchdogLock);
+    for (;;) {
+        const uint64_t ullNowMs = CANCEL_NOW_MS();
+        uint64_t ullNextMs = 0U;
+        for (size_t i = 0U; i < CANCEL_WATCHDOG_SLOTS; ++i) {
+            watchdogSlot_s *psSlot = &g_vsWatchdog[i];
+            if (nullptr == psSlot->psToken) {
+                continue;
+            }
+            if (psSlot->ullDeadlineMs <= ullNowMs) {
+                cancel_token_fire(psSlot->psToken, CANCEL_TIMEOUT);
+                psSlot->psToken = nullptr;
+            } else if ((0U == ullNextMs) || (psSlot->ullDeadlineMs < ullNextMs)) {
+                ullNextMs = psSlot->ullDeadlineMs;
+            }
+        }
+        if (0U == ullNextMs) {
+            g_pWatchdogWake->wait(lock);
+        } else {
+            g_pWatchdogWake->wait_for(lock, std::chrono::milliseconds(ullNextMs - ullNowMs));
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* the thread does not take the signals, Ctrl-C goes to the shell */
+static void watchdog_start(void) {
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+    sigset_t sBlocked;
+    sigset_t sPrevious;
+    sigemptyset(&sBlocked);
+    sigaddset(&sBlocked, SIGINT);
+    sigaddset(&sBlocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sBlocked, &sPrevious);
+    std::thread(watchdog_main).detach();
+    pthread_sigmask(SIG_SETMASK, &sPrevious, nullptr);
+#else
+    std::thread(watchdog_main).detach();
+#endif /* !(defined(__MINGW32__) || defined(_MSC_VER)) */
+}
+#endif /* !defined(SERIAL_TERMINAL) */
+
+/*----------------------------------------------------------------------------*/
+/* the slot of a token, nullptr if it has none */
+static watchdogSlot_s *watchdog_find(const cancelToken_s *psToken) {
+    for (size_t i = 0U; i < CANCEL_WATCHDOG_SLOTS; ++i) {
+        if (psToken == g_vsWatchdog[i].psToken) {
+            return &g_vsWatchdog[i];
+        }
+    }
+    return nullptr;
+}
+
+/*----------------------------------------------------------------------------*/
+static void watchdog_arm(cancelToken_s *psToken, uint32_t uTimeoutMs) {
+#if defined(SERIAL_TERMINAL)
+    watchdogSlot_s *psSlot = watchdog_find(nullptr);
+    if (nullptr != psSlot) {
+        psSlot->uLeftMs = uTimeoutMs;
+        uSHELL_STORE_RELEASE(&psSlot->psToken, psToken);
+    }
+#else
+    std::lock_guard<std::mutex> lock(*g_pWatchdogLock);
+    watchdogSlot_s *psSlot = watchdog_find(nullptr);
+    if (nullptr != psSlot) {
+        psSlot->psToken = psToken;
+        psSlot->ullDeadlineMs = CANCEL_NOW_MS() + uTimeoutMs;
+        if (false == g_bWatchdogStarted) {
+            g_bWatchdogStarted = true;
+            watchdog_start();
+        }
+        g_pWatchdogWake->notify_one();
+    }
+#endif /* defined(SERIAL_TERMINAL) */
+}
+
+/*----------------------------------------------------------------------------*/
+void cancel_token_init(cancelToken_s *psToken, uint32_t uTimeoutMs) {
+    memset(psToken, 0, sizeof(*psToken));
+    if (0U != uTimeoutMs) {
+        watchdog_arm(psToken, uTimeoutMs);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+void cancel_token_release(cancelToken_s *psToken) {
+#if defined(SERIAL_TERMINAL)
+    watchdogSlot_s *psSlot = watchdog_find(psToken);
+    if (nullptr != psSlot) {
+        uSHELL_STORE_RELEASE(&psSlot->psToken, (cancelToken_s *)nullptr);
+    }
+#else
+    std::lock_guard<std::mutex> lock(*g_pWatchdogLock);
+    watchdogSlot_s *psSlot = watchdog_find(psToken);
+    if (nullptr != psSlot) {
+        psSlot->psToken = nullptr;
+    }
+#endif /* defined(SERIAL_TERMINAL) */
+}
+
+/*----------------------------------------------------------------------------*/
+void cancel_token_fire(cancelToken_s *psToken, cancelReason_e eReason) {
+    if ((uint32_t)CANCEL_NONE == uSHELL_LOAD_ACQUIRE(&psToken->uReason)) {
+        uSHELL_STORE_RELEASE(&psToken->uReason, (uint32_t)eReason);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+cancelReason_e cancel_token_reason(const cancelToken_s *psToken) {
+    for (; nullptr != psToken; psToken = psToken->psParent) {
+        const uint32_t uReason = uSHELL_LOAD_ACQUIRE(&psToken->uReason);
+        if ((uint32_t)CANCEL_NONE != uReason) {
+            return (cancelReason_e)uReason;
+        }
+    }
+    return CANCEL_NONE;
+}
+
+/*----------------------------------------------------------------------------*/
+cancelToken_s *ushell_cancel_enter(cancelToken_s *psToken, bool bForeground) {
+    cancelToken_s *psPrevious = g_psToken;
+    psToken->psParent = psPrevious;
+    g_psToken = psToken;
+    if ((true == bForeground) && (nullptr == uSHELL_LOAD_ACQUIRE(&g_psForeground))) {
+        uSHELL_STORE_RELEASE(&g_psForeground, psToken);
+    }
+    return psPrevious;
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_cancel_leave(cancelToken_s *psToken, cancelToken_s *psPrevious) {
+    if (psToken == uSHELL_LOAD_ACQUIRE(&g_psForeground)) {
+        uSHELL_STORE_RELEASE(&g_psForeground, (cancelToken_s *)nullptr);
+    }
+    g_psToken = psPrevious;
+}
+
+/*----------------------------------------------------------------------------*/
+cancelToken_s *ushell_cancel_current(void) {
+    return g_psToken;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the token is not written: several threads may adopt it */
+void ushell_cancel_adopt(cancelToken_s *psToken) {
+    g_psToken = psToken;
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_should_stop(void) {
+    return (CANCEL_NONE != cancel_token_reason(g_psToken));
+}
+
+/*----------------------------------------------------------------------------*/
+cancelReason_e ushell_stop_reason(void) {
+    return cancel_token_reason(g_psToken);
+}
+
+/*----------------------------------------------------------------------------*/
+uint32_t cancel_token_left_ms(const cancelToken_s *psToken) {
+#if !defined(SERIAL_TERMINAL)
+    std::lock_guard<std::mutex> lock(*g_pWatchdogLock);
+#endif /* !defined(SERIAL_TERMINAL) */
+    for (; nullptr != psToken; psToken = psToken->psParent) {
+        const watchdogSlot_s *psSlot = watchdog_find(psToken);
+        if (nullptr != psSlot) {
+#if defined(SERIAL_TERMINAL)
+            return (0U != psSlot->uLeftMs) ? psSlot->uLeftMs : 1U;
+#else
+            const uint64_t ullNowMs = CANCEL_NOW_MS();
+            return (psSlot->ullDeadlineMs > ullNowMs) ? (uint32_t)(psSlot->ullDeadlineMs - ullNowMs) : 1U;
+#endif /* defined(SERIAL_TERMINAL) */
+        }
+    }
+    return 0U;
+}
+
+/*----------------------------------------------------------------------------*/
+uint32_t ushell_cancel_left_ms(void) {
+    return cancel_token_left_ms(g_psToken);
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_cancel_interrupt(void) {
+    cancelToken_s *psToken = uSHELL_LOAD_ACQUIRE(&g_psForeground);
+    if (nullptr == psToken) {
+        return false;
+    }
+    cancel_token_fire(psToken, CANCEL_INTERRUPT);
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+const char *cancel_reason_name(cancelReason_e eReason) {
+    switch (eReason) {
+#define CANCEL_REASON(id, name) case id: return name;
+        CANCEL_REASON_TABLE
+#undef CANCEL_REASON
+        default: return "unknown";
+    }
+}
+
+#if defined(SERIAL_TERMINAL)
+/*----------------------------------------------------------------------------*/
+void ushell_watchdog_tick(uint32_t uElapsedMs) {
+    for (size_t i = 0U; i < CANCEL_WATCHDOG_SLOTS; ++i) {
+        watchdogSlot_s *psSlot = &g_vsWatchdog[i];
+        cancelToken_s *psToken = uSHELL_LOAD_ACQUIRE(&psSlot->psToken);
+        if (nullptr == psToken) {
+            continue;
+        }
+        if (psSlot->uLeftMs <= uElapsedMs) {
+            cancel_token_fire(psToken, CANCEL_TIMEOUT);
+            uSHELL_STORE_RELEASE(&psSlot->psToken, (cancelToken_s *)nullptr);
+        } else {
+            psSlot->uLeftMs -= uElapsedMs;
+        }
+    }
+}
+#else
+/*----------------------------------------------------------------------------*/
+/* no command in the foreground: the default action, as if the handler was not there */
+static void cancel_on_sigint(int iSignal) {
+    if (false == ushell_cancel_interrupt()) {
+        signal(iSignal, SIG_DFL);
+        raise(iSignal);
+    }
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+    signal(iSignal, cancel_on_sigint); /* reset to the default before each call */
+#endif /* (defined(__MINGW32__) || defined(_MSC_VER)) */
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_cancel_catch_sigint(void) {
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+    signal(SIGINT, cancel_on_sigint);
+#else
+    struct sigaction sAction = {};
+    sAction.sa_handler = cancel_on_sigint;
+    sAction.sa_flags = SA_RESTART;
+    sigemptyset(&sAction.sa_mask);
+    sigaction(SIGINT, &sAction, nullptr);
+#endif /* (defined(__MINGW32__) || defined(_MSC_VER)) */
+}
+#endif /* defined(SERIAL_TERMINAL) */
+
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
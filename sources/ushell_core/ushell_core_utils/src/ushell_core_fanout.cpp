@@ -0,0 +1,209 @@
+#include "ushell_core_fanout.h"
+
+#if (1 == uSHELL_SUPPORTS_FAN_OUT)
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(SERIAL_TERMINAL)
+    #include <chrono>
+#endif /* !defined(SERIAL_TERMINAL) */
+
+#if defined(uSHELL_FAN_OUT_THREADS)
+    #include <atomic>
+    #include <thread>
+    #if !(defined(__MINGW32__) || defined(_MSC_VER))
+        #include <pthread.h>
+        #include <signal.h>
+    #endif /* !(defined(__MINGW32__) || defined(_MSC_VER)) */
+
+/* items shared by the threads of a fan-out */
+typedef struct {
+    std::atomic<size_t> aNext;
+    size_t              szItems;
+    PFFANITEM           pfItem;
+    void               *pvContext;
+} fanPool_s;
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+
+/*----------------------------------------------------------------------------*/
+/* a decimal or a 0x hexadecimal number from pstrText up to pstrEnd */
+static bool fan_out_number(const char *pstrText, const char *pstrEnd, uint64_t *pullValue, bool *pbHex) {
+    uint64_t ullValue = 0U;
+    uint64_t ullBase = 10U;
+
+    if (((pstrEnd - pstrText) > 2) && ('0' == pstrText[0]) && ('x' == tolower((unsigned char)pstrText[1]))) {
+        ullBase = 16U;
+        pstrText += 2;
+    }
+    if (pstrText == pstrEnd) {
+        return false;
+    }
+    for (; pstrText < pstrEnd; ++pstrText) {
+        const int iChar = tolower((unsigned char)*pstrText);
+        uint64_t ullDigit = 0U;
+        if ((iChar >= '0') && (iChar <= '9')) {
+            ullDigit = (uint64_t)(iChar - '0');
+        } else if ((16U == ullBase) && (iChar >= 'a') && (iChar <= 'f')) {
+            ullDigit = (uint64_t)(iChar - 'a' + 10);
+        } else {
+            return false;
+        }
+        if (ullValue > ((UINT64_MAX - ullDigit) / ullBase)) {
+            return false;
+        }
+        ullValue = (ullValue * ullBase) + ullDigit;
+    }
+    *pullValue = ullValue;
+    if (nullptr != pbHex) {
+        *pbHex = (16U == ullBase);
+    }
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+/* {first..last} or {first..last..step} */
+static fanOutError_e fan_out_range(fanOut_s *psFanOut, const char *pstrBody, const char *pstrClose) {
+    const char *pstrDots = strstr(pstrBody, "..");
+    if ((nullptr == pstrDots) || (pstrDots > pstrClose)) {
+        return FAN_OUT_INVALID;
+    }
+    const char *pstrLast = pstrDots + 2;
+    const char *pstrLastEnd = strstr(pstrLast, "..");
+    uint64_t ullLast = 0U;
+    psFanOut->ullStep = 1U;
+    if ((nullptr != pstrLastEnd) && (pstrLastEnd < pstrClose)) {
+        if ((false == fan_out_number(pstrLastEnd + 2, pstrClose, &psFanOut->ullStep, nullptr)) || (0U == psFanOut->ullStep)) {
+            return FAN_OUT_INVALID;
+        }
+    } else {
+        pstrLastEnd = pstrClose;
+    }
+    if ((false == fan_out_number(pstrBody, pstrDots, &psFanOut->ullFirst, &psFanOut->bHex)) ||
+        (false == fan_out_number(pstrLast, pstrLastEnd, &ullLast, nullptr))) {
+        return FAN_OUT_INVALID;
+    }
+    psFanOut->bDown = (ullLast < psFanOut->ullFirst);
+    const uint64_t ullSpan = (true == psFanOut->bDown) ? (psFanOut->ullFirst - ullLast) : (ullLast - psFanOut->ullFirst);
+    const uint64_t ullSteps = ullSpan / psFanOut->ullStep;
+    psFanOut->ullValues = (UINT64_MAX == ullSteps) ? UINT64_MAX : (ullSteps + 1U);
+    if (ullSteps >= (uint64_t)uSHELL_FAN_OUT_MAX_ITEMS) {
+        return FAN_OUT_TOO_MANY;
+    }
+    psFanOut->szItems = (size_t)psFanOut->ullValues;
+    return FAN_OUT_OK;
+}
+
+/*----------------------------------------------------------------------------*/
+/* {word,word,...}: no empty word */
+static fanOutError_e fan_out_list(fanOut_s *psFanOut, const char *pstrBody, const char *pstrClose) {
+    size_t szItems = 1U;
+    const char *pstrWord = pstrBody;
+    for (const char *pstrText = pstrBody; pstrText <= pstrClose; ++pstrText) {
+        if ((',' == *pstrText) || (pstrText == pstrClose)) {
+            if (pstrText == pstrWord) {
+                return FAN_OUT_INVALID;
+            }
+            pstrWord = pstrText + 1;
+            szItems += (',' == *pstrText) ? 1U : 0U;
+        }
+    }
+    psFanOut->ullValues = szItems;
+    if (szItems > uSHELL_FAN_OUT_MAX_ITEMS) {
+        return FAN_OUT_TOO_MANY;
+    }
+    psFanOut->pstrList = pstrBody;
+    psFanOut->szItems = szItems;
+    return FAN_OUT_OK;
+}
+
+/*----------------------------------------------------------------------------*/
+fanOutError_e fan_out_parse(fanOut_s *psFanOut, const char *pstrTemplate) {
+    memset(psFanOut, 0, sizeof(*psFanOut));
+    const char *pstrOpen = strchr(pstrTemplate, '{');
+    const char *pstrClose = (nullptr != pstrOpen) ? strchr(pstrOpen, '}') : nullptr;
+    if (nullptr == pstrClose) {
+        return FAN_OUT_INVALID;
+    }
+    psFanOut->pstrTemplate = pstrTemplate;
+    psFanOut->szPrefix = (size_t)(pstrOpen - pstrTemplate);
+    psFanOut->pstrSuffix = pstrClose + 1;
+    const char *pstrComma = (const char *)memchr(pstrOpen, ',', (size_t)(pstrClose - pstrOpen));
+    return (nullptr != pstrComma) ? fan_out_list(psFanOut, pstrOpen + 1, pstrClose) : fan_out_range(psFanOut, pstrOpen + 1, pstrClose);
+}
+
+/*----------------------------------------------------------------------------*/
+bool fan_out_line(const fanOut_s *psFanOut, size_t szItem, char *pstrLine, size_t szSize) {
+    int iLength = 0;
+    if (nullptr != psFanOut->pstrList) {
+        const char *pstrWord = psFanOut->pstrList;
+        for (; 0U != szItem; --szItem) {
+            pstrWord = strchr(pstrWord, ',') + 1;
+        }
+        const size_t szWord = strcspn(pstrWord, ",}");
+        iLength = snprintf(pstrLine, szSize, "%.*s%.*s%s", (int)psFanOut->szPrefix, psFanOut->pstrTemplate, (int)szWord, pstrWord, psFanOut->pstrSuffix);
+    } else {
+        const uint64_t ullOffset = (uint64_t)szItem * psFanOut->ullStep;
+        const unsigned long long ullValue = (true == psFanOut->bDown) ? (psFanOut->ullFirst - ullOffset) : (psFanOut->ullFirst + ullOffset);
+        iLength = snprintf(pstrLine, szSize, (true == psFanOut->bHex) ? "%.*s0x%llX%s" : "%.*s%llu%s", (int)psFanOut->szPrefix, psFanOut->pstrTemplate, ullValue, psFanOut->pstrSuffix);
+    }
+    return (iLength >= 0) && ((size_t)iLength < szSize);
+}
+
+/*----------------------------------------------------------------------------*/
+uint64_t fan_out_now_us(void) {
+#if !defined(SERIAL_TERMINAL)
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#elif defined(uSHELL_FAN_OUT_NOW_US)
+    return (uint64_t)uSHELL_FAN_OUT_NOW_US();
+#else
+    return 0U;
+#endif /* !defined(SERIAL_TERMINAL) */
+}
+
+#if defined(uSHELL_FAN_OUT_THREADS)
+/*----------------------------------------------------------------------------*/
+static void fan_out_worker(fanPool_s *psPool) {
+    for (size_t szItem = psPool->aNext.fetch_add(1U); szItem < psPool->szItems; szItem = psPool->aNext.fetch_add(1U)) {
+        psPool->pfItem(szItem, psPool->pvContext);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* the threads do not take the signals, Ctrl-C goes to the shell */
+void fan_out_run(size_t szItems, unsigned int uWorkers, PFFANITEM pfItem, void *pvContext) {
+    fanPool_s sPool;
+    sPool.aNext = 0U;
+    sPool.szItems = szItems;
+    sPool.pfItem = pfItem;
+    sPool.pvContext = pvContext;
+
+    size_t szThreads = (uWorkers < FAN_OUT_MAX_WORKERS) ? (size_t)uWorkers : (size_t)FAN_OUT_MAX_WORKERS;
+    szThreads = (szThreads < szItems) ? szThreads : szItems;
+    if (szThreads <= 1U) {
+        fan_out_worker(&sPool);
+        return;
+    }
+    std::thread vThreads[FAN_OUT_MAX_WORKERS];
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+    sigset_t sBlocked;
+    sigset_t sPrevious;
+    sigemptyset(&sBlocked);
+    sigaddset(&sBlocked, SIGINT);
+    sigaddset(&sBlocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sBlocked, &sPrevious);
+#endif /* !(defined(__MINGW32__) || defined(_MSC_VER)) */
+    for (size_t i = 0U; i < szThreads; ++i) {
+        vThreads[i] = std::thread(fan_out_worker, &sPool);
+    }
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+    pthread_sigmask(SIG_SETMASK, &sPrevious, nullptr);
+#endif /* !(defined(__MINGW32__) || defined(_MSC_VER)) */
+    for (size_t i = 0U; i < szThreads; ++i) {
+        vThreads[i].join();
+    }
+}
+#endif /* defined(uSHELL_FAN_OUT_THREADS) */
+
+#endif /* (1 == uSHELL_SUPPORTS_FAN_OUT) */
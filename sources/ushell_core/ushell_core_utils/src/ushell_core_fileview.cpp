@@ -0,0 +1,166 @@
+#include "ushell_core_fileview.h"
+
+#if (1 == uSHELL_SUPPORTS_FILE_ARGS)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#define FILEVIEW_STDIN          "-"
+#define FILEVIEW_READ_CHUNK     (64U * 1024U)
+
+static char g_cEmpty = '\0';
+
+/*----------------------------------------------------------------------------*/
+static void fileview_reset(fileview_t *psView) {
+    psView->pData = &g_cEmpty;
+    psView->szLength = 0;
+    psView->pvBase = nullptr;
+    psView->szMapped = 0;
+}
+
+#if !defined(_WIN32)
+/*----------------------------------------------------------------------------*/
+/* map the file followed by at least one zero byte: the tail of the last page of a file
+   mapping reads as zeros, an anonymous page is reserved for when the size is a page multiple */
+static bool fileview_map(int fd, size_t szLength, fileview_t *psView) {
+    const size_t szPage = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t szMapped = ((szLength / szPage) + 1U) * szPage;
+
+    void *pvBase = mmap(nullptr, szMapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == pvBase) {
+        return false;
+    }
+    if (MAP_FAILED == mmap(pvBase, szLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0)) {
+        munmap(pvBase, szMapped);
+        return false;
+    }
+
+    psView->pData = (char *)pvBase;
+    psView->szLength = szLength;
+    psView->pvBase = pvBase;
+    psView->szMapped = szMapped;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+static bool fileview_read(int fd, fileview_t *psView) {
+    size_t szCapacity = 0, szLength = 0;
+    char *pBuffer = nullptr;
+
+    for (;;) {
+        if ((szCapacity - szLength) < (FILEVIEW_READ_CHUNK + 1U)) {
+            szCapacity = (0U == szCapacity) ? (FILEVIEW_READ_CHUNK + 1U) : (2U * szCapacity);
+            char *pNewBuffer = (char *)realloc(pBuffer, szCapacity);
+            if (nullptr == pNewBuffer) {
+                free(pBuffer);
+                return false;
+            }
+            pBuffer = pNewBuffer;
+        }
+        ssize_t iRead = read(fd, pBuffer + szLength, FILEVIEW_READ_CHUNK);
+        if (iRead < 0) {
+            free(pBuffer);
+            return false;
+        }
+        if (0 == iRead) {
+            break;
+        }
+        szLength += (size_t)iRead;
+    }
+
+    pBuffer[szLength] = '\0';
+    psView->pData = pBuffer;
+    psView->szLength = szLength;
+    psView->pvBase = pBuffer;
+    psView->szMapped = 0;
+    return true;
+}
+#endif /* !defined(_WIN32) */
+
+/*----------------------------------------------------------------------------*/
+bool fileview_open(const char *pstrPath, fileview_t *psView) {
+    bool bRetVal = false;
+    fileview_reset(psView);
+
+#if !defined(_WIN32)
+    const bool bStdin = (0 == strcmp(pstrPath, FILEVIEW_STDIN));
+    if (bStdin && isatty(STDIN_FILENO)) {
+        return false; /* the terminal is the shell input */
+    }
+
+    int fd = bStdin ? STDIN_FILENO : open(pstrPath, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat sStat;
+    if (0 == fstat(fd, &sStat)) {
+        if (S_ISREG(sStat.st_mode)) {
+            bRetVal = (0 == sStat.st_size) || fileview_map(fd, (size_t)sStat.st_size, psView);
+        } else if (!S_ISDIR(sStat.st_mode)) {
+            bRetVal = fileview_read(fd, psView);
+        }
+    }
+
+    if (!bStdin) {
+        close(fd);
+    }
+#else
+    FILE *pFile = (0 == strcmp(pstrPath, FILEVIEW_STDIN)) ? stdin : fopen(pstrPath, "rb");
+    if (nullptr != pFile) {
+        size_t szCapacity = 0, szLength = 0, szRead = 0;
+        char *pBuffer = nullptr;
+        do {
+            if ((szCapacity - szLength) < (FILEVIEW_READ_CHUNK + 1U)) {
+                szCapacity = (0U == szCapacity) ? (FILEVIEW_READ_CHUNK + 1U) : (2U * szCapacity);
+                char *pNewBuffer = (char *)realloc(pBuffer, szCapacity);
+                if (nullptr == pNewBuffer) {
+                    break;
+                }
+                pBuffer = pNewBuffer;
+            }
+            szRead = fread(pBuffer + szLength, 1, FILEVIEW_READ_CHUNK, pFile);
+            szLength += szRead;
+        } while (FILEVIEW_READ_CHUNK == szRead);
+
+        if ((nullptr != pBuffer) && !ferror(pFile) && ((szCapacity - szLength) > 0U)) {
+            pBuffer[szLength] = '\0';
+            psView->pData = pBuffer;
+            psView->szLength = szLength;
+            psView->pvBase = pBuffer;
+            bRetVal = true;
+        } else {
+            free(pBuffer);
+        }
+        if (stdin != pFile) {
+            fclose(pFile);
+        }
+    }
+#endif /* !defined(_WIN32) */
+
+    return bRetVal;
+}
+
+/*----------------------------------------------------------------------------*/
+void fileview_close(fileview_t *psView) {
+#if !defined(_WIN32)
+    if (0U != psView->szMapped) {
+        munmap(psView->pvBase, psView->szMapped);
+    } else {
+        free(psView->pvBase);
+    }
+#else
+    free(psView->pvBase);
+#endif /* !defined(_WIN32) */
+    fileview_reset(psView);
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_FILE_ARGS) */
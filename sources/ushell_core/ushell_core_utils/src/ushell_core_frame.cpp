@@ -0,0 +1,251 @@
+#include "ushell_core_frame.h"
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_FNV_OFFSET_BASIS     (2166136261U)
+#define FRAME_FNV_PRIME            (16777619U)
+
+/*----------------------------------------------------------------------------*/
+uint32_t frame_hash(const char *pstrName) {
+    uint32_t uHash = FRAME_FNV_OFFSET_BASIS;
+    while ('\0' != *pstrName) {
+        uHash = (uHash ^ (uint8_t)*pstrName++) * FRAME_FNV_PRIME;
+    }
+    return uHash;
+}
+
+/*----------------------------------------------------------------------------*/
+uint16_t frame_get_u16(const uint8_t *pData) {
+    return (uint16_t)(pData[0] | (pData[1] << 8));
+}
+
+/*----------------------------------------------------------------------------*/
+uint32_t frame_get_u32(const uint8_t *pData) {
+    return (uint32_t)pData[0] | ((uint32_t)pData[1] << 8) | ((uint32_t)pData[2] << 16) | ((uint32_t)pData[3] << 24);
+}
+
+/*----------------------------------------------------------------------------*/
+uint64_t frame_get_u64(const uint8_t *pData) {
+    return (uint64_t)frame_get_u32(pData) | ((uint64_t)frame_get_u32(pData + 4) << 32);
+}
+
+/*----------------------------------------------------------------------------*/
+static void frame_put_u32(uint8_t *pData, uint32_t uValue) {
+    pData[0] = (uint8_t)uValue;
+    pData[1] = (uint8_t)(uValue >> 8);
+    pData[2] = (uint8_t)(uValue >> 16);
+    pData[3] = (uint8_t)(uValue >> 24);
+}
+
+/*----------------------------------------------------------------------------*/
+/* a text: u32 length | text '\0', the length counts the '\0' */
+static bool frame_check_text(const uint8_t *pData, size_t szAvail, size_t *pszUsed) {
+    if (szAvail < 4U) {
+        return false;
+    }
+    uint32_t uLength = frame_get_u32(pData);
+    if ((0U == uLength) || (uLength > szAvail - 4U) || ('\0' != pData[4U + uLength - 1U])) {
+        return false;
+    }
+    *pszUsed = 4U + uLength;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool frame_decode_request(uint8_t *pRequest, size_t szLength, frameRequest_s *psRequest) {
+    memset(psRequest, 0, sizeof(*psRequest));
+    if (szLength < FRAME_REQUEST_HEADER_SIZE) {
+        return false;
+    }
+    psRequest->uTag = frame_get_u16(pRequest);
+    psRequest->uSelector = pRequest[2];
+    psRequest->uNrArgs = pRequest[3];
+    pRequest += FRAME_REQUEST_HEADER_SIZE;
+    szLength -= FRAME_REQUEST_HEADER_SIZE;
+
+    switch (psRequest->uSelector) {
+        case FRAME_BY_INDEX:
+        case FRAME_BY_HASH: {
+            if (szLength < 4U) {
+                return false;
+            }
+            psRequest->uCommand = frame_get_u32(pRequest);
+            pRequest += 4U;
+            szLength -= 4U;
+        } break;
+        case FRAME_BY_NAME: {
+            size_t szName = (szLength > 0U) ? pRequest[0] : 0U;
+            if ((0U == szName) || (szName > szLength - 1U) || ('\0' != pRequest[szName])) {
+                return false;
+            }
+            psRequest->pstrName = (char *)(pRequest + 1);
+            pRequest += 1U + szName;
+            szLength -= 1U + szName;
+        } break;
+        case FRAME_LIST: {
+        } break;
+        default: {
+            return false;
+        }
+    }
+    psRequest->pArgs = pRequest;
+    psRequest->szArgs = szLength;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool frame_next_arg(frameRequest_s *psRequest, frameArg_s *psArg) {
+    if (psRequest->szArgs < 1U) {
+        return false;
+    }
+    uint8_t *pData = psRequest->pArgs + 1;
+    size_t szAvail = psRequest->szArgs - 1U;
+    size_t szUsed = 0U;
+    size_t szItemSize = 0U;
+
+    psArg->cType = (char)psRequest->pArgs[0];
+    psArg->pData = pData;
+    psArg->uLength = 0U;
+    switch (psArg->cType) {
+        case 'l': { szUsed = 8U; } break;
+        case 'i': { szUsed = 4U; } break;
+        case 'f': { szUsed = 4U; } break;
+        case 'w': { szUsed = 2U; } break;
+        case 'b': { szUsed = 1U; } break;
+        case 'o': { szUsed = 1U; } break;
+        case 's':
+        case 'r': {
+            if (false == frame_check_text(pData, szAvail, &szUsed)) {
+                return false;
+            }
+            psArg->pData = pData + 4;
+            psArg->uLength = (uint32_t)(szUsed - 4U);
+        } break;
+        case 'x': {
+            if ((szAvail < 4U) || (frame_get_u32(pData) > szAvail - 4U)) {
+                return false;
+            }
+            psArg->pData = pData + 4;
+            psArg->uLength = frame_get_u32(pData);
+            szUsed = 4U + psArg->uLength;
+        } break;
+        case 'L': { szItemSize = 8U; } break;
+        case 'I': { szItemSize = 4U; } break;
+        case 'F': { szItemSize = 4U; } break;
+        case 'W': { szItemSize = 2U; } break;
+        case 'B': { szItemSize = 1U; } break;
+        case 'S': {
+            if (szAvail < 4U) {
+                return false;
+            }
+            psArg->pData = pData + 4;
+            psArg->uLength = frame_get_u32(pData);
+            szUsed = 4U;
+            for (uint32_t i = 0U; i < psArg->uLength; ++i) {
+                size_t szText = 0U;
+                if (false == frame_check_text(pData + szUsed, szAvail - szUsed, &szText)) {
+                    return false;
+                }
+                szUsed += szText;
+            }
+        } break;
+        default: {
+            return false;
+        }
+    }
+    if (0U != szItemSize) { /* numeric array */
+        if ((szAvail < 4U) || (frame_get_u32(pData) > (szAvail - 4U) / szItemSize)) {
+            return false;
+        }
+        psArg->pData = pData + 4;
+        psArg->uLength = frame_get_u32(pData);
+        szUsed = 4U + psArg->uLength * szItemSize;
+    }
+    if (szUsed > szAvail) {
+        return false;
+    }
+    psRequest->pArgs = pData + szUsed;
+    psRequest->szArgs = szAvail - szUsed;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+char *frame_next_string(uint8_t **ppData) {
+    char *pstrText = (char *)(*ppData + 4);
+    *ppData += 4U + frame_get_u32(*ppData);
+    return pstrText;
+}
+
+/*----------------------------------------------------------------------------*/
+size_t frame_begin_response(outputSink_s *psSink) {
+    static const uint8_t vHeader[FRAME_LENGTH_SIZE + FRAME_RESPONSE_HEADER_SIZE] = {};
+    size_t szStart = psSink->szLength;
+    output_sink_write(psSink, vHeader, sizeof(vHeader));
+    return szStart;
+}
+
+/*----------------------------------------------------------------------------*/
+void frame_end_response(outputSink_s *psSink, size_t szStart, const frameResponse_s *psResponse) {
+    if (psSink->szLength < szStart + FRAME_LENGTH_SIZE + FRAME_RESPONSE_HEADER_SIZE) {
+        return; /* the header did not fit */
+    }
+    uint8_t *pHeader = (uint8_t *)psSink->pBuffer + szStart;
+    frame_put_u32(pHeader, (uint32_t)(psSink->szLength - szStart - FRAME_LENGTH_SIZE));
+    pHeader[4] = (uint8_t)psResponse->uTag;
+    pHeader[5] = (uint8_t)(psResponse->uTag >> 8);
+    frame_put_u32(pHeader + 6, (uint32_t)psResponse->iError);
+    frame_put_u32(pHeader + 10, (uint32_t)psResponse->iRetVal);
+    frame_put_u32(pHeader + 14, (uint32_t)psResponse->iErrorArg);
+    frame_put_u32(pHeader + 18, psResponse->uElapsedUs);
+}
+
+/*----------------------------------------------------------------------------*/
+int frame_feed(frameAssembler_s *psAssembler, const uint8_t **ppData, size_t *pszAvail) {
+    while ((psAssembler->szLengthFill < FRAME_LENGTH_SIZE) && (*pszAvail > 0U)) {
+        psAssembler->vLength[psAssembler->szLengthFill++] = *(*ppData)++;
+        --(*pszAvail);
+        if (FRAME_LENGTH_SIZE == psAssembler->szLengthFill) {
+            psAssembler->szLength = frame_get_u32(psAssembler->vLength);
+            psAssembler->szFill = 0U;
+            if ((0U == psAssembler->szLength) || (psAssembler->szLength > uSHELL_MAX_FRAME_LEN)) {
+                return -1;
+            }
+            if (psAssembler->szLength > psAssembler->szSize) {
+                uint8_t *pFrame = (uint8_t *)realloc(psAssembler->pFrame, psAssembler->szLength);
+                if (nullptr == pFrame) {
+                    return -1;
+                }
+                psAssembler->pFrame = pFrame;
+                psAssembler->szSize = psAssembler->szLength;
+            }
+        }
+    }
+    if (psAssembler->szLengthFill < FRAME_LENGTH_SIZE) {
+        return 0;
+    }
+
+    size_t szCopy = psAssembler->szLength - psAssembler->szFill;
+    if (szCopy > *pszAvail) {
+        szCopy = *pszAvail;
+    }
+    memcpy(psAssembler->pFrame + psAssembler->szFill, *ppData, szCopy);
+    psAssembler->szFill += szCopy;
+    *ppData += szCopy;
+    *pszAvail -= szCopy;
+    if (psAssembler->szFill < psAssembler->szLength) {
+        return 0;
+    }
+    psAssembler->szLengthFill = 0U; /* the next request starts with its length */
+    return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+void frame_assembler_release(frameAssembler_s *psAssembler) {
+    free(psAssembler->pFrame);
+    memset(psAssembler, 0, sizeof(*psAssembler));
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
@@ -0,0 +1,182 @@
+#include "ushell_core_input.h"
+
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+
+#include "ushell_core_atomic.h"
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+#include "ushell_core_cancel.h"
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+#include "ushell_core_keys.h"
+#include "ushell_core_printout.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* waiting for the producer: a few checks, then the idle hook between the checks */
+#define INPUT_RING_SPINS           (64U)
+#if !defined(uSHELL_INPUT_RING_IDLE)
+    #if defined(SERIAL_TERMINAL)
+        #define uSHELL_INPUT_RING_IDLE()   /* busy wait, i.e. define it as __WFI() */
+    #else
+        #include <chrono>
+        #include <thread>
+        #define INPUT_RING_IDLE_US         (200)
+        #define uSHELL_INPUT_RING_IDLE()   std::this_thread::sleep_for(std::chrono::microseconds(INPUT_RING_IDLE_US))
+    #endif /* defined(SERIAL_TERMINAL) */
+#endif /* !defined(uSHELL_INPUT_RING_IDLE) */
+
+/* ring the shell reads from, nullptr: the terminal */
+static inputRing_s *g_psInputRing = nullptr;
+
+/*----------------------------------------------------------------------------*/
+bool input_ring_init(inputRing_s *psRing, uint8_t *pBuffer, size_t szSize) {
+    memset(psRing, 0, sizeof(*psRing));
+    if ((nullptr == pBuffer) || (szSize < 2U) || (0U != (szSize & (szSize - 1U)))) {
+        return false;
+    }
+    psRing->pBuffer = pBuffer;
+    psRing->szMask = szSize - 1U;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the room for szLength more bytes, the index of the consumer is only reloaded when the cached one is short */
+static bool input_ring_has_room(inputRing_s *psRing, size_t szLength) {
+    if (psRing->szHead - psRing->szTailCache + szLength <= psRing->szMask + 1U) {
+        return true;
+    }
+    psRing->szTailCache = uSHELL_LOAD_ACQUIRE(&psRing->szTail);
+    return (psRing->szHead - psRing->szTailCache + szLength <= psRing->szMask + 1U);
+}
+
+/*----------------------------------------------------------------------------*/
+bool input_ring_put(inputRing_s *psRing, uint8_t uByte) {
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    if ((uSHELL_KEY_CTRL_C == uByte) && (true == ushell_cancel_interrupt())) {
+        return true; /* taken by the command running */
+    }
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    if (false == input_ring_has_room(psRing, 1U)) {
+        ++psRing->uOverruns;
+        return false;
+    }
+    psRing->pBuffer[psRing->szHead & psRing->szMask] = uByte;
+    uSHELL_STORE_RELEASE(&psRing->szHead, psRing->szHead + 1U);
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+/* copy without publishing, the caller publishes the new head */
+static void input_ring_copy_in(inputRing_s *psRing, size_t szHead, const uint8_t *pData, size_t szLength) {
+    const size_t szStart = szHead & psRing->szMask;
+    const size_t szFirst = (szLength < psRing->szMask + 1U - szStart) ? szLength : (psRing->szMask + 1U - szStart);
+    memcpy(psRing->pBuffer + szStart, pData, szFirst);
+    memcpy(psRing->pBuffer, pData + szFirst, szLength - szFirst);
+}
+
+/*----------------------------------------------------------------------------*/
+bool input_ring_write(inputRing_s *psRing, const void *pvData, size_t szLength) {
+    if (false == input_ring_has_room(psRing, szLength)) {
+        return false;
+    }
+    input_ring_copy_in(psRing, psRing->szHead, (const uint8_t *)pvData, szLength);
+    uSHELL_STORE_RELEASE(&psRing->szHead, psRing->szHead + szLength);
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool input_ring_put_line(inputRing_s *psRing, const char *pstrLine) {
+    const size_t szLength = strlen(pstrLine);
+    const uint8_t uEnter = (uint8_t)uSHELL_KEY_ENTER;
+    if (false == input_ring_has_room(psRing, szLength + 1U)) {
+        return false;
+    }
+    input_ring_copy_in(psRing, psRing->szHead, (const uint8_t *)pstrLine, szLength);
+    input_ring_copy_in(psRing, psRing->szHead + szLength, &uEnter, 1U);
+    uSHELL_STORE_RELEASE(&psRing->szHead, psRing->szHead + szLength + 1U);
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+void input_ring_close(inputRing_s *psRing) {
+    uSHELL_STORE_RELEASE(&psRing->bClosed, true);
+}
+
+/*----------------------------------------------------------------------------*/
+/* bytes readable, the index of the producer is only reloaded when the cached batch is consumed */
+static size_t input_ring_available(inputRing_s *psRing) {
+    if (psRing->szTail == psRing->szHeadCache) {
+        psRing->szHeadCache = uSHELL_LOAD_ACQUIRE(&psRing->szHead);
+    }
+    return psRing->szHeadCache - psRing->szTail;
+}
+
+/*----------------------------------------------------------------------------*/
+int input_ring_get(inputRing_s *psRing) {
+    if (0U == input_ring_available(psRing)) {
+        return -1;
+    }
+    const uint8_t uByte = psRing->pBuffer[psRing->szTail & psRing->szMask];
+    uSHELL_STORE_RELEASE(&psRing->szTail, psRing->szTail + 1U);
+    return uByte;
+}
+
+/*----------------------------------------------------------------------------*/
+size_t input_ring_read(inputRing_s *psRing, uint8_t *pBuffer, size_t szSize) {
+    size_t szLength = input_ring_available(psRing);
+    if (szLength > szSize) {
+        szLength = szSize;
+    }
+    const size_t szStart = psRing->szTail & psRing->szMask;
+    const size_t szFirst = (szLength < psRing->szMask + 1U - szStart) ? szLength : (psRing->szMask + 1U - szStart);
+    memcpy(pBuffer, psRing->pBuffer + szStart, szFirst);
+    memcpy(pBuffer + szFirst, psRing->pBuffer, szLength - szFirst);
+    uSHELL_STORE_RELEASE(&psRing->szTail, psRing->szTail + szLength);
+    return szLength;
+}
+
+/*----------------------------------------------------------------------------*/
+int input_ring_wait_get(inputRing_s *psRing) {
+    unsigned int uSpins = 0U;
+    int iByte = -1;
+    while (-1 == (iByte = input_ring_get(psRing))) {
+        if (true == uSHELL_LOAD_ACQUIRE(&psRing->bClosed)) {
+            iByte = input_ring_get(psRing); /* written before the close */
+            return (-1 == iByte) ? EOF : iByte;
+        }
+        if (++uSpins > INPUT_RING_SPINS) {
+            uSHELL_INPUT_RING_IDLE();
+        }
+    }
+    return iByte;
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_input_attach(inputRing_s *psRing) {
+    g_psInputRing = psRing;
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_input_ended(void) {
+    inputRing_s *psRing = g_psInputRing;
+    return (nullptr != psRing) && (true == uSHELL_LOAD_ACQUIRE(&psRing->bClosed)) && (0U == input_ring_available(psRing));
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_input_attached(void) {
+    return (nullptr != g_psInputRing);
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_input_ready(void) {
+    inputRing_s *psRing = g_psInputRing;
+    return (nullptr != psRing) && ((0U != input_ring_available(psRing)) || (true == uSHELL_LOAD_ACQUIRE(&psRing->bClosed)));
+}
+
+/*----------------------------------------------------------------------------*/
+int ushell_getch(void) {
+    inputRing_s *psRing = g_psInputRing;
+    return (nullptr != psRing) ? input_ring_wait_get(psRing) : (int)uSHELL_TERMINAL_GETCH();
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
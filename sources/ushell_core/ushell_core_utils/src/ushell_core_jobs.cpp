@@ -0,0 +1,451 @@
+#include "ushell_core_jobs.h"
+
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+#include "ushell_core_input.h"
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+
+#include <coroutine>
+#include <cstddef>
+#include <string.h>
+
+/* clock of the timers, in milliseconds */
+#if !defined(uSHELL_JOBS_NOW_MS)
+    #include <chrono>
+    #define uSHELL_JOBS_NOW_MS()       ((uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#endif /* !defined(uSHELL_JOBS_NOW_MS) */
+
+/* waiting for a job or a key: one poll() on hosted builds, else checks with the idle hook between them */
+#if defined(uSHELL_JOBS_FD_WAITS)
+    #include <errno.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #define JOBS_RING_CHECK_MS         (1)      /* an input ring is checked between slices of the wait */
+#elif !defined(uSHELL_JOBS_IDLE)
+    #if defined(SERIAL_TERMINAL)
+        #define uSHELL_JOBS_IDLE()     /* busy wait, i.e. define it as __WFI() */
+    #else
+        #include <chrono>
+        #include <thread>
+        #define JOBS_IDLE_MS           (1)
+        #define uSHELL_JOBS_IDLE()     std::this_thread::sleep_for(std::chrono::milliseconds(JOBS_IDLE_MS))
+    #endif /* defined(SERIAL_TERMINAL) */
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+    #include <conio.h>
+#endif /* (defined(__MINGW32__) || defined(_MSC_VER)) */
+
+/* a command which blocks checks its token between slices of its waits, a job stopped runs at once */
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    #define JOBS_CANCEL_CHECK_MS       (10)
+    #define JOBS_STOPPED(psJob)        ((false == (psJob)->bStopSeen) && (CANCEL_NONE != cancel_token_reason(&(psJob)->sToken)))
+    #define JOBS_BLOCK_STOPPED()       ushell_should_stop()
+#else
+    #define JOBS_STOPPED(psJob)        (false)
+    #define JOBS_BLOCK_STOPPED()       (false)
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+/* the jobs and the last id given */
+static job_s    g_vsJobs[uSHELL_MAX_JOBS];
+static uint32_t g_uLastId = 0U;
+/* the command run by the interactive loop may go on as a job */
+static bool     g_bBackground = false;
+
+/* wait given by the coroutine which suspended last, and the end of the last one (see ushell_job_ready()) */
+static struct {
+    void       *pvResume;
+    jobWait_e   eWait;
+    int         iFd;
+    uint32_t    uTimeoutMs;
+    bool        bSet;
+} g_sWait;
+static bool     g_bReady = true;
+
+#if defined(uSHELL_TASK_FRAME_SIZE)
+#if !defined(uSHELL_TASK_FRAMES)
+    #define uSHELL_TASK_FRAMES         (2U * uSHELL_MAX_JOBS)  /* a command and one sub-command per job */
+#endif /* !defined(uSHELL_TASK_FRAMES) */
+typedef struct {
+    alignas(alignof(std::max_align_t)) uint8_t vData[uSHELL_TASK_FRAME_SIZE];
+} taskFrame_s;
+static taskFrame_s g_vsFrames[uSHELL_TASK_FRAMES];
+static bool        g_vbFrameUsed[uSHELL_TASK_FRAMES];
+#endif /* defined(uSHELL_TASK_FRAME_SIZE) */
+
+/*----------------------------------------------------------------------------*/
+void ushell_job_wait(void *pvResume, jobWait_e eWait, int iFd, uint32_t uTimeoutMs) {
+    g_sWait.pvResume = pvResume;
+    g_sWait.eWait = eWait;
+    g_sWait.iFd = iFd;
+    g_sWait.uTimeoutMs = uTimeoutMs;
+    g_sWait.bSet = true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_job_ready(void) {
+    return g_bReady;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the wait the coroutine suspended on becomes the one of the job */
+static void job_take_wait(job_s *psJob) {
+    if (true == g_sWait.bSet) {
+        psJob->pvResume = g_sWait.pvResume;
+        psJob->eWait = g_sWait.eWait;
+        psJob->iFd = g_sWait.iFd;
+        psJob->ullDeadlineMs = ((JOB_WAIT_TIMER == g_sWait.eWait) || (0U != g_sWait.uTimeoutMs)) ? (uSHELL_JOBS_NOW_MS() + g_sWait.uTimeoutMs) : 0U;
+        g_sWait.bSet = false;
+    } else {
+        psJob->eWait = JOB_WAIT_NONE; /* not suspended by the shell: resumed at the next pass */
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* resume a job whose wait is over (bReady false: the timeout of an fd wait)
+ * return true if the command ended */
+static bool job_resume(job_s *psJob, bool bReady) {
+    g_bReady = bReady;
+    g_sWait.bSet = false;
+    ++psJob->uResumes;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    cancelToken_s *psPrevious = ushell_cancel_enter(&psJob->sToken, false);
+    std::coroutine_handle<>::from_address(psJob->pvResume).resume();
+    ushell_cancel_leave(&psJob->sToken, psPrevious);
+#else
+    std::coroutine_handle<>::from_address(psJob->pvResume).resume();
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    if (true == std::coroutine_handle<>::from_address(psJob->pvFrame).done()) {
+        return true;
+    }
+    job_take_wait(psJob);
+    return false;
+}
+
+/*----------------------------------------------------------------------------*/
+/* milliseconds until the deadline, 0 if it is over */
+static uint32_t job_left_ms(const job_s *psJob, uint64_t ullNowMs) {
+    return (psJob->ullDeadlineMs > ullNowMs) ? (uint32_t)(psJob->ullDeadlineMs - ullNowMs) : 0U;
+}
+
+#if defined(uSHELL_JOBS_FD_WAITS)
+/*----------------------------------------------------------------------------*/
+/* timeout of the next poll() of a blocking wait, -1: none */
+static int job_slice_ms(const job_s *psJob) {
+    int iSliceMs = (0U != psJob->ullDeadlineMs) ? (int)job_left_ms(psJob, uSHELL_JOBS_NOW_MS()) : -1;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    if ((iSliceMs < 0) || (iSliceMs > JOBS_CANCEL_CHECK_MS)) {
+        iSliceMs = JOBS_CANCEL_CHECK_MS;
+    }
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    return iSliceMs;
+}
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+
+/*----------------------------------------------------------------------------*/
+/* a command which cannot go on as a job: wait for each of its waits in turn
+ * return true if the wait ended by its event, false by its timeout (or the command has to stop) */
+static bool job_block(const job_s *psJob) {
+    switch (psJob->eWait) {
+        case JOB_WAIT_TIMER: {
+            while ((uSHELL_JOBS_NOW_MS() < psJob->ullDeadlineMs) && (false == JOBS_BLOCK_STOPPED())) {
+#if defined(uSHELL_JOBS_FD_WAITS)
+                poll(nullptr, 0, job_slice_ms(psJob));
+#else
+                uSHELL_JOBS_IDLE();
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+            }
+        } break;
+#if defined(uSHELL_JOBS_FD_WAITS)
+        case JOB_WAIT_READ:
+        case JOB_WAIT_WRITE: {
+            struct pollfd sFd = { psJob->iFd, (short)((JOB_WAIT_READ == psJob->eWait) ? POLLIN : POLLOUT), 0 };
+            for (;;) {
+                if (true == JOBS_BLOCK_STOPPED()) {
+                    return false;
+                }
+                const int iReady = poll(&sFd, 1, job_slice_ms(psJob));
+                if ((iReady > 0) || ((iReady < 0) && (EINTR != errno))) {
+                    return true; /* ready, or the command finds the error on its descriptor */
+                }
+                if ((0U != psJob->ullDeadlineMs) && (0U == job_left_ms(psJob, uSHELL_JOBS_NOW_MS()))) {
+                    return false;
+                }
+            }
+        }
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+        default:
+            break;
+    }
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+int ushell_job_start(void *pvFrame, PFJOBEND pfEnd, const char *pstrName) {
+    job_s sJob;
+    memset(&sJob, 0, sizeof(sJob));
+    sJob.pvFrame = pvFrame;
+    sJob.pvResume = pvFrame;
+    sJob.pfEnd = pfEnd;
+    sJob.pstrName = pstrName;
+    sJob.iFd = -1;
+    job_take_wait(&sJob);
+
+    if (true == g_bBackground) {
+        for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+            if (nullptr == g_vsJobs[i].pvFrame) {
+                if (0U == ++g_uLastId) {
+                    g_uLastId = 1U;
+                }
+                sJob.uId = g_uLastId;
+                g_vsJobs[i] = sJob;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+                cancel_token_init(&g_vsJobs[i].sToken, ushell_cancel_left_ms()); /* the rest of the timeout of the command */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+                return (int)sJob.uId;
+            }
+        }
+    }
+    /* no interactive loop to resume it or no free slot: the command blocks */
+    while (false == job_resume(&sJob, job_block(&sJob))) {}
+    return pfEnd(pvFrame);
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_jobs_background(bool bAllowed) {
+    g_bBackground = bAllowed;
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_jobs_pending(void) {
+    for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+        if (nullptr != g_vsJobs[i].pvFrame) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if defined(uSHELL_JOBS_FD_WAITS)
+/*----------------------------------------------------------------------------*/
+/* the descriptors the jobs wait for, psSlots: the slot of each one
+ * return their number */
+static size_t jobs_poll_fds(struct pollfd *psFds, size_t *pszSlots) {
+    size_t szCount = 0U;
+    for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+        const job_s *psJob = &g_vsJobs[i];
+        if ((nullptr != psJob->pvFrame) && ((JOB_WAIT_READ == psJob->eWait) || (JOB_WAIT_WRITE == psJob->eWait))) {
+            psFds[szCount].fd = psJob->iFd;
+            psFds[szCount].events = (short)((JOB_WAIT_READ == psJob->eWait) ? POLLIN : POLLOUT);
+            psFds[szCount].revents = 0;
+            if (nullptr != pszSlots) {
+                pszSlots[szCount] = i;
+            }
+            ++szCount;
+        }
+    }
+    return szCount;
+}
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+
+/*----------------------------------------------------------------------------*/
+size_t ushell_jobs_run(jobEnd_s *psEnded) {
+    bool vbFdReady[uSHELL_MAX_JOBS] = { false };
+#if defined(uSHELL_JOBS_FD_WAITS)
+    struct pollfd vsFds[uSHELL_MAX_JOBS];
+    size_t vszSlots[uSHELL_MAX_JOBS];
+    const size_t szFds = jobs_poll_fds(vsFds, vszSlots);
+    if ((0U != szFds) && (poll(vsFds, (nfds_t)szFds, 0) > 0)) {
+        for (size_t i = 0U; i < szFds; ++i) {
+            vbFdReady[vszSlots[i]] = (0 != vsFds[i].revents);
+        }
+    }
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+    const uint64_t ullNowMs = uSHELL_JOBS_NOW_MS();
+    size_t szEnded = 0U;
+
+    for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+        job_s *psJob = &g_vsJobs[i];
+        if (nullptr == psJob->pvFrame) {
+            continue;
+        }
+        const bool bTimedOut = (0U != psJob->ullDeadlineMs) && (ullNowMs >= psJob->ullDeadlineMs);
+        const bool bStopped = JOBS_STOPPED(psJob);
+        bool bDue = bStopped;
+        switch (psJob->eWait) {
+            case JOB_WAIT_TIMER: bDue = bDue || bTimedOut; break;
+            case JOB_WAIT_READ:
+            case JOB_WAIT_WRITE: bDue = bDue || (true == vbFdReady[i]) || (true == bTimedOut); break;
+            default:             bDue = true; break;
+        }
+        const bool bReady = (JOB_WAIT_TIMER == psJob->eWait) || (true == vbFdReady[i]) || ((false == bTimedOut) && (false == bStopped));
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        psJob->bStopSeen = psJob->bStopSeen || bStopped;
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+        if ((true == bDue) && (true == job_resume(psJob, bReady))) {
+            psEnded[szEnded].uId = psJob->uId;
+            psEnded[szEnded].pstrName = psJob->pstrName;
+            psEnded[szEnded].iResult = psJob->pfEnd(psJob->pvFrame);
+            ++szEnded;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+            cancel_token_release(&psJob->sToken);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+            memset(psJob, 0, sizeof(*psJob));
+        }
+    }
+    return szEnded;
+}
+
+/*----------------------------------------------------------------------------*/
+/* milliseconds until the first job can run, -1: none has a timer */
+static int32_t jobs_timeout_ms(uint64_t ullNowMs) {
+    int32_t iTimeoutMs = -1;
+    for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+        const job_s *psJob = &g_vsJobs[i];
+        if (nullptr == psJob->pvFrame) {
+            continue;
+        }
+        if ((JOB_WAIT_NONE == psJob->eWait) || (true == JOBS_STOPPED(psJob))) {
+            return 0;
+        }
+        if (0U != psJob->ullDeadlineMs) {
+            const int32_t iLeftMs = (int32_t)job_left_ms(psJob, ullNowMs);
+            if ((iTimeoutMs < 0) || (iLeftMs < iTimeoutMs)) {
+                iTimeoutMs = iLeftMs;
+            }
+        }
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        const int32_t iStopMs = (int32_t)cancel_token_left_ms(&psJob->sToken); /* woken when its timeout fires */
+        if ((0 != iStopMs) && ((iTimeoutMs < 0) || (iStopMs < iTimeoutMs))) {
+            iTimeoutMs = iStopMs;
+        }
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    }
+    return iTimeoutMs;
+}
+
+/*----------------------------------------------------------------------------*/
+/* a key can be read without waiting (the terminal of a hosted build is polled with the jobs) */
+static bool jobs_key_ready(void) {
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+    if (true == ushell_input_attached()) {
+        return ushell_input_ready();
+    }
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+    return (0 != _kbhit());
+#else
+    return false;
+#endif /* (defined(__MINGW32__) || defined(_MSC_VER)) */
+}
+
+/*----------------------------------------------------------------------------*/
+bool ushell_jobs_wait_key(void) {
+    const uint64_t ullStartMs = uSHELL_JOBS_NOW_MS();
+    const int32_t iTimeoutMs = jobs_timeout_ms(ullStartMs);
+
+    while (false == jobs_key_ready()) {
+        const uint64_t ullElapsedMs = uSHELL_JOBS_NOW_MS() - ullStartMs;
+        if ((iTimeoutMs >= 0) && (ullElapsedMs >= (uint64_t)iTimeoutMs)) {
+            return false;
+        }
+#if defined(uSHELL_JOBS_FD_WAITS)
+        const int32_t iLeftMs = (iTimeoutMs < 0) ? -1 : (int32_t)(iTimeoutMs - (int32_t)ullElapsedMs);
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+        const bool bTerminal = (false == ushell_input_attached());
+#else
+        const bool bTerminal = true;
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+        struct pollfd vsFds[uSHELL_MAX_JOBS + 1U];
+        vsFds[0].fd = (true == bTerminal) ? STDIN_FILENO : -1; /* a negative descriptor is skipped */
+        vsFds[0].events = POLLIN;
+        vsFds[0].revents = 0;
+        const size_t szFds = 1U + jobs_poll_fds(&vsFds[1], nullptr);
+        const int iSliceMs = ((true == bTerminal) || ((iLeftMs >= 0) && (iLeftMs < JOBS_RING_CHECK_MS))) ? iLeftMs : JOBS_RING_CHECK_MS;
+        const int iReady = poll(vsFds, (nfds_t)szFds, iSliceMs);
+        if (iReady > 0) {
+            return (0 != vsFds[0].revents) || (true == jobs_key_ready()); /* false: the descriptor of a job */
+        }
+        if ((iReady < 0) && (EINTR != errno)) {
+            return true; /* the key is read the usual way */
+        }
+#else
+        uSHELL_JOBS_IDLE();
+#endif /* defined(uSHELL_JOBS_FD_WAITS) */
+    }
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_jobs_drop(void) {
+    for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+        if (nullptr != g_vsJobs[i].pvFrame) {
+            std::coroutine_handle<>::from_address(g_vsJobs[i].pvFrame).destroy();
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+            cancel_token_release(&g_vsJobs[i].sToken);
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+            memset(&g_vsJobs[i], 0, sizeof(g_vsJobs[i]));
+        }
+    }
+}
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/*----------------------------------------------------------------------------*/
+bool ushell_job_cancel(uint32_t uId) {
+    for (size_t i = 0U; i < uSHELL_MAX_JOBS; ++i) {
+        if ((nullptr != g_vsJobs[i].pvFrame) && (uId == g_vsJobs[i].uId)) {
+            cancel_token_fire(&g_vsJobs[i].sToken, CANCEL_REQUEST);
+            return true;
+        }
+    }
+    return false;
+}
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+/*----------------------------------------------------------------------------*/
+const job_s *ushell_job_get(size_t szSlot) {
+    return ((szSlot < uSHELL_MAX_JOBS) && (nullptr != g_vsJobs[szSlot].pvFrame)) ? &g_vsJobs[szSlot] : nullptr;
+}
+
+/*----------------------------------------------------------------------------*/
+const char *job_wait_name(jobWait_e eWait) {
+    switch (eWait) {
+#define JOB_WAIT(id, name) case id: return name;
+        JOB_WAIT_TABLE
+#undef JOB_WAIT
+        default: return "unknown";
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+uint32_t ushell_job_remaining_ms(const job_s *psJob) {
+    return (0U != psJob->ullDeadlineMs) ? job_left_ms(psJob, uSHELL_JOBS_NOW_MS()) : 0U;
+}
+
+#if defined(uSHELL_TASK_FRAME_SIZE)
+/*----------------------------------------------------------------------------*/
+void *ushell_task_frame_alloc(size_t szSize) {
+    if (szSize > uSHELL_TASK_FRAME_SIZE) {
+        return nullptr;
+    }
+    for (size_t i = 0U; i < uSHELL_TASK_FRAMES; ++i) {
+        if (false == g_vbFrameUsed[i]) {
+            g_vbFrameUsed[i] = true;
+            return g_vsFrames[i].vData;
+        }
+    }
+    return nullptr;
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_task_frame_free(void *pvFrame) {
+    for (size_t i = 0U; i < uSHELL_TASK_FRAMES; ++i) {
+        if (g_vsFrames[i].vData == pvFrame) {
+            g_vbFrameUsed[i] = false;
+            return;
+        }
+    }
+}
+#endif /* defined(uSHELL_TASK_FRAME_SIZE) */
+
+#endif /* (1 == uSHELL_SUPPORTS_COROUTINES) */
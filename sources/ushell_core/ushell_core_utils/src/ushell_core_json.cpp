@@ -0,0 +1,152 @@
+#include "ushell_core_json.h"
+
+#if (1 == uSHELL_SUPPORTS_JSON_OUTPUT)
+
+#include "ushell_core_datatypes.h"
+
+#include <string.h>
+
+#define JSON_TOKEN_SEPARATOR       ' '
+#define JSON_ESCAPE_CHAR           '\x1B'
+#define JSON_CSI_CHAR              '['
+
+/*----------------------------------------------------------------------------*/
+const char *json_error_kind(int iError) {
+    switch (iError) {
+        case uSHELL_ERR_OK                       : return "ok";
+        case uSHELL_ERR_ITEM_NOT_FOUND           : return "item_not_found";
+        case uSHELL_ERR_FUNCTION_NOT_FOUND       : return "command_not_found";
+        case uSHELL_ERR_WRONG_NUMBER_ARGS        : return "wrong_number_args";
+        case uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM    : return "type_not_implemented";
+        case uSHELL_ERR_STRING_NOT_CLOSED        : return "string_not_closed";
+        case uSHELL_ERR_TOO_MANY_ARGS            : return "too_many_args";
+        case uSHELL_ERR_INVALID_NUMBER           : return "invalid_number";
+        case uSHELL_ERR_VALUE_TOO_BIG            : return "value_too_big";
+        case uSHELL_ERR_FILE_NOT_READABLE        : return "file_not_readable";
+        case uSHELL_ERR_INPUT_TOO_LONG           : return "input_too_long";
+        case uSHELL_ERR_NO_TASK_FRAME            : return "no_task_frame";
+        case uSHELL_ERR_INTERRUPTED              : return "interrupted";
+        case uSHELL_ERR_TIMEOUT                  : return "timeout";
+        default                                  : return "unknown";
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* the text escaped, without the quotes */
+static bool json_write_escaped(outputSink_s *psSink, const char *pstrText, size_t szLength) {
+    static const char vHexDigits[] = "0123456789abcdef";
+    bool bOk = true;
+    size_t szRun = 0U; /* bytes copied as they are */
+
+    for (size_t i = 0U; i < szLength; ++i) {
+        const unsigned char c = (unsigned char)pstrText[i];
+        if ((c >= 0x20U) && ('"' != c) && ('\\' != c)) {
+            continue;
+        }
+        char vEscape[6] = { '\\', (char)c, 0, 0, 0, 0 };
+        size_t szEscape = 2U;
+        switch (c) {
+            case '\n': { vEscape[1] = 'n'; } break;
+            case '\r': { vEscape[1] = 'r'; } break;
+            case '\t': { vEscape[1] = 't'; } break;
+            case '"' :
+            case '\\': { } break;
+            default  : {
+                memcpy(vEscape, "\\u00", 4U);
+                vEscape[4] = vHexDigits[c >> 4];
+                vEscape[5] = vHexDigits[c & 0x0FU];
+                szEscape = 6U;
+            } break;
+        }
+        bOk = output_sink_write(psSink, pstrText + szRun, i - szRun) && bOk;
+        bOk = output_sink_write(psSink, vEscape, szEscape) && bOk;
+        szRun = i + 1U;
+    }
+    return output_sink_write(psSink, pstrText + szRun, szLength - szRun) && bOk;
+}
+
+/*----------------------------------------------------------------------------*/
+bool json_write_string(outputSink_s *psSink, const char *pstrText, size_t szLength) {
+    bool bOk = output_sink_write(psSink, "\"", 1U);
+    bOk = json_write_escaped(psSink, pstrText, szLength) && bOk;
+    return output_sink_write(psSink, "\"", 1U) && bOk;
+}
+
+/*----------------------------------------------------------------------------*/
+bool json_write_output(outputSink_s *psSink, const char *pstrText, size_t szLength) {
+    bool bOk = output_sink_write(psSink, "\"", 1U);
+    size_t szRun = 0U;
+
+    for (size_t i = 0U; i < szLength; ++i) {
+        if (('\r' != pstrText[i]) && (JSON_ESCAPE_CHAR != pstrText[i])) {
+            continue;
+        }
+        bOk = json_write_escaped(psSink, pstrText + szRun, i - szRun) && bOk;
+        if ((JSON_ESCAPE_CHAR == pstrText[i]) && (i + 1U < szLength) && (JSON_CSI_CHAR == pstrText[i + 1U])) {
+            i += 2U; /* parameters up to the final byte, @ to ~ */
+            while ((i < szLength) && ((pstrText[i] < '@') || (pstrText[i] > '~'))) {
+                ++i;
+            }
+        }
+        szRun = i + 1U;
+    }
+    if (szRun < szLength) {
+        bOk = json_write_escaped(psSink, pstrText + szRun, szLength - szRun) && bOk;
+    }
+    return output_sink_write(psSink, "\"", 1U) && bOk;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the next token of the command line, a bordered string without its borders */
+static bool json_next_token(const char **ppstrRest, char cStringBorder, const char **ppstrToken, size_t *pszToken) {
+    const char *pstrRest = *ppstrRest;
+    while (JSON_TOKEN_SEPARATOR == *pstrRest) {
+        ++pstrRest;
+    }
+    if ('\0' == *pstrRest) {
+        return false;
+    }
+    const char *pstrEnd = nullptr;
+    if (cStringBorder == *pstrRest) {
+        *ppstrToken = ++pstrRest;
+        pstrEnd = strchr(pstrRest, cStringBorder);
+        if (nullptr == pstrEnd) {
+            pstrEnd = pstrRest + strlen(pstrRest); /* not closed, the error is reported by the shell */
+        }
+        *ppstrRest = ('\0' == *pstrEnd) ? pstrEnd : (pstrEnd + 1);
+    } else {
+        *ppstrToken = pstrRest;
+        pstrEnd = strchr(pstrRest, JSON_TOKEN_SEPARATOR);
+        if (nullptr == pstrEnd) {
+            pstrEnd = pstrRest + strlen(pstrRest);
+        }
+        *ppstrRest = pstrEnd;
+    }
+    *pszToken = (size_t)(pstrEnd - *ppstrToken);
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool json_write_record(outputSink_s *psSink, const jsonRecord_s *psRecord) {
+    const char *pstrRest = (nullptr != psRecord->pstrCommand) ? psRecord->pstrCommand : "";
+    const char *pstrToken = "";
+    size_t szToken = 0U;
+
+    output_sink_printf(psSink, "{\"seq\":%u,\"cmd\":", (unsigned int)psRecord->uSeq);
+    json_next_token(&pstrRest, psRecord->cStringBorder, &pstrToken, &szToken);
+    json_write_string(psSink, pstrToken, szToken);
+    output_sink_write(psSink, ",\"args\":[", 9U);
+    for (bool bFirst = true; json_next_token(&pstrRest, psRecord->cStringBorder, &pstrToken, &szToken); bFirst = false) {
+        if (false == bFirst) {
+            output_sink_write(psSink, ",", 1U);
+        }
+        json_write_string(psSink, pstrToken, szToken);
+    }
+    output_sink_printf(psSink, "],\"ok\":%s,\"ret\":%d,\"error\":\"%s\",\"error_arg\":%d,\"us\":%u,\"output\":",
+                       ((uSHELL_ERR_OK == psRecord->iError) && (psRecord->iRetVal >= 0)) ? "true" : "false",
+                       psRecord->iRetVal, json_error_kind(psRecord->iError), psRecord->iErrorArg, (unsigned int)psRecord->uElapsedUs);
+    json_write_output(psSink, psRecord->pOutput, psRecord->szOutput);
+    return output_sink_write(psSink, "}\n", 2U);
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_JSON_OUTPUT) */
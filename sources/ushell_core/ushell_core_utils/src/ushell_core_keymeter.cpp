@@ -0,0 +1,112 @@
+#include "ushell_core_keymeter.h"
+
+#if (1 == uSHELL_SUPPORTS_KEY_METER)
+
+#include <string.h>
+
+#define KEY_METER_BITS_PER_BYTE    (10U)    /* start, 8 data, stop */
+#define KEY_METER_NS_PER_SECOND    (1000000000ULL)
+
+/* clocks of the meter, in nanoseconds: the time and the CPU time of the shell thread */
+#if !defined(uSHELL_KEY_METER_NOW_NS)
+    #include <chrono>
+    #define uSHELL_KEY_METER_NOW_NS()  ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#endif /* !defined(uSHELL_KEY_METER_NOW_NS) */
+#if !defined(uSHELL_KEY_METER_CPU_NS)
+    #if defined(__linux__) || defined(__APPLE__)
+        #include <time.h>
+        #define uSHELL_KEY_METER_CPU_NS()  key_meter_thread_cpu_ns()
+        static uint64_t key_meter_thread_cpu_ns(void) {
+            struct timespec sTime;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &sTime);
+            return (uint64_t)sTime.tv_sec * KEY_METER_NS_PER_SECOND + (uint64_t)sTime.tv_nsec;
+        }
+    #else
+        #include <time.h>
+        #define uSHELL_KEY_METER_CPU_NS()  ((uint64_t)clock() * (KEY_METER_NS_PER_SECOND / CLOCKS_PER_SEC)) /* of the process */
+    #endif /* defined(__linux__) || defined(__APPLE__) */
+#endif /* !defined(uSHELL_KEY_METER_CPU_NS) */
+
+/* meter of the shell, nullptr: the keystrokes are not measured */
+static keyMeter_s *g_psKeyMeter = nullptr;
+
+/*----------------------------------------------------------------------------*/
+void key_meter_init(keyMeter_s *psMeter, unsigned int uBaud, inputRing_s *psInput, txRing_s *psOutput) {
+    memset(psMeter, 0, sizeof(*psMeter));
+    psMeter->ullByteNs = (0U != uBaud) ? (KEY_METER_NS_PER_SECOND * KEY_METER_BITS_PER_BYTE / uBaud) : 0U;
+    psMeter->psInput = psInput;
+    psMeter->psOutput = psOutput;
+}
+
+/*----------------------------------------------------------------------------*/
+const char *key_meter_class_name(keyClass_e eClass) {
+    switch (eClass) {
+#define KEY_METER_CLASS(id, name) case id: return name;
+        KEY_METER_CLASS_TABLE
+#undef KEY_METER_CLASS
+        default: return "unknown";
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_key_meter_attach(keyMeter_s *psMeter) {
+    g_psKeyMeter = psMeter;
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_key_meter_begin(keyClass_e eClass) {
+    keyMeter_s *psMeter = g_psKeyMeter;
+    if (nullptr == psMeter) {
+        return;
+    }
+    psMeter->bActive = true;
+    psMeter->eClass = eClass;
+    /* both indexes belong to the shell thread: its reads of the input, its writes of the output */
+    psMeter->szInputTail = (nullptr != psMeter->psInput) ? (psMeter->psInput->szTail - 1U) : 0U; /* the first byte is read */
+    psMeter->szOutputHead = (nullptr != psMeter->psOutput) ? psMeter->psOutput->szHead : 0U;
+    psMeter->ullStartCpuNs = uSHELL_KEY_METER_CPU_NS();
+    psMeter->ullStartNs = uSHELL_KEY_METER_NOW_NS();
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_key_meter_class(keyClass_e eClass) {
+    keyMeter_s *psMeter = g_psKeyMeter;
+    if ((nullptr != psMeter) && (true == psMeter->bActive)) {
+        psMeter->eClass = eClass;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+void ushell_key_meter_end(void) {
+    keyMeter_s *psMeter = g_psKeyMeter;
+    if ((nullptr == psMeter) || (false == psMeter->bActive) || (psMeter->eClass >= KEY_CLASS_LAST)) {
+        return;
+    }
+    const uint64_t ullElapsedNs = uSHELL_KEY_METER_NOW_NS() - psMeter->ullStartNs;
+    const uint64_t ullCpuNs = uSHELL_KEY_METER_CPU_NS() - psMeter->ullStartCpuNs;
+    const size_t szBytesIn = (nullptr != psMeter->psInput) ? (psMeter->psInput->szTail - psMeter->szInputTail) : 1U;
+    size_t szBytesOut = 0U;
+    size_t szPending = 0U;
+    if (nullptr != psMeter->psOutput) {
+        szBytesOut = psMeter->psOutput->szHead - psMeter->szOutputHead;
+        szPending = tx_ring_pending(psMeter->psOutput);
+    }
+    const uint64_t ullLatencyNs = (uint64_t)szBytesIn * psMeter->ullByteNs + ullElapsedNs + (uint64_t)szBytesOut * psMeter->ullByteNs;
+    const uint64_t ullQueuedNs = (uint64_t)szBytesIn * psMeter->ullByteNs + ullElapsedNs + (uint64_t)szPending * psMeter->ullByteNs;
+
+    keyMeterStats_s *psStats = &psMeter->vStats[psMeter->eClass];
+    ++psStats->uKeys;
+    psStats->ullBytesIn += szBytesIn;
+    psStats->ullBytesOut += szBytesOut;
+    psStats->ullCpuNs += ullCpuNs;
+    psStats->ullLatencyNs += ullLatencyNs;
+    if (ullLatencyNs > psStats->ullMaxLatencyNs) {
+        psStats->ullMaxLatencyNs = ullLatencyNs;
+    }
+    if (ullQueuedNs > psStats->ullMaxQueuedNs) {
+        psStats->ullMaxQueuedNs = ullQueuedNs;
+    }
+    psMeter->bActive = false;
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_KEY_METER) */
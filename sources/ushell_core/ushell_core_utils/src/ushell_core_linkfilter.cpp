@@ -0,0 +1,384 @@
+#include "ushell_core_linkfilter.h"
+
+#if (1 == uSHELL_SUPPORTS_LINK_FILTER)
+
+#include <stdio.h>
+#include <string.h>
+
+#define LINK_ESCAPE_CHAR           '\x1B'
+#define LINK_CSI_CHAR              '['
+#define LINK_BACKSPACE_CHAR        '\b'
+#define LINK_MAX_BACKSPACES        (3U)     /* "\033[4D" is as long as 4 backspaces */
+
+/* states of the decoder */
+typedef enum {
+    LINK_STATE_TEXT = 0,
+    LINK_STATE_ESCAPE,
+    LINK_STATE_CSI
+} linkState_e;
+
+/* SGR attribute codes */
+#define LINK_SGR_RESET             (0U)
+#define LINK_SGR_BOLD              (1U)
+#define LINK_SGR_DIM               (2U)
+#define LINK_SGR_LAST_FLAG         (9U)     /* 1..9: bold .. crossed out */
+#define LINK_SGR_NORMAL_INTENSITY  (22U)    /* bold and dim off */
+#define LINK_SGR_BLINK             (5U)
+#define LINK_SGR_RAPID_BLINK       (6U)
+#define LINK_SGR_FLAG_OFF          (20U)    /* 23..29: flag n - 20 off */
+#define LINK_SGR_DEFAULT_FG        (39U)
+#define LINK_SGR_DEFAULT_BG        (49U)
+
+#define LINK_FLAG(n)               ((uint16_t)(1U << (n)))
+
+/*----------------------------------------------------------------------------*/
+static void link_emit(linkFilter_s *psFilter) {
+    if (0U != psFilter->szOut) {
+        psFilter->pfOutput(psFilter->vOut, psFilter->szOut, psFilter->pvContext);
+        psFilter->ullBytesOut += psFilter->szOut;
+        psFilter->szOut = 0U;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+static void link_put_raw(linkFilter_s *psFilter, const char *pstrText, size_t szLength) {
+    while (0U != szLength) {
+        if (sizeof(psFilter->vOut) == psFilter->szOut) {
+            link_emit(psFilter);
+        }
+        const size_t szRoom = sizeof(psFilter->vOut) - psFilter->szOut;
+        const size_t szChunk = (szLength < szRoom) ? szLength : szRoom;
+        memcpy(psFilter->vOut + psFilter->szOut, pstrText, szChunk);
+        psFilter->szOut += szChunk;
+        pstrText += szChunk;
+        szLength -= szChunk;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+static void link_send_hide(linkFilter_s *psFilter) {
+    link_put_raw(psFilter, "\033[?25l", 6U);
+    psFilter->bHidePending = false;
+    psFilter->bHidden = true;
+}
+
+/*----------------------------------------------------------------------------*/
+/* more output after a held movement: the hide and the movement are sent first */
+static void link_release(linkFilter_s *psFilter) {
+    if (0U != psFilter->szHeld) {
+        link_send_hide(psFilter);
+        link_put_raw(psFilter, psFilter->vHeld, psFilter->szHeld);
+        psFilter->szHeld = 0U;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+static void link_put(linkFilter_s *psFilter, const char *pstrText, size_t szLength) {
+    link_release(psFilter);
+    link_put_raw(psFilter, pstrText, szLength);
+}
+
+/*----------------------------------------------------------------------------*/
+/* a cursor movement: the first one after a hide is held back, it may be the only one */
+static void link_move(linkFilter_s *psFilter, const char *pstrMove, size_t szLength) {
+    if ((true == psFilter->bHidePending) && (0U == psFilter->szHeld) && (szLength <= sizeof(psFilter->vHeld))) {
+        memcpy(psFilter->vHeld, pstrMove, szLength);
+        psFilter->szHeld = szLength;
+        return;
+    }
+    link_release(psFilter);
+    if (true == psFilter->bHidePending) {
+        link_send_hide(psFilter);
+    }
+    link_put_raw(psFilter, pstrMove, szLength);
+}
+
+/*----------------------------------------------------------------------------*/
+/* ";n" appended to the parameters of a SGR sequence */
+static size_t link_sgr_param(char *pstrParams, size_t szLength, unsigned int uCode) {
+    return szLength + (size_t)sprintf(pstrParams + szLength, (0U == szLength) ? "%u" : ";%u", uCode);
+}
+
+/*----------------------------------------------------------------------------*/
+/* parameters setting the attributes after a reset, "" for the default ones */
+static size_t link_sgr_full(const linkAttr_s *psWanted, char *pstrParams) {
+    size_t szLength = 0U;
+    for (unsigned int n = LINK_SGR_BOLD; n <= LINK_SGR_LAST_FLAG; ++n) {
+        if (0U != (psWanted->uFlags & LINK_FLAG(n))) {
+            szLength = link_sgr_param(pstrParams, szLength, n);
+        }
+    }
+    if (0U != psWanted->uFg) {
+        szLength = link_sgr_param(pstrParams, szLength, psWanted->uFg);
+    }
+    if (0U != psWanted->uBg) {
+        szLength = link_sgr_param(pstrParams, szLength, psWanted->uBg);
+    }
+    return szLength;
+}
+
+/*----------------------------------------------------------------------------*/
+/* parameters changing only what differs */
+static size_t link_sgr_delta(const linkAttr_s *psShown, const linkAttr_s *psWanted, char *pstrParams) {
+    uint16_t uOff = (uint16_t)(psShown->uFlags & ~psWanted->uFlags);
+    uint16_t uOn = (uint16_t)(psWanted->uFlags & ~psShown->uFlags);
+    size_t szLength = 0U;
+
+    if (0U != (uOff & (LINK_FLAG(LINK_SGR_BOLD) | LINK_FLAG(LINK_SGR_DIM)))) {
+        szLength = link_sgr_param(pstrParams, szLength, LINK_SGR_NORMAL_INTENSITY); /* both off, the one kept is set again */
+        uOn = (uint16_t)(uOn | (psWanted->uFlags & (LINK_FLAG(LINK_SGR_BOLD) | LINK_FLAG(LINK_SGR_DIM))));
+        uOff = (uint16_t)(uOff & ~(LINK_FLAG(LINK_SGR_BOLD) | LINK_FLAG(LINK_SGR_DIM)));
+    }
+    if (0U != (uOff & LINK_FLAG(LINK_SGR_RAPID_BLINK))) {
+        uOff = (uint16_t)((uOff & ~LINK_FLAG(LINK_SGR_RAPID_BLINK)) | LINK_FLAG(LINK_SGR_BLINK)); /* 25: both blinks off */
+    }
+    for (unsigned int n = LINK_SGR_BOLD; n <= LINK_SGR_LAST_FLAG; ++n) {
+        if (0U != (uOff & LINK_FLAG(n))) {
+            szLength = link_sgr_param(pstrParams, szLength, LINK_SGR_FLAG_OFF + n);
+        }
+    }
+    for (unsigned int n = LINK_SGR_BOLD; n <= LINK_SGR_LAST_FLAG; ++n) {
+        if (0U != (uOn & LINK_FLAG(n))) {
+            szLength = link_sgr_param(pstrParams, szLength, n);
+        }
+    }
+    if (psShown->uFg != psWanted->uFg) {
+        szLength = link_sgr_param(pstrParams, szLength, (0U != psWanted->uFg) ? psWanted->uFg : LINK_SGR_DEFAULT_FG);
+    }
+    if (psShown->uBg != psWanted->uBg) {
+        szLength = link_sgr_param(pstrParams, szLength, (0U != psWanted->uBg) ? psWanted->uBg : LINK_SGR_DEFAULT_BG);
+    }
+    return szLength;
+}
+
+/*----------------------------------------------------------------------------*/
+/* before a visible character: the terminal gets the attributes asked for, by the shortest sequence */
+static void link_apply_attr(linkFilter_s *psFilter) {
+    const linkAttr_s *psShown = &psFilter->sShown;
+    const linkAttr_s *psWanted = &psFilter->sWanted;
+    if ((true == psFilter->bWantedRaw) ||
+        ((true == psFilter->bShownKnown) && (psShown->uFlags == psWanted->uFlags) && (psShown->uFg == psWanted->uFg) && (psShown->uBg == psWanted->uBg))) {
+        return;
+    }
+    char vFull[LINK_FILTER_SEQ_LEN + 4U] = "0;";
+    size_t szFull = link_sgr_full(psWanted, vFull + 2);
+    szFull = (0U == szFull) ? 0U : (szFull + 2U); /* "\033[m" is the reset */
+    const char *pstrParams = (0U == szFull) ? "" : vFull;
+    size_t szParams = szFull;
+    char vDelta[LINK_FILTER_SEQ_LEN + 4U];
+    if (true == psFilter->bShownKnown) {
+        const size_t szDelta = link_sgr_delta(psShown, psWanted, vDelta);
+        if (szDelta < szParams) {
+            pstrParams = vDelta;
+            szParams = szDelta;
+        }
+    }
+    link_put(psFilter, "\033[", 2U);
+    link_put(psFilter, pstrParams, szParams);
+    link_put(psFilter, "m", 1U);
+    psFilter->sShown = *psWanted;
+    psFilter->bShownKnown = true;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the attributes asked for by the parameters of a SGR sequence, false if one is not decoded */
+static bool link_decode_sgr(const char *pstrParams, size_t szLength, linkAttr_s *psAttr) {
+    size_t i = 0U;
+    do {
+        unsigned int uCode = 0U;
+        size_t szDigits = 0U;
+        while ((i < szLength) && (pstrParams[i] >= '0') && (pstrParams[i] <= '9') && (szDigits < 3U)) {
+            uCode = uCode * 10U + (unsigned int)(pstrParams[i++] - '0');
+            ++szDigits;
+        }
+        if ((i < szLength) && (';' != pstrParams[i])) {
+            return false; /* a sub-parameter (':'), a private one or a number too long */
+        }
+        ++i;
+        if (LINK_SGR_RESET == uCode) {
+            memset(psAttr, 0, sizeof(*psAttr));
+        } else if (uCode <= LINK_SGR_LAST_FLAG) {
+            psAttr->uFlags = (uint16_t)(psAttr->uFlags | LINK_FLAG(uCode));
+        } else if (LINK_SGR_NORMAL_INTENSITY == uCode) {
+            psAttr->uFlags = (uint16_t)(psAttr->uFlags & ~(LINK_FLAG(LINK_SGR_BOLD) | LINK_FLAG(LINK_SGR_DIM)));
+        } else if ((uCode > LINK_SGR_NORMAL_INTENSITY) && (uCode <= LINK_SGR_FLAG_OFF + LINK_SGR_LAST_FLAG)) {
+            psAttr->uFlags = (uint16_t)(psAttr->uFlags & ~LINK_FLAG(uCode - LINK_SGR_FLAG_OFF));
+            if (LINK_SGR_FLAG_OFF + LINK_SGR_BLINK == uCode) {
+                psAttr->uFlags = (uint16_t)(psAttr->uFlags & ~LINK_FLAG(LINK_SGR_RAPID_BLINK));
+            }
+        } else if (((uCode >= 30U) && (uCode <= 37U)) || ((uCode >= 90U) && (uCode <= 97U))) {
+            psAttr->uFg = (uint8_t)uCode;
+        } else if (LINK_SGR_DEFAULT_FG == uCode) {
+            psAttr->uFg = 0U;
+        } else if (((uCode >= 40U) && (uCode <= 47U)) || ((uCode >= 100U) && (uCode <= 107U))) {
+            psAttr->uBg = (uint8_t)uCode;
+        } else if (LINK_SGR_DEFAULT_BG == uCode) {
+            psAttr->uBg = 0U;
+        } else {
+            return false; /* 256 colours, RGB, fonts, ... */
+        }
+    } while (i < szLength);
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+/* true if the parameters of a SGR sequence start with a reset ("", "0", "0;...") */
+static bool link_sgr_resets(const char *pstrParams, size_t szLength) {
+    size_t i = 0U;
+    while ((i < szLength) && ('0' == pstrParams[i])) {
+        ++i;
+    }
+    return (i == szLength) || (';' == pstrParams[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+/* the CSI sequence in vSeq is complete: decide what it becomes */
+static void link_sequence(linkFilter_s *psFilter) {
+    const char *pstrParams = psFilter->vSeq + 2;
+    const size_t szParams = psFilter->szSeq - 3U;
+    const char cFinal = psFilter->vSeq[psFilter->szSeq - 1U];
+
+    if ('m' == cFinal) {
+        /* after attributes not decoded only a reset makes them known again, the others add to them */
+        linkAttr_s sAttr = (true == psFilter->bWantedRaw) ? linkAttr_s{} : psFilter->sWanted;
+        if (((false == psFilter->bWantedRaw) || (true == link_sgr_resets(pstrParams, szParams))) &&
+            (true == link_decode_sgr(pstrParams, szParams, &sAttr))) {
+            psFilter->sWanted = sAttr;
+            psFilter->bWantedRaw = false;
+        } else {
+            link_apply_attr(psFilter);
+            link_put(psFilter, psFilter->vSeq, psFilter->szSeq);
+            psFilter->bShownKnown = false;
+            psFilter->bWantedRaw = true;
+        }
+        return;
+    }
+    if ((3U == szParams) && (0 == memcmp(pstrParams, "?25", 3U)) && (('l' == cFinal) || ('h' == cFinal))) {
+        if ('l' == cFinal) {
+            psFilter->bHidePending = (false == psFilter->bHidden);
+        } else if (true == psFilter->bHidePending) {
+            link_put_raw(psFilter, psFilter->vHeld, psFilter->szHeld); /* hidden and shown again around one movement at most */
+            psFilter->szHeld = 0U;
+            psFilter->bHidePending = false;
+        } else if (true == psFilter->bHidden) {
+            link_put(psFilter, psFilter->vSeq, psFilter->szSeq);
+            psFilter->bHidden = false;
+        }
+        return;
+    }
+    unsigned int uCount = 0U;
+    size_t i = 0U;
+    while ((i < szParams) && (pstrParams[i] >= '0') && (pstrParams[i] <= '9') && (uCount < 10000U)) {
+        uCount = uCount * 10U + (unsigned int)(pstrParams[i++] - '0');
+    }
+    const bool bNumber = (i == szParams);
+    if (true == bNumber) {
+        uCount = (0U == uCount) ? 1U : uCount; /* 0 moves by 1 too */
+    }
+    switch (cFinal) {
+        case 'A':
+        case 'B':
+        case 'C':
+        case 'D': {
+            if (false == bNumber) {
+                link_move(psFilter, psFilter->vSeq, psFilter->szSeq);
+            } else if (('D' == cFinal) && (uCount <= LINK_MAX_BACKSPACES)) {
+                const char vBackspaces[LINK_MAX_BACKSPACES] = { LINK_BACKSPACE_CHAR, LINK_BACKSPACE_CHAR, LINK_BACKSPACE_CHAR };
+                link_move(psFilter, vBackspaces, uCount);
+            } else {
+                char vMove[LINK_FILTER_SEQ_LEN];
+                const int iLength = (1U == uCount) ? snprintf(vMove, sizeof(vMove), "\033[%c", cFinal) : snprintf(vMove, sizeof(vMove), "\033[%u%c", uCount, cFinal);
+                link_move(psFilter, vMove, (size_t)iLength);
+            }
+        } break;
+        case 'E':
+        case 'F':
+        case 'G':
+        case 'H':
+        case 'd':
+        case 'f': {
+            link_move(psFilter, psFilter->vSeq, psFilter->szSeq);
+        } break;
+        case 'J':
+        case 'K':
+        case 'X':
+        case 'P':
+        case '@':
+        case 'L':
+        case 'M': { /* the erased cells get the background colour */
+            link_apply_attr(psFilter);
+            link_put(psFilter, psFilter->vSeq, psFilter->szSeq);
+        } break;
+        default: {
+            link_put(psFilter, psFilter->vSeq, psFilter->szSeq);
+        } break;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+void link_filter_init(linkFilter_s *psFilter, PFLINKOUTPUT pfOutput, void *pvContext) {
+    memset(psFilter, 0, sizeof(*psFilter));
+    psFilter->pfOutput = pfOutput;
+    psFilter->pvContext = pvContext;
+    psFilter->uState = LINK_STATE_TEXT;
+    psFilter->bShownKnown = true; /* a terminal starts with the default attributes */
+}
+
+/*----------------------------------------------------------------------------*/
+void link_filter_write(linkFilter_s *psFilter, const char *pstrText, size_t szLength) {
+    psFilter->ullBytesIn += szLength;
+    for (size_t i = 0U; i < szLength; ++i) {
+        const char c = pstrText[i];
+        switch (psFilter->uState) {
+            case LINK_STATE_ESCAPE: {
+                if (LINK_CSI_CHAR == c) {
+                    psFilter->vSeq[psFilter->szSeq++] = c;
+                    psFilter->uState = LINK_STATE_CSI;
+                } else {
+                    link_put(psFilter, psFilter->vSeq, psFilter->szSeq); /* not decoded, passed */
+                    link_put(psFilter, &c, 1U);
+                    psFilter->uState = LINK_STATE_TEXT;
+                }
+            } break;
+            case LINK_STATE_CSI: {
+                psFilter->vSeq[psFilter->szSeq++] = c;
+                if ((c >= '@') && (c <= '~')) {
+                    link_sequence(psFilter);
+                    psFilter->uState = LINK_STATE_TEXT;
+                } else if (sizeof(psFilter->vSeq) == psFilter->szSeq) {
+                    link_put(psFilter, psFilter->vSeq, psFilter->szSeq); /* too long, the rest follows as text */
+                    psFilter->uState = LINK_STATE_TEXT;
+                }
+            } break;
+            default: {
+                if (LINK_ESCAPE_CHAR == c) {
+                    psFilter->vSeq[0] = c;
+                    psFilter->szSeq = 1U;
+                    psFilter->uState = LINK_STATE_ESCAPE;
+                } else {
+                    if (((unsigned char)c >= 0x20U) && (0x7F != c)) {
+                        link_apply_attr(psFilter);
+                    }
+                    link_put(psFilter, &c, 1U);
+                }
+            } break;
+        }
+    }
+    link_emit(psFilter);
+}
+
+/*----------------------------------------------------------------------------*/
+void link_filter_flush(linkFilter_s *psFilter) {
+    link_apply_attr(psFilter);
+    link_release(psFilter);
+    if (true == psFilter->bHidePending) {
+        link_send_hide(psFilter);
+    }
+    if (LINK_STATE_TEXT != psFilter->uState) {
+        link_put(psFilter, psFilter->vSeq, psFilter->szSeq);
+        psFilter->uState = LINK_STATE_TEXT;
+    }
+    link_emit(psFilter);
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_LINK_FILTER) */
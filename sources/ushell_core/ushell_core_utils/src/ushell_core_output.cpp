@@ -0,0 +1,179 @@
+#include "ushell_core_output.h"
+
+#if (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+
+#include "ushell_core_printout.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+    #define OUTPUT_PUTCH(c) _putch(c)
+#else
+    #define OUTPUT_PUTCH(c) putchar(c)
+#endif
+
+#define OUTPUT_ARENA_INITIAL_SIZE   (1024U)
+#define OUTPUT_CALLBACK_CHUNK       (256U)
+
+/* sink of the calling thread, nullptr: the terminal */
+static thread_local outputSink_s *g_psSink = nullptr;
+
+/*----------------------------------------------------------------------------*/
+static bool output_grow(outputSink_s *psSink, size_t szNeeded) {
+    size_t szSize = (0U == psSink->szSize) ? OUTPUT_ARENA_INITIAL_SIZE : psSink->szSize;
+    while (szSize < szNeeded) {
+        szSize *= 2U;
+    }
+    char *pBuffer = (char *)realloc(psSink->pBuffer, szSize);
+    if (nullptr == pBuffer) {
+        return false;
+    }
+    psSink->pBuffer = pBuffer;
+    psSink->szSize = szSize;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+static int output_write(outputSink_s *psSink, const char *format, va_list args) {
+    va_list argsRetry;
+    va_copy(argsRetry, args);
+    int iLength = 0;
+
+    if (nullptr != psSink->pfOutput) {
+        char vChunk[OUTPUT_CALLBACK_CHUNK];
+        iLength = vsnprintf(vChunk, sizeof(vChunk), format, args);
+        if ((iLength >= 0) && ((size_t)iLength < sizeof(vChunk))) {
+            psSink->pfOutput(vChunk, (size_t)iLength, psSink->pvContext);
+        } else if (iLength > 0) {
+            char *pstrText = (char *)malloc((size_t)iLength + 1U);
+            if (nullptr != pstrText) {
+                vsnprintf(pstrText, (size_t)iLength + 1U, format, argsRetry);
+                psSink->pfOutput(pstrText, (size_t)iLength, psSink->pvContext);
+                free(pstrText);
+            }
+        }
+    } else {
+        size_t szFree = psSink->szSize - psSink->szLength;
+        iLength = vsnprintf((0U != szFree) ? (psSink->pBuffer + psSink->szLength) : nullptr, szFree, format, args);
+        if (iLength > 0) {
+            if ((size_t)iLength < szFree) {
+                psSink->szLength += (size_t)iLength;
+            } else if ((true == psSink->bGrowable) && (true == output_grow(psSink, psSink->szLength + (size_t)iLength + 1U))) {
+                vsnprintf(psSink->pBuffer + psSink->szLength, (size_t)iLength + 1U, format, argsRetry);
+                psSink->szLength += (size_t)iLength;
+            } else if (0U != psSink->szSize) {
+                psSink->szLength = psSink->szSize - 1U;
+                psSink->bTruncated = true;
+            } else {
+                psSink->bTruncated = true;
+            }
+        }
+    }
+
+    va_end(argsRetry);
+    return iLength;
+}
+
+/*----------------------------------------------------------------------------*/
+int ushell_vprintf(const char *format, va_list args) {
+    return (nullptr == g_psSink) ? vprintf(format, args) : output_write(g_psSink, format, args);
+}
+
+/*----------------------------------------------------------------------------*/
+int ushell_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int iLength = ushell_vprintf(format, args);
+    va_end(args);
+    return iLength;
+}
+
+/*----------------------------------------------------------------------------*/
+int ushell_putch(int c) {
+    return (nullptr == g_psSink) ? OUTPUT_PUTCH(c) : ushell_printf("%c", c);
+}
+
+/*----------------------------------------------------------------------------*/
+outputSink_s output_sink_buffer(char *pBuffer, size_t szSize) {
+    outputSink_s sSink = {};
+    sSink.pBuffer = pBuffer;
+    sSink.szSize = (nullptr != pBuffer) ? szSize : 0U;
+    if (0U != sSink.szSize) {
+        pBuffer[0] = '\0';
+    }
+    return sSink;
+}
+
+/*----------------------------------------------------------------------------*/
+outputSink_s output_sink_arena(void) {
+    outputSink_s sSink = {};
+    sSink.bGrowable = true;
+    return sSink;
+}
+
+/*----------------------------------------------------------------------------*/
+outputSink_s output_sink_callback(PFOUTPUT pfOutput, void *pvContext) {
+    outputSink_s sSink = {};
+    sSink.pfOutput = pfOutput;
+    sSink.pvContext = pvContext;
+    return sSink;
+}
+
+/*----------------------------------------------------------------------------*/
+void output_sink_reset(outputSink_s *psSink) {
+    psSink->szLength = 0U;
+    psSink->bTruncated = false;
+    if (0U != psSink->szSize) {
+        psSink->pBuffer[0] = '\0';
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+void output_sink_release(outputSink_s *psSink) {
+    if (true == psSink->bGrowable) {
+        free(psSink->pBuffer);
+        psSink->pBuffer = nullptr;
+        psSink->szSize = 0U;
+    }
+    psSink->szLength = 0U;
+}
+
+/*----------------------------------------------------------------------------*/
+int output_sink_printf(outputSink_s *psSink, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int iLength = output_write(psSink, format, args);
+    va_end(args);
+    return iLength;
+}
+
+/*----------------------------------------------------------------------------*/
+bool output_sink_write(outputSink_s *psSink, const void *pvData, size_t szLength) {
+    if (nullptr != psSink->pfOutput) {
+        psSink->pfOutput((const char *)pvData, szLength, psSink->pvContext);
+        return true;
+    }
+    if ((psSink->szLength + szLength >= psSink->szSize) &&
+        ((false == psSink->bGrowable) || (false == output_grow(psSink, psSink->szLength + szLength + 1U)))) {
+        szLength = (0U != psSink->szSize) ? (psSink->szSize - 1U - psSink->szLength) : 0U;
+        psSink->bTruncated = true;
+    }
+    if (0U != szLength) {
+        memcpy(psSink->pBuffer + psSink->szLength, pvData, szLength);
+        psSink->szLength += szLength;
+        psSink->pBuffer[psSink->szLength] = '\0';
+    }
+    return (false == psSink->bTruncated);
+}
+
+/*----------------------------------------------------------------------------*/
+outputSink_s *output_redirect(outputSink_s *psSink) {
+    outputSink_s *psPrevSink = g_psSink;
+    g_psSink = psSink;
+    return psPrevSink;
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
@@ -0,0 +1,86 @@
+#include "ushell_core_reader.h"
+
+#if (1 == uSHELL_SUPPORTS_READER)
+
+#include "ushell_core_keys.h"
+#include "ushell_core_printout.h"
+
+#include <limits.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+    #include <unistd.h>
+    #define READER_INPUT_IS_TERMINAL()  (1 == isatty(STDIN_FILENO))
+#elif (defined(__MINGW32__) || defined(_MSC_VER))
+    #include <io.h>
+    #define READER_INPUT_IS_TERMINAL()  (0 != _isatty(_fileno(stdin)))
+#else /* serial terminal */
+    #define READER_INPUT_IS_TERMINAL()  (true)
+#endif
+
+/*----------------------------------------------------------------------------*/
+int ushell_read(reader_t *psReader, void *pvBuffer, size_t szSize) {
+    if ((nullptr == psReader) || (true == psReader->bEnd)) {
+        return 0;
+    }
+    if (szSize > (size_t)INT_MAX) {
+        szSize = (size_t)INT_MAX;
+    }
+
+    if (nullptr != psReader->pFile) {
+        size_t szRead = fread(pvBuffer, 1, szSize, psReader->pFile);
+        if (szRead < szSize) {
+            psReader->bEnd = true;
+            if ((0U == szRead) && (0 != ferror(psReader->pFile))) {
+                return -1;
+            }
+        }
+        return (int)szRead;
+    }
+
+    uint8_t *pBuffer = (uint8_t *)pvBuffer;
+    size_t szRead = 0;
+    while (szRead < szSize) {
+        int iKey = (int)uSHELL_GETCH();
+        if ((EOF == iKey) || (uSHELL_KEY_CTRL_D == iKey)) {
+            psReader->bEnd = true;
+            break;
+        }
+        if (true == psReader->bInteractive) {
+            if ('\r' == iKey) {
+                iKey = '\n';
+            }
+            uSHELL_PUTCH((char)iKey);
+        }
+        pBuffer[szRead++] = (uint8_t)iKey;
+        if ((true == psReader->bInteractive) && ('\n' == iKey)) {
+            break; /* hand over what was typed so far */
+        }
+    }
+    return (int)szRead;
+}
+
+/*----------------------------------------------------------------------------*/
+void reader_open_input(reader_t *psReader) {
+    psReader->pFile = nullptr;
+    psReader->bInteractive = READER_INPUT_IS_TERMINAL();
+    psReader->bEnd = false;
+}
+
+/*----------------------------------------------------------------------------*/
+bool reader_open_file(reader_t *psReader, const char *pstrPath) {
+    reader_open_input(psReader);
+    psReader->pFile = fopen(pstrPath, "rb");
+    return (nullptr != psReader->pFile);
+}
+
+/*----------------------------------------------------------------------------*/
+void reader_close(reader_t *psReader) {
+    if (nullptr != psReader->pFile) {
+        fclose(psReader->pFile);
+        psReader->pFile = nullptr;
+    }
+    psReader->bEnd = true;
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_READER) */
@@ -0,0 +1,486 @@
+#include "ushell_core_server.h"
+
+#if (1 == uSHELL_SUPPORTS_SERVER_MODE)
+
+#include "ushell_core_keys.h"
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+#include "ushell_core_cancel.h"
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define SERVER_MAX_EVENTS          (32)
+#define SERVER_LISTEN_BACKLOG      (16)
+#define SERVER_RX_CHUNK            (4096U)
+#define SERVER_HISTORY_DEPTH       (16U)
+#define SERVER_TX_HIGH_WATERMARK   (256U * 1024U)  /* pending output: the client is not read anymore */
+#define SERVER_TX_LOW_WATERMARK    (16U * 1024U)   /* pending output: the client is read again */
+#define SERVER_TX_KEEP_SIZE        (64U * 1024U)   /* larger arenas are freed once sent */
+
+#define SERVER_KEY_CTRL_C          (0x03)
+#define SERVER_KEY_CTRL_H          (0x08)
+#define SERVER_HISTORY_RECALL      '!'
+
+/* the escape sequences (arrows, function keys) of raw clients are dropped */
+enum { SERVER_ESC_NONE, SERVER_ESC_START, SERVER_ESC_SEQUENCE };
+
+typedef struct {
+    int          iFd;
+    unsigned int uSlot;
+    uint32_t     uEvents;       /* registered in the epoll set */
+    bool         bEof;          /* the client sends nothing more */
+    bool         bQuit;         /* closed once the output is sent */
+    bool         bDiscard;      /* line too long, dropped up to its end */
+    bool         bSkipLf;       /* '\n' or '\0' following a '\r' */
+    int          iEscape;
+    size_t       szLineLen;
+    char         vLine[uSHELL_MAX_INPUT_BUF_LEN];
+    size_t       szRxStart;     /* received, not processed yet (paused above the high watermark) */
+    size_t       szRxEnd;
+    char         vRx[SERVER_RX_CHUNK];
+    unsigned int uNrHistory;    /* lines written, the last SERVER_HISTORY_DEPTH are kept */
+    char         vHistory[SERVER_HISTORY_DEPTH][uSHELL_MAX_INPUT_BUF_LEN];
+    outputSink_s sTx;           /* arena, [szTxSent, szLength) is not sent yet */
+    size_t       szTxSent;
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    frameAssembler_s sFrames;
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+} serverClient_s;
+
+typedef struct {
+    const serverConfig_s *psConfig;
+    int             iEpollFd;
+    int             iListenFd;
+    unsigned int    uNrClients;
+    serverClient_s *vpsClients[uSHELL_SERVER_MAX_CLIENTS];
+} server_s;
+
+/* written by the signal handler, read by the loop: the stop requests of any thread */
+static int g_viStopPipe[2] = { -1, -1 };
+
+/*----------------------------------------------------------------------------*/
+static void server_on_signal(int iSignal) {
+    const int iErrno = errno;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    (void)ushell_cancel_interrupt(); /* the command of a client returns before the loop stops */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+    char cSignal = (char)iSignal;
+    (void)!write(g_viStopPipe[1], &cSignal, 1U);
+    errno = iErrno;
+}
+
+/*----------------------------------------------------------------------------*/
+static size_t server_pending(const serverClient_s *psClient) {
+    return psClient->sTx.szLength - psClient->szTxSent;
+}
+
+/*----------------------------------------------------------------------------*/
+static bool server_watch(server_s *psServer, int iFd, void *pvData, uint32_t uEvents, int iOperation) {
+    struct epoll_event sEvent = {};
+    sEvent.events = uEvents;
+    sEvent.data.ptr = pvData;
+    return (0 == epoll_ctl(psServer->iEpollFd, iOperation, iFd, &sEvent));
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_close_client(server_s *psServer, serverClient_s *psClient) {
+    epoll_ctl(psServer->iEpollFd, EPOLL_CTL_DEL, psClient->iFd, nullptr);
+    close(psClient->iFd);
+    psServer->vpsClients[psClient->uSlot] = nullptr;
+    --psServer->uNrClients;
+    output_sink_release(&psClient->sTx);
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    frame_assembler_release(&psClient->sFrames);
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+    free(psClient);
+}
+
+/*----------------------------------------------------------------------------*/
+static bool server_flush(serverClient_s *psClient) {
+    while (server_pending(psClient) > 0U) {
+        ssize_t lSent = send(psClient->iFd, psClient->sTx.pBuffer + psClient->szTxSent, server_pending(psClient), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (lSent < 0) {
+            return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno));
+        }
+        psClient->szTxSent += (size_t)lSent;
+    }
+    if (psClient->sTx.szSize > SERVER_TX_KEEP_SIZE) {
+        output_sink_release(&psClient->sTx);
+    } else {
+        output_sink_reset(&psClient->sTx);
+    }
+    psClient->szTxSent = 0U;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_prompt(server_s *psServer, serverClient_s *psClient) {
+    if ((nullptr != psServer->psConfig->pstrPrompt) && (false == psClient->bQuit)) {
+        output_sink_printf(&psClient->sTx, "%s", psServer->psConfig->pstrPrompt);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_history_add(serverClient_s *psClient, const char *pstrLine) {
+    if ((0U != psClient->uNrHistory) && (0 == strcmp(psClient->vHistory[(psClient->uNrHistory - 1U) % SERVER_HISTORY_DEPTH], pstrLine))) {
+        return;
+    }
+    strcpy(psClient->vHistory[psClient->uNrHistory % SERVER_HISTORY_DEPTH], pstrLine);
+    ++psClient->uNrHistory;
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_history_show(serverClient_s *psClient) {
+    unsigned int uFirst = (psClient->uNrHistory > SERVER_HISTORY_DEPTH) ? (psClient->uNrHistory - SERVER_HISTORY_DEPTH) : 0U;
+    for (unsigned int i = uFirst; i < psClient->uNrHistory; ++i) {
+        output_sink_printf(&psClient->sTx, "%5u  %s\n", i + 1U, psClient->vHistory[i % SERVER_HISTORY_DEPTH]);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* "!!": the last line, "!N": the line N of the history list */
+static const char *server_history_recall(serverClient_s *psClient, const char *pstrLine) {
+    unsigned long ulIndex = psClient->uNrHistory;
+    if (0 != strcmp(pstrLine + 1, "!")) {
+        char *pstrEnd = nullptr;
+        ulIndex = strtoul(pstrLine + 1, &pstrEnd, 10);
+        if ((pstrEnd == pstrLine + 1) || ('\0' != *pstrEnd)) {
+            ulIndex = 0UL;
+        }
+    }
+    if ((0UL == ulIndex) || (ulIndex > psClient->uNrHistory) || (ulIndex + SERVER_HISTORY_DEPTH <= psClient->uNrHistory)) {
+        return nullptr;
+    }
+    return psClient->vHistory[(ulIndex - 1UL) % SERVER_HISTORY_DEPTH];
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_run_line(server_s *psServer, serverClient_s *psClient) {
+    const bool bDiscard = psClient->bDiscard;
+    char *pstrLine = psClient->vLine;
+    pstrLine[psClient->szLineLen] = '\0';
+    psClient->szLineLen = 0U;
+    psClient->bDiscard = false;
+
+    if (true == bDiscard) {
+        output_sink_printf(&psClient->sTx, "line longer than %u characters dropped\n", (unsigned int)(uSHELL_MAX_INPUT_BUF_LEN - 2U));
+        server_prompt(psServer, psClient);
+        return;
+    }
+
+    pstrLine += strspn(pstrLine, " \t");
+    if (SERVER_HISTORY_RECALL == *pstrLine) {
+        const char *pstrEntry = server_history_recall(psClient, pstrLine);
+        if (nullptr == pstrEntry) {
+            output_sink_printf(&psClient->sTx, "%s: event not found\n", pstrLine);
+            server_prompt(psServer, psClient);
+            return;
+        }
+        pstrLine = strcpy(psClient->vLine, pstrEntry); /* the history slot may be reused by the add */
+        output_sink_printf(&psClient->sTx, "%s\n", pstrLine);
+    }
+
+    if ((0 == strcmp(pstrLine, "quit")) || (0 == strcmp(pstrLine, "exit"))) {
+        psClient->bQuit = true;
+    } else if (0 == strcmp(pstrLine, "history")) {
+        server_history_show(psClient);
+    } else if ('\0' != *pstrLine) {
+        server_history_add(psClient, pstrLine);
+        psServer->psConfig->pfExec(pstrLine, &psClient->sTx, psServer->psConfig->pvContext);
+    }
+    server_prompt(psServer, psClient);
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_edit_line(server_s *psServer, serverClient_s *psClient, char cKey) {
+    if (true == psClient->bSkipLf) {
+        psClient->bSkipLf = false;
+        if (('\n' == cKey) || ('\0' == cKey)) {
+            return;
+        }
+    }
+    if (SERVER_ESC_NONE != psClient->iEscape) {
+        if ((SERVER_ESC_START == psClient->iEscape) && (('[' == cKey) || ('O' == cKey))) {
+            psClient->iEscape = SERVER_ESC_SEQUENCE;
+        } else if ((SERVER_ESC_START == psClient->iEscape) || ((cKey >= 0x40) && (cKey <= 0x7E))) {
+            psClient->iEscape = SERVER_ESC_NONE;
+        }
+        return;
+    }
+
+    switch (cKey) {
+        case '\r':
+            psClient->bSkipLf = true;
+            server_run_line(psServer, psClient);
+            break;
+        case '\n':
+            server_run_line(psServer, psClient);
+            break;
+        case uSHELL_KEY_BACKSPACE:
+        case SERVER_KEY_CTRL_H:
+            if (psClient->szLineLen > 0U) {
+                --psClient->szLineLen;
+            }
+            break;
+        case uSHELL_KEY_CTRL_U:
+            psClient->szLineLen = 0U;
+            psClient->bDiscard = false;
+            break;
+        case SERVER_KEY_CTRL_C:
+            psClient->szLineLen = 0U;
+            psClient->bDiscard = false;
+            output_sink_printf(&psClient->sTx, "^C\n");
+            server_prompt(psServer, psClient);
+            break;
+        case uSHELL_KEY_CTRL_D:
+            psClient->bQuit = (0U == psClient->szLineLen);
+            break;
+        case uSHELL_KEY_ESCAPE:
+            psClient->iEscape = SERVER_ESC_START;
+            break;
+        default:
+            if (uSHELL_KEY_TAB == cKey) {
+                cKey = ' ';
+            }
+            if ((unsigned char)cKey < 0x20U) {
+                break;
+            }
+            if (psClient->szLineLen < (uSHELL_MAX_INPUT_BUF_LEN - 2U)) {
+                psClient->vLine[psClient->szLineLen++] = cKey;
+            } else {
+                psClient->bDiscard = true;
+            }
+            break;
+    }
+}
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+/*----------------------------------------------------------------------------*/
+/* binary clients: a malformed stream disconnects the client */
+static void server_process_frames(server_s *psServer, serverClient_s *psClient) {
+    while ((psClient->szRxStart < psClient->szRxEnd) && (false == psClient->bQuit) && (server_pending(psClient) < SERVER_TX_HIGH_WATERMARK)) {
+        const uint8_t *pData = (const uint8_t *)psClient->vRx + psClient->szRxStart;
+        size_t szAvail = psClient->szRxEnd - psClient->szRxStart;
+        int iStatus = frame_feed(&psClient->sFrames, &pData, &szAvail);
+        psClient->szRxStart = psClient->szRxEnd - szAvail;
+        if (iStatus < 0) {
+            psClient->bQuit = true;
+        } else if (iStatus > 0) {
+            psServer->psConfig->pfFrame(psClient->sFrames.pFrame, psClient->sFrames.szLength, &psClient->sTx, psServer->psConfig->pvContext);
+        }
+    }
+    if (psClient->szRxStart == psClient->szRxEnd) {
+        psClient->szRxStart = psClient->szRxEnd = 0U;
+    }
+}
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
+/*----------------------------------------------------------------------------*/
+/* the received bytes are processed until the output reaches the high watermark */
+static void server_process_input(server_s *psServer, serverClient_s *psClient) {
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    if (nullptr != psServer->psConfig->pfFrame) {
+        server_process_frames(psServer, psClient);
+        return;
+    }
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+    while ((psClient->szRxStart < psClient->szRxEnd) && (false == psClient->bQuit) && (server_pending(psClient) < SERVER_TX_HIGH_WATERMARK)) {
+        server_edit_line(psServer, psClient, psClient->vRx[psClient->szRxStart++]);
+    }
+    if (psClient->szRxStart == psClient->szRxEnd) {
+        psClient->szRxStart = psClient->szRxEnd = 0U;
+        if ((true == psClient->bEof) && (false == psClient->bQuit) && ((0U != psClient->szLineLen) || (true == psClient->bDiscard))) {
+            server_run_line(psServer, psClient); /* last line without '\n' */
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+static bool server_receive(serverClient_s *psClient) {
+    ssize_t lRead = recv(psClient->iFd, psClient->vRx + psClient->szRxEnd, sizeof(psClient->vRx) - psClient->szRxEnd, MSG_DONTWAIT);
+    if (lRead > 0) {
+        psClient->szRxEnd += (size_t)lRead;
+    } else if (0 == lRead) {
+        psClient->bEof = true;
+    } else {
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno));
+    }
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_service_client(server_s *psServer, serverClient_s *psClient, uint32_t uEvents) {
+    bool bOk = true;
+    if (0U != (uEvents & EPOLLIN)) {
+        bOk = server_receive(psClient);
+    } else if (0U != (uEvents & (EPOLLERR | EPOLLHUP))) {
+        bOk = false;
+    }
+
+    while (true == bOk) {
+        if (server_pending(psClient) <= SERVER_TX_LOW_WATERMARK) {
+            server_process_input(psServer, psClient);
+        }
+        bOk = server_flush(psClient);
+        if ((psClient->szRxStart == psClient->szRxEnd) || (true == psClient->bQuit) || (server_pending(psClient) > SERVER_TX_LOW_WATERMARK)) {
+            break;
+        }
+    }
+
+    const bool bInputDone = (true == psClient->bQuit) || ((true == psClient->bEof) && (psClient->szRxStart == psClient->szRxEnd));
+    if ((false == bOk) || ((true == bInputDone) && (0U == server_pending(psClient)))) {
+        server_close_client(psServer, psClient);
+        return;
+    }
+
+    /* back-pressure: the client is not read while its output is above the watermark */
+    uint32_t uWanted = (server_pending(psClient) > 0U) ? (uint32_t)EPOLLOUT : 0U;
+    if ((false == bInputDone) && (psClient->szRxStart == psClient->szRxEnd) && (server_pending(psClient) <= SERVER_TX_LOW_WATERMARK)) {
+        uWanted |= EPOLLIN;
+    }
+    if (uWanted != psClient->uEvents) {
+        psClient->uEvents = uWanted;
+        if (false == server_watch(psServer, psClient->iFd, psClient, uWanted, EPOLL_CTL_MOD)) {
+            server_close_client(psServer, psClient);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+static void server_accept(server_s *psServer) {
+    int iFd = -1;
+    while ((iFd = accept4(psServer->iListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        unsigned int uSlot = 0U;
+        while ((uSlot < uSHELL_SERVER_MAX_CLIENTS) && (nullptr != psServer->vpsClients[uSlot])) {
+            ++uSlot;
+        }
+        serverClient_s *psClient = (uSlot < uSHELL_SERVER_MAX_CLIENTS) ? (serverClient_s *)calloc(1U, sizeof(serverClient_s)) : nullptr;
+        if (nullptr == psClient) {
+            static const char strBusy[] = "too many clients\n";
+            (void)!send(iFd, strBusy, sizeof(strBusy) - 1U, MSG_NOSIGNAL | MSG_DONTWAIT);
+            close(iFd);
+            continue;
+        }
+        psClient->iFd = iFd;
+        psClient->uSlot = uSlot;
+        psClient->uEvents = EPOLLIN;
+        psClient->sTx = output_sink_arena();
+        psServer->vpsClients[uSlot] = psClient;
+        ++psServer->uNrClients;
+        if (false == server_watch(psServer, iFd, psClient, EPOLLIN, EPOLL_CTL_ADD)) {
+            server_close_client(psServer, psClient);
+            continue;
+        }
+        server_prompt(psServer, psClient);
+        server_service_client(psServer, psClient, 0U);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* only a stale socket is replaced: not another file, nor the socket of a running server */
+static int server_listen(const char *pstrPath) {
+    struct sockaddr_un sAddress = {};
+    struct stat sStat = {};
+    const bool bExists = (0 == lstat(pstrPath, &sStat));
+    if ((strlen(pstrPath) >= sizeof(sAddress.sun_path)) || ((true == bExists) && !S_ISSOCK(sStat.st_mode))) {
+        return -1;
+    }
+    sAddress.sun_family = AF_UNIX;
+    strcpy(sAddress.sun_path, pstrPath);
+
+    int iFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (iFd < 0) {
+        return -1;
+    }
+    if (0 == connect(iFd, (const struct sockaddr *)&sAddress, sizeof(sAddress))) {
+        close(iFd);
+        return -1;
+    }
+    if (true == bExists) {
+        unlink(pstrPath);
+    }
+    if ((0 != bind(iFd, (const struct sockaddr *)&sAddress, sizeof(sAddress))) ||
+        (0 != listen(iFd, SERVER_LISTEN_BACKLOG)) ||
+        (0 != fcntl(iFd, F_SETFL, fcntl(iFd, F_GETFL) | O_NONBLOCK))) {
+        close(iFd);
+        return -1;
+    }
+    return iFd;
+}
+
+/*----------------------------------------------------------------------------*/
+bool server_run(const serverConfig_s *psConfig) {
+    server_s sServer = {};
+    sServer.psConfig = psConfig;
+    sServer.iListenFd = server_listen(psConfig->pstrPath);
+    sServer.iEpollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    bool bOk = (sServer.iListenFd >= 0) && (sServer.iEpollFd >= 0) && (0 == pipe2(g_viStopPipe, O_CLOEXEC | O_NONBLOCK)) &&
+               server_watch(&sServer, sServer.iListenFd, &sServer.iListenFd, EPOLLIN, EPOLL_CTL_ADD) &&
+               server_watch(&sServer, g_viStopPipe[0], g_viStopPipe, EPOLLIN, EPOLL_CTL_ADD);
+
+    struct sigaction sAction = {};
+    struct sigaction sPrevInt = {};
+    struct sigaction sPrevTerm = {};
+    sAction.sa_handler = server_on_signal;
+    sAction.sa_flags = SA_RESTART;
+    sigemptyset(&sAction.sa_mask);
+    const bool bHandlesSignals = bOk;
+    if (true == bHandlesSignals) {
+        sigaction(SIGINT, &sAction, &sPrevInt);
+        sigaction(SIGTERM, &sAction, &sPrevTerm);
+    }
+
+    struct epoll_event vsEvents[SERVER_MAX_EVENTS];
+    bool bRunning = bOk;
+    while (true == bRunning) {
+        int iNrEvents = epoll_wait(sServer.iEpollFd, vsEvents, SERVER_MAX_EVENTS, -1);
+        if ((iNrEvents < 0) && (EINTR != errno)) {
+            bOk = bRunning = false;
+        }
+        for (int i = 0; i < iNrEvents; ++i) {
+            void *pvData = vsEvents[i].data.ptr;
+            if (pvData == &sServer.iListenFd) {
+                server_accept(&sServer);
+            } else if (pvData == g_viStopPipe) {
+                bRunning = false;
+            } else {
+                server_service_client(&sServer, (serverClient_s *)pvData, vsEvents[i].events);
+            }
+        }
+    }
+
+    for (unsigned int i = 0U; i < uSHELL_SERVER_MAX_CLIENTS; ++i) {
+        if (nullptr != sServer.vpsClients[i]) {
+            server_close_client(&sServer, sServer.vpsClients[i]);
+        }
+    }
+    if (-1 != g_viStopPipe[0]) {
+        if (true == bHandlesSignals) {
+            sigaction(SIGINT, &sPrevInt, nullptr);
+            sigaction(SIGTERM, &sPrevTerm, nullptr);
+        }
+        close(g_viStopPipe[0]);
+        close(g_viStopPipe[1]);
+        g_viStopPipe[0] = g_viStopPipe[1] = -1;
+    }
+    if (sServer.iEpollFd >= 0) {
+        close(sServer.iEpollFd);
+    }
+    if (sServer.iListenFd >= 0) {
+        close(sServer.iListenFd);
+        unlink(psConfig->pstrPath);
+    }
+    return bOk;
+}
+
+#endif /* (1 == uSHELL_SUPPORTS_SERVER_MODE) */
@@ -0,0 +1,200 @@
+#include "ushell_core_txring.h"
+
+#if (1 == uSHELL_SUPPORTS_TX_RING)
+
+#include "ushell_core_atomic.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* waiting for the consumer (TX_RING_BLOCK, tx_ring_flush()) */
+#if !defined(uSHELL_TX_RING_IDLE)
+    #if defined(SERIAL_TERMINAL)
+        #define uSHELL_TX_RING_IDLE()      /* busy wait, the interrupt drains the ring */
+    #else
+        #include <chrono>
+        #include <thread>
+        #define TX_RING_IDLE_US            (100)
+        #define uSHELL_TX_RING_IDLE()      std::this_thread::sleep_for(std::chrono::microseconds(TX_RING_IDLE_US))
+    #endif /* defined(SERIAL_TERMINAL) */
+#endif /* !defined(uSHELL_TX_RING_IDLE) */
+
+/*----------------------------------------------------------------------------*/
+bool tx_ring_init(txRing_s *psRing, uint8_t *pBuffer, size_t szSize) {
+    memset(psRing, 0, sizeof(*psRing));
+    if ((nullptr == pBuffer) || (szSize < 2U) || (0U != (szSize & (szSize - 1U)))) {
+        return false;
+    }
+    psRing->pBuffer = pBuffer;
+    psRing->szMask = szSize - 1U;
+    psRing->szHighWatermark = szSize - szSize / 4U;
+    psRing->szLowWatermark = szSize / 4U;
+    psRing->ePolicy = TX_RING_BLOCK;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+/* room left for the producer, the index of the consumer is only reloaded when the cached one is short */
+static size_t tx_ring_room(txRing_s *psRing, size_t szWanted) {
+    size_t szRoom = psRing->szMask + 1U - (psRing->szHead - psRing->szTailCache);
+    if (szRoom < szWanted) {
+        psRing->szTailCache = uSHELL_LOAD_ACQUIRE(&psRing->szTail);
+        szRoom = psRing->szMask + 1U - (psRing->szHead - psRing->szTailCache);
+    }
+    return szRoom;
+}
+
+/*----------------------------------------------------------------------------*/
+/* copy and publish szLength bytes (they fit), then report the high watermark and start the transmission */
+static void tx_ring_push(txRing_s *psRing, const uint8_t *pData, size_t szLength) {
+    const size_t szStart = psRing->szHead & psRing->szMask;
+    const size_t szFirst = (szLength < psRing->szMask + 1U - szStart) ? szLength : (psRing->szMask + 1U - szStart);
+    memcpy(psRing->pBuffer + szStart, pData, szFirst);
+    memcpy(psRing->pBuffer, pData + szFirst, szLength - szFirst);
+    uSHELL_STORE_RELEASE(&psRing->szHead, psRing->szHead + szLength);
+
+    if ((nullptr != psRing->pfWatermark) && (psRing->uHighEvents == uSHELL_LOAD_ACQUIRE(&psRing->uLowEvents)) &&
+        (psRing->szHead - uSHELL_LOAD_ACQUIRE(&psRing->szTail) >= psRing->szHighWatermark)) {
+        psRing->pfWatermark(psRing, TX_RING_HIGH_WATERMARK, psRing->pvContext);
+        uSHELL_STORE_RELEASE(&psRing->uHighEvents, psRing->uHighEvents + 1U); /* after the callback: no low event before it */
+    }
+    if (nullptr != psRing->pfKick) {
+        psRing->pfKick(psRing, psRing->pvContext);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+size_t tx_ring_write(txRing_s *psRing, const void *pvData, size_t szLength) {
+    const uint8_t *pData = (const uint8_t *)pvData;
+    size_t szRoom = tx_ring_room(psRing, szLength);
+
+    switch (psRing->ePolicy) {
+        case TX_RING_DROP: {
+            if (szRoom < szLength) {
+                psRing->uDropped += (uint32_t)szLength;
+                return 0U;
+            }
+        } break;
+        case TX_RING_TRUNCATE: {
+            if (szRoom < szLength) {
+                psRing->uDropped += (uint32_t)(szLength - szRoom);
+                szLength = szRoom;
+            }
+        } break;
+        default: { /* TX_RING_BLOCK: the bytes which fit, then wait for the room of the next ones */
+            size_t szWritten = 0U;
+            if (szRoom < szLength) {
+                ++psRing->uBlocked;
+            }
+            while (szWritten < szLength) {
+                if (0U == szRoom) {
+                    uSHELL_TX_RING_IDLE();
+                } else {
+                    const size_t szChunk = (szRoom < szLength - szWritten) ? szRoom : (szLength - szWritten);
+                    tx_ring_push(psRing, pData + szWritten, szChunk);
+                    szWritten += szChunk;
+                }
+                szRoom = tx_ring_room(psRing, szLength - szWritten);
+            }
+            return szWritten;
+        }
+    }
+    if (0U != szLength) {
+        tx_ring_push(psRing, pData, szLength);
+    }
+    return szLength;
+}
+
+/*----------------------------------------------------------------------------*/
+size_t tx_ring_pending(txRing_s *psRing) {
+    return psRing->szHead - uSHELL_LOAD_ACQUIRE(&psRing->szTail);
+}
+
+/*----------------------------------------------------------------------------*/
+void tx_ring_flush(txRing_s *psRing) {
+    while (0U != tx_ring_pending(psRing)) {
+        uSHELL_TX_RING_IDLE();
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+size_t tx_ring_peek(txRing_s *psRing, const uint8_t **ppData) {
+    const size_t szAvail = uSHELL_LOAD_ACQUIRE(&psRing->szHead) - psRing->szTail;
+    const size_t szStart = psRing->szTail & psRing->szMask;
+    *ppData = psRing->pBuffer + szStart;
+    return (szAvail < psRing->szMask + 1U - szStart) ? szAvail : (psRing->szMask + 1U - szStart);
+}
+
+/*----------------------------------------------------------------------------*/
+void tx_ring_consume(txRing_s *psRing, size_t szLength) {
+    uSHELL_STORE_RELEASE(&psRing->szTail, psRing->szTail + szLength);
+    if ((nullptr != psRing->pfWatermark) && (uSHELL_LOAD_ACQUIRE(&psRing->uHighEvents) != psRing->uLowEvents) &&
+        (uSHELL_LOAD_ACQUIRE(&psRing->szHead) - psRing->szTail <= psRing->szLowWatermark)) {
+        psRing->pfWatermark(psRing, TX_RING_LOW_WATERMARK, psRing->pvContext);
+        uSHELL_STORE_RELEASE(&psRing->uLowEvents, psRing->uLowEvents + 1U);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+int tx_ring_getc(txRing_s *psRing) {
+    const uint8_t *pData = nullptr;
+    if (0U == tx_ring_peek(psRing, &pData)) {
+        return -1;
+    }
+    const uint8_t uByte = *pData;
+    tx_ring_consume(psRing, 1U);
+    return uByte;
+}
+
+#if defined(SERIAL_TERMINAL)
+
+#include "ushell_core_printout.h"
+
+#if !defined(uSHELL_TX_VSNPRINTF)
+    #define uSHELL_TX_VSNPRINTF        vsnprintf
+#endif /* !defined(uSHELL_TX_VSNPRINTF) */
+
+/* ring of the shell output, nullptr: uart_putchar() */
+static txRing_s *g_psTxRing = nullptr;
+
+/*----------------------------------------------------------------------------*/
+void ushell_output_attach_tx(txRing_s *psRing) {
+    g_psTxRing = psRing;
+}
+
+/*----------------------------------------------------------------------------*/
+static void ushell_tx_send(const char *pstrText, size_t szLength) {
+    txRing_s *psRing = g_psTxRing;
+    if (nullptr != psRing) {
+        tx_ring_write(psRing, pstrText, szLength);
+    } else {
+        for (size_t i = 0U; i < szLength; ++i) {
+            uart_putchar(pstrText[i]);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+int ushell_tx_putch(int c) {
+    const char cChar = (char)c;
+    ushell_tx_send(&cChar, 1U);
+    return c;
+}
+
+/*----------------------------------------------------------------------------*/
+int ushell_tx_printf(const char *format, ...) {
+    char vText[uSHELL_TX_PRINTF_BUF_LEN];
+    va_list args;
+    va_start(args, format);
+    int iLength = uSHELL_TX_VSNPRINTF(vText, sizeof(vText), format, args);
+    va_end(args);
+    if (iLength > 0) {
+        ushell_tx_send(vText, ((size_t)iLength < sizeof(vText)) ? (size_t)iLength : (sizeof(vText) - 1U)); /* longer texts are cut */
+    }
+    return iLength;
+}
+
+#endif /* defined(SERIAL_TERMINAL) */
+
+#endif /* (1 == uSHELL_SUPPORTS_TX_RING) */
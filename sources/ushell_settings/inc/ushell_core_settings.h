@@ -7,10 +7,58 @@
 /* script mode will disable different settings, see below */
 #define uSHELL_SCRIPT_MODE                       0
 
+/* the uSHELL_SUPPORTS_* features wrapped in #if !defined() are off unless the build turns them on
+   (-D<feature>=1), the hosted CMake build does it (USHELL_FEATURES, sources/ushell_settings/CMakeLists.txt) */
+
 /* user-app settings */
 #define uSHELL_SUPPORTS_MULTIPLE_INSTANCES       1  /* allow a nested shell for plugins */
 #define uSHELL_SUPPORTS_EXTERNAL_USER_DATA       0  /* allow the shell to access external data */
 #define uSHELL_SUPPORTS_COMMAND_AS_PARAMETER     1  /* enable Execute(command) interface */
+#if !defined(uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+#define uSHELL_SUPPORTS_OUTPUT_CAPTURE           0  /* Execute(command, sink, result): output into a buffer/arena/callback */
+#endif /*!defined(uSHELL_SUPPORTS_OUTPUT_CAPTURE)*/
+#if !defined(uSHELL_SUPPORTS_BATCH_MODE)
+#define uSHELL_SUPPORTS_BATCH_MODE               0  /* ushell -c "cmd; cmd" | -f script | piped input, no interactive loop */
+#endif /*!defined(uSHELL_SUPPORTS_BATCH_MODE)*/
+#if !defined(uSHELL_SUPPORTS_SERVER_MODE)
+#define uSHELL_SUPPORTS_SERVER_MODE              0  /* ushell --server path: clients of a UNIX socket served by one epoll loop */
+#endif /*!defined(uSHELL_SUPPORTS_SERVER_MODE)*/
+#if !defined(uSHELL_SUPPORTS_FRAME_PROTOCOL)
+#define uSHELL_SUPPORTS_FRAME_PROTOCOL           0  /* ushell --frames: pre-tokenised binary requests on stdin/stdout or the server */
+#endif /*!defined(uSHELL_SUPPORTS_FRAME_PROTOCOL)*/
+#if !defined(uSHELL_SUPPORTS_JSON_OUTPUT)
+#define uSHELL_SUPPORTS_JSON_OUTPUT              0  /* ushell --json: one JSON line per command (result, error, duration, output) */
+#endif /*!defined(uSHELL_SUPPORTS_JSON_OUTPUT)*/
+#if !defined(uSHELL_SUPPORTS_INPUT_RING)
+#define uSHELL_SUPPORTS_INPUT_RING               0  /* uSHELL_GETCH() reads a lock-free ring fed by an ISR or another thread */
+#endif /*!defined(uSHELL_SUPPORTS_INPUT_RING)*/
+#if !defined(uSHELL_SUPPORTS_TX_RING)
+#define uSHELL_SUPPORTS_TX_RING                  0  /* the output goes into a lock-free ring drained by DMA, an ISR or a thread */
+#endif /*!defined(uSHELL_SUPPORTS_TX_RING)*/
+#if !defined(uSHELL_SUPPORTS_KEY_METER)
+#define uSHELL_SUPPORTS_KEY_METER                0  /* bytes, wire time and CPU time of each keystroke on a simulated serial line */
+#endif /*!defined(uSHELL_SUPPORTS_KEY_METER)*/
+#if !defined(uSHELL_SUPPORTS_LINK_FILTER)
+#define uSHELL_SUPPORTS_LINK_FILTER              0  /* minimised output for slow links: no redundant colour and cursor sequences */
+#endif /*!defined(uSHELL_SUPPORTS_LINK_FILTER)*/
+#if !defined(uSHELL_SUPPORTS_COROUTINES)
+#define uSHELL_SUPPORTS_COROUTINES               0  /* C++20 coroutine commands: co_await timers, I/O or sub-commands, resumed between keystrokes */
+#endif /*!defined(uSHELL_SUPPORTS_COROUTINES)*/
+#if !defined(uSHELL_SUPPORTS_CANCELLATION)
+#define uSHELL_SUPPORTS_CANCELLATION             0  /* Ctrl-C and per-command timeouts fire a token polled with ushell_should_stop() */
+#endif /*!defined(uSHELL_SUPPORTS_CANCELLATION)*/
+#if !defined(uSHELL_SUPPORTS_FAN_OUT)
+#define uSHELL_SUPPORTS_FAN_OUT                  0  /* #p: one command over a range or a list of arguments, on a pool of threads if it is thread safe */
+#endif /*!defined(uSHELL_SUPPORTS_FAN_OUT)*/
+#if !defined(uSHELL_SUPPORTS_COMMAND_RESOLVER)
+#define uSHELL_SUPPORTS_COMMAND_RESOLVER         0  /* resolve commands outside the own table (i.e. plugin.command) */
+#endif /*!defined(uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+#if !defined(uSHELL_SUPPORTS_HOT_RELOAD)
+#define uSHELL_SUPPORTS_HOT_RELOAD               0  /* switch to a new instance between two commands (i.e. rebuilt plugin) */
+#endif /*!defined(uSHELL_SUPPORTS_HOT_RELOAD)*/
+#if !defined(uSHELL_SUPPORTS_DYNAMIC_COMMANDS)
+#define uSHELL_SUPPORTS_DYNAMIC_COMMANDS         0  /* commands registered at runtime in the root shell */
+#endif /*!defined(uSHELL_SUPPORTS_DYNAMIC_COMMANDS)*/
 
 /* major features */
 #define uSHELL_IMPLEMENTS_HISTORY                1
@@ -38,10 +86,22 @@
 #define uSHELL_SUPPORTS_NUMBERS_FLOAT            0  /* f (float)  */
 #define uSHELL_SUPPORTS_STRINGS                  1  /* s (string) */
 #define uSHELL_SUPPORTS_BOOLEAN                  1  /* o (bool)   */
+#if !defined(uSHELL_SUPPORTS_BLOB)
+#define uSHELL_SUPPORTS_BLOB                     0  /* x (hex blob, needs hexlify) */
+#endif /*!defined(uSHELL_SUPPORTS_BLOB)*/
 #if (1 == uSHELL_SUPPORTS_STRINGS)
 #define uSHELL_SUPPORTS_SPACED_STRINGS           1
 #endif /*(1 == uSHELL_SUPPORTS_STRINGS)*/
 #define uSHELL_SUPPORTS_SIGNED_TYPES             0
+#if !defined(uSHELL_SUPPORTS_FILE_ARGS)
+#define uSHELL_SUPPORTS_FILE_ARGS                0  /* s/x argument "@path" ("@-": stdin, "@@": literal '@') is the file contents */
+#endif /*!defined(uSHELL_SUPPORTS_FILE_ARGS)*/
+#if !defined(uSHELL_SUPPORTS_READER)
+#define uSHELL_SUPPORTS_READER                   0  /* r (reader): the last parameter, the command pulls its input in chunks */
+#endif /*!defined(uSHELL_SUPPORTS_READER)*/
+#if !defined(uSHELL_SUPPORTS_ARRAY_PARAMS)
+#define uSHELL_SUPPORTS_ARRAY_PARAMS             0  /* L I W B F S: the last parameter takes all the remaining arguments */
+#endif /*!defined(uSHELL_SUPPORTS_ARRAY_PARAMS)*/
 /* max number of params of type */
 #define uSHELL_MAX_PARAMS_NUM64                  (1U)
 #define uSHELL_MAX_PARAMS_NUM32                  (5U)
@@ -50,11 +110,27 @@
 #define uSHELL_MAX_PARAMS_FLOAT                  (0U)
 #define uSHELL_MAX_PARAMS_STRING                 (5U)
 #define uSHELL_MAX_PARAMS_BOOLEAN                (1U)
+#define uSHELL_MAX_PARAMS_BLOB                   (2U)
+#if !defined(uSHELL_MAX_ARRAY_ITEMS)
+#define uSHELL_MAX_ARRAY_ITEMS                   (64U)  /* default size of the array buffer of an instance */
+#endif /*!defined(uSHELL_MAX_ARRAY_ITEMS)*/
+#define uSHELL_MAX_FILE_ARGS                     (2U)   /* files opened by one command */
 /* implementation specific */
 #define uSHELL_MAX_INPUT_BUF_LEN                 (128U)
 #define uSHELL_PROMPT_MAX_LEN                    (20U)
 #define uSHELL_HISTORY_BUFFER_SIZE               (256) // if set to 0 then the history is disabled
 #define uSHELL_HISTORY_FILEPATH_LENGTH           (32U)
+#define uSHELL_SERVER_MAX_CLIENTS                (64U)  /* clients connected at the same time in server mode */
+#define uSHELL_MAX_FRAME_LEN                     (64U * 1024U)  /* largest binary request */
+#define uSHELL_INPUT_RING_SIZE                   (256U) /* bytes of the input ring (power of two) */
+#define uSHELL_TX_RING_SIZE                      (1024U) /* bytes of the output ring (power of two) */
+#define uSHELL_TX_PRINTF_BUF_LEN                 (128U) /* longest text of one uSHELL_PRINTF() through the output ring */
+#define uSHELL_MAX_JOBS                          (8U)   /* coroutine commands waiting in the background at the same time */
+#define uSHELL_COMMAND_TIMEOUT_MS                (0U)   /* timeout of each command (0: none), #t changes it */
+#if !defined(uSHELL_FAN_OUT_MAX_ITEMS)
+#define uSHELL_FAN_OUT_MAX_ITEMS                 (32U)  /* command lines of one #p, the size of its table of results */
+#endif /*!defined(uSHELL_FAN_OUT_MAX_ITEMS)*/
+#define uSHELL_FAN_OUT_WORKERS                   (4U)   /* threads of #p by default (hosted builds), #p<n> changes it */
 
 #if (1 == uSHELL_SUPPORTS_COLORS)
 #define uSHELL_PROMPT_COLOR                      "\033[96m"     // Bright Cyan
@@ -86,7 +162,7 @@
 #if (0 == uSHELL_HISTORY_BUFFER_SIZE)
     #undef  uSHELL_IMPLEMENTS_HISTORY
     #define uSHELL_IMPLEMENTS_HISTORY            0
-#endif /*(0 == uSHELL_HISTORY_DEPTH)*/
+#endif /*(0 == uSHELL_HISTORY_BUFFER_SIZE)*/
 
 /* script mode will disable all the "exotic" features */
 #if (1 == uSHELL_SCRIPT_MODE)
@@ -136,6 +212,70 @@
     #define uSHELL_IMPLEMENTS_CONFIRM_REQUEST    0
 #endif /* ((0 == uSHELL_IMPLEMENTS_HISTORY) && (0 == uSHELL_IMPLEMENTS_SHELL_EXIT)) */
 
+/* the blobs are decoded by unhexlify */
+#if (0 == uSHELL_IMPLEMENTS_HEXLIFY)
+    #undef uSHELL_SUPPORTS_BLOB
+    #define uSHELL_SUPPORTS_BLOB                 0
+#endif /* (0 == uSHELL_IMPLEMENTS_HEXLIFY) */
+
+/* no files and no output capture without a hosted OS, before the features built on them are derived */
+#if !(defined(__linux__) || defined(__MINGW32__) || defined(_MSC_VER))
+    #undef uSHELL_IMPLEMENTS_SAVE_HISTORY
+    #define uSHELL_IMPLEMENTS_SAVE_HISTORY 0
+    #undef uSHELL_SUPPORTS_FILE_ARGS
+    #define uSHELL_SUPPORTS_FILE_ARGS 0
+    #undef uSHELL_SUPPORTS_OUTPUT_CAPTURE
+    #define uSHELL_SUPPORTS_OUTPUT_CAPTURE 0
+#endif /*defined(__linux__) || defined(__MINGW32__) || defined(_MSC_VER)*/
+
+/* the output is captured for the commands executed by Execute() */
+#if (0 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
+    #undef uSHELL_SUPPORTS_OUTPUT_CAPTURE
+    #define uSHELL_SUPPORTS_OUTPUT_CAPTURE       0
+#endif /* (0 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+
+/* the batch mode reports the results through Execute(command, sink, result) */
+#if (0 == uSHELL_SUPPORTS_OUTPUT_CAPTURE)
+    #undef uSHELL_SUPPORTS_BATCH_MODE
+    #define uSHELL_SUPPORTS_BATCH_MODE           0
+#endif /* (0 == uSHELL_SUPPORTS_OUTPUT_CAPTURE) */
+
+/* the server runs the commands of its clients like a batch, epoll is linux only */
+#if ((0 == uSHELL_SUPPORTS_BATCH_MODE) || !defined(__linux__))
+    #undef uSHELL_SUPPORTS_SERVER_MODE
+    #define uSHELL_SUPPORTS_SERVER_MODE          0
+#endif /* ((0 == uSHELL_SUPPORTS_BATCH_MODE) || !defined(__linux__)) */
+
+/* the binary requests are run like a batch, their output is captured into the responses */
+#if (0 == uSHELL_SUPPORTS_BATCH_MODE)
+    #undef uSHELL_SUPPORTS_FRAME_PROTOCOL
+    #define uSHELL_SUPPORTS_FRAME_PROTOCOL       0
+#endif /* (0 == uSHELL_SUPPORTS_BATCH_MODE) */
+
+/* the JSON records are written for the commands of a batch or of the server clients */
+#if (0 == uSHELL_SUPPORTS_BATCH_MODE)
+    #undef uSHELL_SUPPORTS_JSON_OUTPUT
+    #define uSHELL_SUPPORTS_JSON_OUTPUT          0
+#endif /* (0 == uSHELL_SUPPORTS_BATCH_MODE) */
+
+/* the keystrokes are measured on the two rings, with the clocks of the host unless given (uSHELL_KEY_METER_NOW_NS/CPU_NS) */
+#if ((0 == uSHELL_SUPPORTS_INPUT_RING) || (0 == uSHELL_SUPPORTS_TX_RING) || (defined(SERIAL_TERMINAL) && !defined(uSHELL_KEY_METER_NOW_NS)))
+    #undef uSHELL_SUPPORTS_KEY_METER
+    #define uSHELL_SUPPORTS_KEY_METER            0
+#endif /* ((0 == uSHELL_SUPPORTS_INPUT_RING) || (0 == uSHELL_SUPPORTS_TX_RING) || (defined(SERIAL_TERMINAL) && !defined(uSHELL_KEY_METER_NOW_NS))) */
+
+/* a target waits for the keys on the input ring and gives the clock of the timers (uSHELL_JOBS_NOW_MS) */
+#if (defined(SERIAL_TERMINAL) && ((0 == uSHELL_SUPPORTS_INPUT_RING) || !defined(uSHELL_JOBS_NOW_MS)))
+    #undef uSHELL_SUPPORTS_COROUTINES
+    #define uSHELL_SUPPORTS_COROUTINES           0
+#endif /* (defined(SERIAL_TERMINAL) && ((0 == uSHELL_SUPPORTS_INPUT_RING) || !defined(uSHELL_JOBS_NOW_MS))) */
+
+/* the commands registered at runtime are published by switching the instance between two commands */
+#if (0 == uSHELL_SUPPORTS_HOT_RELOAD)
+    #undef uSHELL_SUPPORTS_DYNAMIC_COMMANDS
+    #define uSHELL_SUPPORTS_DYNAMIC_COMMANDS     0
+#endif /* (0 == uSHELL_SUPPORTS_HOT_RELOAD) */
+
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
     #define uSHELL_INIT_AUTOCOMPL_MODE           true /*true:on, false:off*/
     #define uSHELL_AUTOCOMPL_RELOAD              true
@@ -207,10 +347,11 @@
     #endif /* #if (uSHELL_MAX_PARAMS_BOOLEAN > 0)*/
 #endif /* #if (1 == uSHELL_SUPPORTS_BOOLEAN)*/
 
-#if !(defined(__linux__) || defined(__MINGW32__) || defined(_MSC_VER))
-    #undef uSHELL_IMPLEMENTS_SAVE_HISTORY
-    #define uSHELL_IMPLEMENTS_SAVE_HISTORY 0
-#endif /*defined(__linux__) || defined(__MINGW32__) || defined(_MSC_VER)*/
+#if (1 == uSHELL_SUPPORTS_BLOB)
+    #if (uSHELL_MAX_PARAMS_BLOB > 0)
+        #define uSHELL_IMPLEMENTS_BLOB
+    #endif /* #if (uSHELL_MAX_PARAMS_BLOB > 0)*/
+#endif /* #if (1 == uSHELL_SUPPORTS_BLOB)*/
 
 /* useful macros */
 #define uSHELL_NR_ELEMS(a) ((int)(sizeof(a)/sizeof(a[0])))
@@ -1,8 +1,60 @@
 //#pragma warning(disable : 4668 5039 4710 4711 4820)
 #include "ushell_core.h"
 #include "ushell_core_terminal.h"
+#include "ushell_root_plugins.h"
+#include "ushell_core_txring.h"
+#include "ushell_core_keymeter.h"
+#include "ushell_core_linkfilter.h"
+
+/* the simulated UART (--uart) takes the output of the shell through the output layer */
+#define APP_SUPPORTS_SIM_UART   ((1 == uSHELL_SUPPORTS_TX_RING) && (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE))
+/* the serial line (--serial) measures the keystrokes between the input ring and the simulated UART */
+#define APP_SUPPORTS_KEY_METER  ((1 == uSHELL_SUPPORTS_KEY_METER) && (1 == APP_SUPPORTS_SIM_UART))
+/* the link budget (--link-budget) takes the output of the shell through the output layer */
+#define APP_SUPPORTS_LINK_BUDGET ((1 == uSHELL_SUPPORTS_LINK_FILTER) && (1 == uSHELL_SUPPORTS_OUTPUT_CAPTURE))
+/* the command line has options */
+#define APP_SUPPORTS_OPTIONS    ((1 == uSHELL_SUPPORTS_BATCH_MODE) || (1 == uSHELL_SUPPORTS_INPUT_RING) || (1 == APP_SUPPORTS_SIM_UART) || \
+                                 (1 == APP_SUPPORTS_LINK_BUDGET) || (1 == uSHELL_SUPPORTS_CANCELLATION))
 
 #include <cstdlib>
+#include <memory>
+#if (1 == APP_SUPPORTS_OPTIONS)
+#include <cstdio>
+#include <cstring>
+#endif /* (1 == APP_SUPPORTS_OPTIONS) */
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+#include "ushell_core_batch.h"
+#include "ushell_core_server.h"
+#include "ushell_core_frame.h"
+#include "ushell_core_json.h"
+#include <fcntl.h>
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+#if ((1 == uSHELL_SUPPORTS_BATCH_MODE) || (1 == APP_SUPPORTS_SIM_UART))
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif /* defined(_WIN32) */
+#endif /* ((1 == uSHELL_SUPPORTS_BATCH_MODE) || (1 == APP_SUPPORTS_SIM_UART)) */
+#if ((1 == uSHELL_SUPPORTS_INPUT_RING) || (1 == APP_SUPPORTS_SIM_UART))
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+#include <pthread.h>
+#include <signal.h>
+#endif /* !(defined(__MINGW32__) || defined(_MSC_VER)) */
+#endif /* ((1 == uSHELL_SUPPORTS_INPUT_RING) || (1 == APP_SUPPORTS_SIM_UART)) */
+#if (1 == APP_SUPPORTS_SIM_UART)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+#if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
+#include <fstream>
+#include <string>
+#endif /* (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
 
 // valgrind --leak-check=yes --track-origins=yes --leak-check=full --show-leak-kinds=all  ./ushell
 
@@ -21,24 +73,806 @@ enum ExitCode {
     EXIT_SUCCESS_CODE = 0,
     EXIT_PLUGIN_INIT_FAILED = 1,
     EXIT_SHELL_CREATION_FAILED = 2,
-    EXIT_TERMINAL_INIT_FAILED = 3
+    EXIT_TERMINAL_INIT_FAILED = 3,
+    EXIT_COMMAND_FAILED = 4,
+    EXIT_INVALID_ARGUMENTS = 5,
+    EXIT_SCRIPT_NOT_READABLE = 6,
+    EXIT_SERVER_FAILED = 7,
+    EXIT_PROTOCOL_ERROR = 8
 };
 
 /* Shell configuration */
 static constexpr const char* ROOT_SHELL_NAME = "root";
 
+/* Batch mode: the commands come from the command line, a script or a pipe instead of a user */
+struct BatchOptions {
+    const char *pstrCommands;   /* -c "cmd; cmd" */
+    const char *pstrScript;     /* -f script, "-" for the standard input */
+    const char *pstrServer;     /* --server path: serve the clients of a UNIX socket */
+    bool bFrames;               /* --frames: binary requests on stdin/stdout or from the server clients */
+    bool bJson;                 /* --json: one JSON line per command instead of the text output */
+    bool bKeepGoing;            /* -k: run the remaining commands after a failure */
+    bool bInputRing;            /* --input-ring: interactive, the keys reach the shell through the input ring */
+    unsigned int uUartBaud;     /* --uart baud: interactive, the output goes through a simulated UART (0: terminal) */
+    int iUartPolicy;            /* txRingPolicy_e of the output ring */
+    bool bSerial;               /* --serial baud: both rings at the wire speed, the keystrokes are measured */
+    bool bLinkBudget;           /* --link-budget: interactive, no redundant colour and cursor sequences */
+    unsigned int uTimeoutMs;    /* --timeout ms: each command is asked to stop after ms (0: no timeout) */
+};
+
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+static constexpr size_t BATCH_READ_BLOCK_SIZE = 64U * 1024U;
+static constexpr const char* BATCH_STDIN_NAME = "-";
+static constexpr char BATCH_COMMENT_CHAR = '#';
+static constexpr char BATCH_STRING_BORDER = '"';
+static constexpr size_t BATCH_ECHO_MAX_LEN = uSHELL_MAX_INPUT_BUF_LEN;   /* of a failed command in its report */
+#if (1 == uSHELL_SUPPORTS_SERVER_MODE)
+static constexpr const char* SERVER_PROMPT = "root> ";
+#endif /* (1 == uSHELL_SUPPORTS_SERVER_MODE) */
+
+/* JSON records (--json): the captured output and the record are kept in arenas reused for all the commands */
+struct JsonOutput {
+    outputSink_s sOutput;
+    outputSink_s sRecord;
+    uint32_t uSeq;              /* server: number of the command since the start */
+};
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+
+#if (1 == APP_SUPPORTS_SIM_UART)
+static constexpr unsigned long UART_MAX_BAUD = 4000000UL;
+static constexpr unsigned int UART_BITS_PER_BYTE = 10U;             /* start, 8 data, stop */
+static constexpr unsigned int UART_IDLE_WAIT_MS = 10U;              /* line idle: wait for a kick at most that long */
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+
+#if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
+/* Plugins to load in the background at startup: the environment variable
+   takes precedence over the list file found in the working directory */
+static constexpr const char* PRELOAD_PLUGINS_ENV_NAME = "USHELL_PRELOAD_PLUGINS";
+static constexpr const char* PRELOAD_PLUGINS_FILE_NAME = ".ushell_preload";
+#endif /* (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
+
 ////////////////////////////////////////////////////////////////////////////////////////
 //                            HELPER FUNCTIONS                                        //
 ////////////////////////////////////////////////////////////////////////////////////////
 
+#if (1 == APP_SUPPORTS_OPTIONS)
+/**
+ * @brief Print the command line options of the features built in on stderr
+ */
+static void printUsage(const char *pstrName)
+{
+    static const char *USAGE_FIRST_FORM = "usage:";
+    const char *pstrForm = USAGE_FIRST_FORM;     /* "   or:" once a form of the command line is printed */
+
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    fprintf(stderr, "%s %s [-k] [-c \"cmd; cmd\" | -f script]\n"
+                    "  -c  run the commands separated by ';'\n"
+                    "  -f  run the commands of a script, one per line ('-': standard input)\n"
+                    "  -k  keep going after a failed command\n"
+                    "  a piped standard input is run like a script\n", pstrForm, pstrName);
+    pstrForm = "   or:";
+#if (1 == uSHELL_SUPPORTS_JSON_OUTPUT)
+    fprintf(stderr, "  --json  one JSON line per command on stdout (also for the --server clients)\n");
+#endif /* (1 == uSHELL_SUPPORTS_JSON_OUTPUT) */
+#if (1 == uSHELL_SUPPORTS_SERVER_MODE)
+    fprintf(stderr, "   or: %s --server path\n"
+                    "  --server  serve the clients connecting to the UNIX socket path\n", pstrName);
+#endif /* (1 == uSHELL_SUPPORTS_SERVER_MODE) */
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    fprintf(stderr, "   or: %s --frames [--server path]\n"
+                    "  --frames  binary requests (ushell_core_frame.h) on stdin/stdout or from the clients\n", pstrName);
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+#if ((1 == uSHELL_SUPPORTS_INPUT_RING) || (1 == APP_SUPPORTS_SIM_UART))
+    fprintf(stderr, "%s %s", pstrForm, pstrName);
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+    fprintf(stderr, " [--input-ring]");
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+#if (1 == APP_SUPPORTS_SIM_UART)
+    fprintf(stderr, " [--uart baud[:block|drop|truncate]]");
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+    fprintf(stderr, "\n");
+    pstrForm = "   or:";
+#endif /* ((1 == uSHELL_SUPPORTS_INPUT_RING) || (1 == APP_SUPPORTS_SIM_UART)) */
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+    fprintf(stderr, "  --input-ring  interactive shell reading the keys from the input ring fed by a thread\n");
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+#if (1 == APP_SUPPORTS_SIM_UART)
+    fprintf(stderr, "  --uart  interactive shell writing through the output ring drained by a simulated UART\n");
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+#if (1 == APP_SUPPORTS_KEY_METER)
+    fprintf(stderr, "%s %s --serial baud[:block|drop|truncate]\n"
+                    "  --serial  both rings at the speed of the serial line, bytes, latency and CPU time per keystroke on exit\n", pstrForm, pstrName);
+    pstrForm = "   or:";
+#endif /* (1 == APP_SUPPORTS_KEY_METER) */
+#if (1 == APP_SUPPORTS_LINK_BUDGET)
+    if (USAGE_FIRST_FORM == pstrForm) {
+        fprintf(stderr, "%s %s [--link-budget]\n", pstrForm, pstrName);
+        pstrForm = "   or:";
+    }
+    fprintf(stderr, "  --link-budget  interactive shell without redundant colour and cursor sequences (with --uart, --serial or alone)\n");
+#endif /* (1 == APP_SUPPORTS_LINK_BUDGET) */
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    if (USAGE_FIRST_FORM == pstrForm) {
+        fprintf(stderr, "%s %s [--timeout ms]\n", pstrForm, pstrName);
+    }
+    fprintf(stderr, "  --timeout ms  each command is asked to stop after ms (any mode, #t changes it), Ctrl-C stops the running command\n");
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+}
+
+#if (1 == APP_SUPPORTS_SIM_UART)
+/**
+ * @brief Parse "baud[:block|drop|truncate]"
+ * @return false if the text is not valid
+ */
+static bool parseUart(const char *pstrUart, BatchOptions *psOptions)
+{
+    static const char *vstrPolicies[TX_RING_POLICY_LAST] = { "block", "drop", "truncate" };
+    char *pstrEnd = nullptr;
+    const unsigned long ulBaud = strtoul(pstrUart, &pstrEnd, 10);
+
+    if ((0UL == ulBaud) || (ulBaud > UART_MAX_BAUD)) {
+        return false;
+    }
+    psOptions->uUartBaud = (unsigned int)ulBaud;
+    psOptions->iUartPolicy = TX_RING_BLOCK;
+    if ('\0' == *pstrEnd) {
+        return true;
+    }
+    for (int i = 0; (':' == *pstrEnd) && (i < TX_RING_POLICY_LAST); ++i) {
+        if (0 == strcmp(pstrEnd + 1, vstrPolicies[i])) {
+            psOptions->iUartPolicy = i;
+            return true;
+        }
+    }
+    return false;
+}
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/**
+ * @brief Parse the milliseconds of "--timeout ms"
+ * @return false if the text is not a number of milliseconds
+ */
+static bool parseTimeout(const char *pstrTimeout, BatchOptions *psOptions)
+{
+    char *pstrEnd = nullptr;
+    const unsigned long ulTimeoutMs = strtoul(pstrTimeout, &pstrEnd, 10);
+
+    if ((pstrEnd == pstrTimeout) || ('\0' != *pstrEnd) || (ulTimeoutMs > UINT32_MAX)) {
+        return false;
+    }
+    psOptions->uTimeoutMs = (unsigned int)ulTimeoutMs;
+    return true;
+}
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+/**
+ * @brief true if the options replace the terminal of the interactive shell
+ */
+static bool hasTerminalOptions(const BatchOptions *psOptions)
+{
+    return psOptions->bInputRing || (0U != psOptions->uUartBaud) || psOptions->bLinkBudget;
+}
+
+/**
+ * @brief Parse the command line: [-k] [-c "cmd; cmd" | -f script] | --server path | [--input-ring] [--uart baud]
+ *        (the options of the features built in)
+ * @return false (after printing the usage) if the arguments are not valid
+ */
+static bool parseArguments(int argc, char *argv[], BatchOptions *psOptions)
+{
+    for (int i = 1; i < argc; ++i) {
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+        const bool bFirstSource = (nullptr == psOptions->pstrCommands) && (nullptr == psOptions->pstrScript) && (nullptr == psOptions->pstrServer);
+        if ((0 == strcmp(argv[i], "-c")) && (i + 1 < argc) && bFirstSource && !psOptions->bFrames) {
+            psOptions->pstrCommands = argv[++i];
+        } else if ((0 == strcmp(argv[i], "-f")) && (i + 1 < argc) && bFirstSource && !psOptions->bFrames) {
+            psOptions->pstrScript = argv[++i];
+#if (1 == uSHELL_SUPPORTS_SERVER_MODE)
+        } else if ((0 == strcmp(argv[i], "--server")) && (i + 1 < argc) && bFirstSource) {
+            psOptions->pstrServer = argv[++i];
+#endif /* (1 == uSHELL_SUPPORTS_SERVER_MODE) */
+        } else if (0 == strcmp(argv[i], "-k")) {
+            psOptions->bKeepGoing = true;
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+        } else if ((0 == strcmp(argv[i], "--frames")) && (nullptr == psOptions->pstrCommands) && (nullptr == psOptions->pstrScript) && !psOptions->bJson) {
+            psOptions->bFrames = true;
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+#if (1 == uSHELL_SUPPORTS_JSON_OUTPUT)
+        } else if ((0 == strcmp(argv[i], "--json")) && !psOptions->bFrames) {
+            psOptions->bJson = true;
+#endif /* (1 == uSHELL_SUPPORTS_JSON_OUTPUT) */
+        } else
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+        if (0 == strcmp(argv[i], "--input-ring")) {
+            psOptions->bInputRing = true;
+        } else
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+#if (1 == APP_SUPPORTS_SIM_UART)
+        if ((0 == strcmp(argv[i], "--uart")) && (i + 1 < argc) && parseUart(argv[i + 1], psOptions)) {
+            ++i;
+        } else
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+#if (1 == APP_SUPPORTS_KEY_METER)
+        if ((0 == strcmp(argv[i], "--serial")) && (i + 1 < argc) && parseUart(argv[i + 1], psOptions)) {
+            psOptions->bInputRing = true;
+            psOptions->bSerial = true;
+            ++i;
+        } else
+#endif /* (1 == APP_SUPPORTS_KEY_METER) */
+#if (1 == APP_SUPPORTS_LINK_BUDGET)
+        if (0 == strcmp(argv[i], "--link-budget")) {
+            psOptions->bLinkBudget = true;
+        } else
+#endif /* (1 == APP_SUPPORTS_LINK_BUDGET) */
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        if ((0 == strcmp(argv[i], "--timeout")) && (i + 1 < argc) && parseTimeout(argv[i + 1], psOptions)) {
+            ++i;
+        } else
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+        {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    /* the rings replace the terminal of the interactive shell, they do not apply to a batch */
+    const bool bInteractive = hasTerminalOptions(psOptions);
+    const bool bBatch = (nullptr != psOptions->pstrCommands) || (nullptr != psOptions->pstrScript) || (nullptr != psOptions->pstrServer) ||
+                        psOptions->bFrames || psOptions->bJson || psOptions->bKeepGoing;
+    if (bInteractive && bBatch) {
+        printUsage(argv[0]);
+        return false;
+    }
+    return true;
+}
+#endif /* (1 == APP_SUPPORTS_OPTIONS) */
+
+#if ((1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) || (1 == APP_SUPPORTS_SIM_UART))
+/**
+ * @brief Write a whole buffer to a file descriptor
+ */
+static bool writeAll(int iFd, const char *pBuffer, size_t szLength)
+{
+    while (szLength > 0U) {
+        long lWritten = (long)write(iFd, pBuffer, (unsigned int)szLength);
+        if (lWritten <= 0) {
+            return false;
+        }
+        pBuffer += lWritten;
+        szLength -= (size_t)lWritten;
+    }
+    return true;
+}
+#endif /* ((1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) || (1 == APP_SUPPORTS_SIM_UART)) */
+
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+#if (1 == uSHELL_SUPPORTS_JSON_OUTPUT)
+/**
+ * @brief Run a command with its output captured, its JSON record is appended to the sink
+ * @return true if the command succeeded
+ */
+static bool jsonExecute(Microshell *pShell, const char *pstrCommand, uint32_t uSeq, JsonOutput *psJson, outputSink_s *psSink)
+{
+    execResult_s sResult;
+    output_sink_reset(&psJson->sOutput);
+    const bool bOk = pShell->Execute(pstrCommand, &psJson->sOutput, &sResult);
+
+    jsonRecord_s sRecord = { uSeq, pstrCommand, BATCH_STRING_BORDER, sResult.iRetVal, sResult.iError, sResult.iErrorArg,
+                             sResult.uElapsedUs, psJson->sOutput.pBuffer, psJson->sOutput.szLength };
+    json_write_record(psSink, &sRecord);
+    return bOk;
+}
+#endif /* (1 == uSHELL_SUPPORTS_JSON_OUTPUT) */
+
+/**
+ * @brief Run one command of a batch, empty lines and comments ('#') are skipped
+ * @param psJson not nullptr: the result is written as a JSON record on stdout instead of reported on stderr
+ * @return false if the command failed
+ */
+static bool runBatchCommand(Microshell *pShell, char *pstrCommand, const char *pstrSource, unsigned int uLine, JsonOutput *psJson)
+{
+    pstrCommand += strspn(pstrCommand, " \t");
+    if (('\0' == *pstrCommand) || (BATCH_COMMENT_CHAR == *pstrCommand)) {
+        return true;
+    }
+
+#if (1 == uSHELL_SUPPORTS_JSON_OUTPUT)
+    if (nullptr != psJson) {
+        output_sink_reset(&psJson->sRecord);
+        const bool bOk = jsonExecute(pShell, pstrCommand, uLine, psJson, &psJson->sRecord);
+        fwrite(psJson->sRecord.pBuffer, 1U, psJson->sRecord.szLength, stdout);
+        return bOk;
+    }
+#else
+    (void)psJson;
+#endif /* (1 == uSHELL_SUPPORTS_JSON_OUTPUT) */
+
+    execResult_s sResult;
+    if (pShell->Execute(pstrCommand, nullptr, &sResult)) {
+        return true;
+    }
+    fprintf(stderr, "%s:%u: '%.*s' failed (error %d, result %d)\n", pstrSource, uLine, (int)BATCH_ECHO_MAX_LEN, pstrCommand, sResult.iError, sResult.iRetVal);
+    return false;
+}
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+/**
+ * @brief Run a binary request, its response (result and captured output) is appended to the sink
+ */
+static void frameExecute(uint8_t *pRequest, size_t szLength, outputSink_s *psSink, void *pvContext)
+{
+    frameRequest_s sRequest;
+    execResult_s sResult = { 0, uSHELL_ERR_FUNCTION_NOT_FOUND, -1, 0 };
+    const size_t szStart = frame_begin_response(psSink);
+
+    const bool bDecoded = frame_decode_request(pRequest, szLength, &sRequest);
+    if (bDecoded) {
+        static_cast<Microshell *>(pvContext)->Execute(&sRequest, psSink, &sResult);
+    }
+    frameResponse_s sResponse = { sRequest.uTag, sResult.iError, sResult.iRetVal, sResult.iErrorArg, sResult.uElapsedUs };
+    frame_end_response(psSink, szStart, &sResponse);
+}
+
+/**
+ * @brief Run the binary requests of the standard input, the responses of each block read are written at once
+ * @return EXIT_PROTOCOL_ERROR if the stream is malformed
+ */
+static int runFrames(Microshell *pShell)
+{
+#if defined(_WIN32)
+    _setmode(0, _O_BINARY);
+    _setmode(1, _O_BINARY);
+#endif /* defined(_WIN32) */
+    std::unique_ptr<uint8_t[]> pBlock(new uint8_t[BATCH_READ_BLOCK_SIZE]);
+    frameAssembler_s sAssembler = {};
+    outputSink_s sResponses = output_sink_arena();
+    int iStatus = 0;
+    long lRead = 0;
+
+    while ((iStatus >= 0) && ((lRead = (long)read(0, pBlock.get(), (unsigned int)BATCH_READ_BLOCK_SIZE)) > 0)) {
+        const uint8_t *pData = pBlock.get();
+        size_t szAvail = (size_t)lRead;
+        while ((szAvail > 0U) && ((iStatus = frame_feed(&sAssembler, &pData, &szAvail)) >= 0)) {
+            if (1 == iStatus) {
+                frameExecute(sAssembler.pFrame, sAssembler.szLength, &sResponses, pShell);
+            }
+        }
+        if (!writeAll(1, sResponses.pBuffer, sResponses.szLength)) {
+            break;
+        }
+        output_sink_reset(&sResponses);
+    }
+    output_sink_release(&sResponses);
+    frame_assembler_release(&sAssembler);
+
+    if (iStatus < 0) {
+        fprintf(stderr, "stdin: malformed request\n");
+        return EXIT_PROTOCOL_ERROR;
+    }
+    return EXIT_SUCCESS_CODE;
+}
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
+#if (1 == uSHELL_SUPPORTS_SERVER_MODE)
+/* what the server callbacks get as context */
+struct ServerContext {
+    Microshell *pShell;
+    JsonOutput *psJson;         /* nullptr: text results */
+};
+
+/**
+ * @brief Run a command line of a server client, its output and the result (or its JSON record) go to the client
+ */
+static void serverExecute(const char *pstrCommand, outputSink_s *psSink, void *pvContext)
+{
+    ServerContext *psContext = static_cast<ServerContext *>(pvContext);
+#if (1 == uSHELL_SUPPORTS_JSON_OUTPUT)
+    if (nullptr != psContext->psJson) {
+        jsonExecute(psContext->pShell, pstrCommand, ++psContext->psJson->uSeq, psContext->psJson, psSink);
+        return;
+    }
+#endif /* (1 == uSHELL_SUPPORTS_JSON_OUTPUT) */
+    execResult_s sResult;
+    psContext->pShell->Execute(pstrCommand, psSink, &sResult);
+    if (uSHELL_ERR_OK == sResult.iError) {
+        output_sink_printf(psSink, "=> %d (0x%X)\n", sResult.iRetVal, (unsigned int)sResult.iRetVal);
+    }
+}
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+/**
+ * @brief Run a binary request of a server client
+ */
+static void serverFrameExecute(uint8_t *pRequest, size_t szLength, outputSink_s *psSink, void *pvContext)
+{
+    frameExecute(pRequest, szLength, psSink, static_cast<ServerContext *>(pvContext)->pShell);
+}
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
+/**
+ * @brief Serve the clients of a UNIX socket until SIGINT or SIGTERM, text lines or binary requests (--frames)
+ * @return EXIT_SERVER_FAILED if the socket cannot be created
+ */
+static int runServer(Microshell *pShell, const BatchOptions *psOptions, JsonOutput *psJson)
+{
+    ServerContext sContext = { pShell, psJson };
+    serverConfig_s sConfig = {};
+    sConfig.pstrPath = psOptions->pstrServer;
+    sConfig.pstrPrompt = (nullptr == psJson) ? SERVER_PROMPT : nullptr;
+    sConfig.pfExec = serverExecute;
+    sConfig.pvContext = &sContext;
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    if (psOptions->bFrames) {
+        sConfig.pstrPrompt = nullptr;
+        sConfig.pfFrame = serverFrameExecute;
+    }
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+    if (!server_run(&sConfig)) {
+        fprintf(stderr, "%s: the server socket cannot be created\n", sConfig.pstrPath);
+        return EXIT_SERVER_FAILED;
+    }
+    return EXIT_SUCCESS_CODE;
+}
+#endif /* (1 == uSHELL_SUPPORTS_SERVER_MODE) */
+
+/**
+ * @brief Run the commands of the batch: no echo, prompt, autocomplete or history
+ * @return EXIT_SUCCESS_CODE if all the commands succeeded
+ */
+static int runBatch(Microshell *pShell, const BatchOptions *psOptions)
+{
+    unsigned int uNrFailed = 0;
+    JsonOutput sJson = { output_sink_arena(), output_sink_arena(), 0U };
+    JsonOutput *psJson = psOptions->bJson ? &sJson : nullptr;
+    int iExitCode = EXIT_SUCCESS_CODE;
+
+#if (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL)
+    if (psOptions->bFrames && (nullptr == psOptions->pstrServer)) {
+        return runFrames(pShell);
+    }
+#endif /* (1 == uSHELL_SUPPORTS_FRAME_PROTOCOL) */
+
+    if (nullptr != psOptions->pstrServer) {
+#if (1 == uSHELL_SUPPORTS_SERVER_MODE)
+        iExitCode = runServer(pShell, psOptions, psJson);
+#endif /* (1 == uSHELL_SUPPORTS_SERVER_MODE) */
+    } else if (nullptr != psOptions->pstrCommands) {
+        std::unique_ptr<char[]> pstrCommands(new char[strlen(psOptions->pstrCommands) + 1U]);
+        char *pstrRest = strcpy(pstrCommands.get(), psOptions->pstrCommands);
+        char *pstrCommand = nullptr;
+        unsigned int uIndex = 0;
+        while ((nullptr != (pstrCommand = batch_next_command(&pstrRest, BATCH_STRING_BORDER))) &&
+               ((0U == uNrFailed) || psOptions->bKeepGoing)) {
+            uNrFailed += runBatchCommand(pShell, pstrCommand, "-c", ++uIndex, psJson) ? 0U : 1U;
+        }
+    } else {
+        const bool bStdin = (nullptr == psOptions->pstrScript) || (0 == strcmp(psOptions->pstrScript, BATCH_STDIN_NAME));
+        const char *pstrSource = bStdin ? "stdin" : psOptions->pstrScript;
+        int iFd = bStdin ? 0 : open(psOptions->pstrScript, O_RDONLY);
+        lineReader_s sReader;
+        if ((iFd < 0) || (false == linereader_open(&sReader, iFd, BATCH_READ_BLOCK_SIZE))) {
+            fprintf(stderr, "%s: cannot be read\n", pstrSource);
+            return EXIT_SCRIPT_NOT_READABLE;
+        }
+        char *pstrLine = nullptr;
+        unsigned int uLine = 0;
+        while ((nullptr != (pstrLine = linereader_next(&sReader))) && ((0U == uNrFailed) || psOptions->bKeepGoing)) {
+            uNrFailed += runBatchCommand(pShell, pstrLine, pstrSource, ++uLine, psJson) ? 0U : 1U;
+        }
+        linereader_close(&sReader);
+        if (!bStdin) {
+            close(iFd);
+        }
+    }
+    output_sink_release(&sJson.sOutput);
+    output_sink_release(&sJson.sRecord);
+
+    if ((EXIT_SUCCESS_CODE == iExitCode) && (0U != uNrFailed)) {
+        iExitCode = EXIT_COMMAND_FAILED;
+    }
+    return iExitCode;
+}
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+
+#if ((1 == uSHELL_SUPPORTS_INPUT_RING) || (1 == APP_SUPPORTS_SIM_UART))
+/**
+ * @brief Start a thread of the application (input ring producer, simulated UART) with SIGINT and SIGTERM blocked
+ *
+ * The signal handlers must run on the shell thread: Ctrl-C fires the token of the command
+ * in the foreground (or ends the shell at the prompt) and the server waits for SIGTERM in
+ * its poll(); a signal taken by another thread would not interrupt the call the shell waits in.
+ */
+template <typename Function>
+static std::thread startBackgroundThread(Function fnBody)
+{
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+    sigset_t sBlocked;
+    sigset_t sPrevious;
+    sigemptyset(&sBlocked);
+    sigaddset(&sBlocked, SIGINT);
+    sigaddset(&sBlocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sBlocked, &sPrevious);
+    std::thread thread(std::move(fnBody));
+    pthread_sigmask(SIG_SETMASK, &sPrevious, nullptr);
+    return thread;
+#else
+    return std::thread(std::move(fnBody));
+#endif /* !(defined(__MINGW32__) || defined(_MSC_VER)) */
+}
+#endif /* ((1 == uSHELL_SUPPORTS_INPUT_RING) || (1 == APP_SUPPORTS_SIM_UART)) */
+
+#if (1 == APP_SUPPORTS_SIM_UART)
+/* UART simulated by a thread: the output ring of the shell is drained at the wire speed of the baud rate */
+struct SimUart {
+    txRing_s sRing;
+    uint8_t vBuffer[uSHELL_TX_RING_SIZE];
+    unsigned int uBaud;
+    outputSink_s sSink;
+    outputSink_s *psPrevSink;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable kick;
+    std::atomic<bool> bStop;
+    std::atomic<long long> llHighSinceNs;    /* when the high watermark was crossed */
+    long long llAboveHighNs;                 /* time spent between a high and the next low watermark */
+    unsigned long long ullSent;
+};
+
+/**
+ * @brief Output sink of the shell: the text goes into the output ring
+ */
+static void simUartOutput(const char *pstrText, size_t szLength, void *pvContext)
+{
+    tx_ring_write(&static_cast<SimUart *>(pvContext)->sRing, pstrText, szLength);
+}
+
+/**
+ * @brief Kick of the output ring: wake the transmitter up
+ */
+static void simUartKick(txRing_s *psRing, void *pvContext)
+{
+    (void)psRing;
+    static_cast<SimUart *>(pvContext)->kick.notify_one();
+}
+
+/**
+ * @brief Watermarks of the output ring: measure how long the shell was ahead of the wire
+ */
+static void simUartWatermark(txRing_s *psRing, txRingEvent_e eEvent, void *pvContext)
+{
+    (void)psRing;
+    SimUart *psUart = static_cast<SimUart *>(pvContext);
+    const long long llNowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (TX_RING_HIGH_WATERMARK == eEvent) {
+        psUart->llHighSinceNs = llNowNs;
+    } else {
+        psUart->llAboveHighNs += llNowNs - psUart->llHighSinceNs;
+    }
+}
+
+/**
+ * @brief Transmitter: send linear blocks of the ring, each byte takes its wire time
+ */
+static void simUartTransmit(SimUart *psUart)
+{
+    const auto tByte = std::chrono::nanoseconds(1000000000LL * UART_BITS_PER_BYTE / psUart->uBaud);
+    const size_t szBurst = 1U + psUart->uBaud / UART_BITS_PER_BYTE / 1000U;   /* about one millisecond of wire time */
+    auto tNext = std::chrono::steady_clock::now();
+
+    for (;;) {
+        const uint8_t *pData = nullptr;
+        size_t szLength = tx_ring_peek(&psUart->sRing, &pData);
+        if (0U == szLength) {
+            if (psUart->bStop) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(psUart->mutex);
+            psUart->kick.wait_for(lock, std::chrono::milliseconds(UART_IDLE_WAIT_MS));
+            tNext = std::chrono::steady_clock::now(); /* the line was idle */
+            continue;
+        }
+        szLength = (szLength < szBurst) ? szLength : szBurst;
+        if (!writeAll(1, reinterpret_cast<const char *>(pData), szLength)) {
+            break;
+        }
+        tx_ring_consume(&psUart->sRing, szLength);
+        psUart->ullSent += szLength;
+        tNext += tByte * (long long)szLength;
+        std::this_thread::sleep_until(tNext);
+    }
+}
+
+/**
+ * @brief Send the output of the shell (this thread) through the output ring of a simulated UART
+ * @return false if the ring cannot be created
+ */
+static bool startSimUart(SimUart *psUart, const BatchOptions *psOptions)
+{
+    if (!tx_ring_init(&psUart->sRing, psUart->vBuffer, sizeof(psUart->vBuffer))) {
+        return false;
+    }
+    psUart->sRing.ePolicy = static_cast<txRingPolicy_e>(psOptions->iUartPolicy);
+    psUart->sRing.pfKick = simUartKick;
+    psUart->sRing.pfWatermark = simUartWatermark;
+    psUart->sRing.pvContext = psUart;
+    psUart->uBaud = psOptions->uUartBaud;
+    psUart->bStop = false;
+    psUart->llHighSinceNs = 0;
+    psUart->llAboveHighNs = 0;
+    psUart->ullSent = 0U;
+    psUart->thread = startBackgroundThread([psUart]() { simUartTransmit(psUart); });
+    psUart->sSink = output_sink_callback(simUartOutput, psUart);
+    psUart->psPrevSink = output_redirect(&psUart->sSink);
+    return true;
+}
+
+/**
+ * @brief Send the rest of the output, stop the UART and report its counters on stderr
+ */
+static void stopSimUart(SimUart *psUart)
+{
+    output_redirect(psUart->psPrevSink);
+    tx_ring_flush(&psUart->sRing);
+    psUart->bStop = true;
+    psUart->kick.notify_one();
+    psUart->thread.join();
+    fprintf(stderr, "uart %u baud: %llu bytes sent, %u dropped, %u blocked writes, %u high watermarks (%.1f ms above)\n",
+            psUart->uBaud, psUart->ullSent, (unsigned int)psUart->sRing.uDropped, (unsigned int)psUart->sRing.uBlocked,
+            (unsigned int)psUart->sRing.uHighEvents, (double)psUart->llAboveHighNs / 1e6);
+}
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+
+#if (1 == APP_SUPPORTS_KEY_METER)
+/**
+ * @brief Print on stderr the cost of the keystrokes, one line per class
+ */
+static void printKeyMeter(const keyMeter_s *psMeter, unsigned int uBaud)
+{
+    fprintf(stderr, "keystrokes at %u baud:\n%-12s %6s %9s %10s %11s %11s %9s %10s\n",
+            uBaud, "class", "keys", "bytes in", "bytes out", "cpu us/key", "latency ms", "max ms", "queued ms");
+    for (int i = 0; i < KEY_CLASS_LAST; ++i) {
+        const keyMeterStats_s *psStats = &psMeter->vStats[i];
+        if (0U == psStats->uKeys) {
+            continue;
+        }
+        fprintf(stderr, "%-12s %6u %9llu %10llu %11.1f %11.2f %9.2f %10.2f\n",
+                key_meter_class_name(static_cast<keyClass_e>(i)), (unsigned int)psStats->uKeys,
+                (unsigned long long)psStats->ullBytesIn, (unsigned long long)psStats->ullBytesOut,
+                (double)psStats->ullCpuNs / 1e3 / psStats->uKeys, (double)psStats->ullLatencyNs / 1e6 / psStats->uKeys,
+                (double)psStats->ullMaxLatencyNs / 1e6, (double)psStats->ullMaxQueuedNs / 1e6);
+    }
+}
+#endif /* (1 == APP_SUPPORTS_KEY_METER) */
+
+#if (1 == APP_SUPPORTS_LINK_BUDGET)
+/* output of the shell minimised in front of the terminal or of the simulated UART */
+struct LinkBudget {
+    linkFilter_s sFilter;
+    outputSink_s sSink;
+    outputSink_s *psPrevSink;
+};
+
+/**
+ * @brief Output sink of the shell: the text goes through the filter
+ */
+static void linkBudgetOutput(const char *pstrText, size_t szLength, void *pvContext)
+{
+    link_filter_write(&static_cast<LinkBudget *>(pvContext)->sFilter, pstrText, szLength);
+}
+
+/**
+ * @brief Output of the filter to the terminal
+ */
+static void terminalOutput(const char *pstrText, size_t szLength, void *pvContext)
+{
+    (void)pvContext;
+    fwrite(pstrText, 1U, szLength, stdout);
+    fflush(stdout);
+}
+
+/**
+ * @brief Send the output of the shell (this thread) through the filter to pfOutput
+ */
+static void startLinkBudget(LinkBudget *psLink, PFLINKOUTPUT pfOutput, void *pvContext)
+{
+    link_filter_init(&psLink->sFilter, pfOutput, pvContext);
+    psLink->sSink = output_sink_callback(linkBudgetOutput, psLink);
+    psLink->psPrevSink = output_redirect(&psLink->sSink);
+}
+
+/**
+ * @brief Send what the filter holds back and report the bytes saved on stderr
+ */
+static void stopLinkBudget(LinkBudget *psLink)
+{
+    output_redirect(psLink->psPrevSink);
+    link_filter_flush(&psLink->sFilter);
+    const unsigned long long ullIn = psLink->sFilter.ullBytesIn;
+    const unsigned long long ullOut = psLink->sFilter.ullBytesOut;
+    fprintf(stderr, "link budget: %llu bytes from the shell, %llu sent (%.1f%% saved)\n",
+            ullIn, ullOut, (0U != ullIn) ? (100.0 * ((double)ullIn - (double)ullOut) / (double)ullIn) : 0.0);
+}
+#endif /* (1 == APP_SUPPORTS_LINK_BUDGET) */
+
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+/**
+ * @brief Feed the keys of the terminal (or of a pipe) to the shell through the input ring
+ *
+ * The thread stands in for the UART RX interrupt of a microcontroller build: the keys
+ * which do not fit in the ring are dropped and counted, the end of the input closes
+ * the ring and ends the shell. With a baud rate the keys arrive at the speed of the
+ * serial line, not faster (a pipe).
+ * @return the ring, nullptr if it cannot be created
+ */
+static inputRing_s *startInputRingProducer(unsigned int uBaud)
+{
+    static uint8_t vRingBuffer[uSHELL_INPUT_RING_SIZE];
+    static inputRing_s sRing;
+
+    if (!input_ring_init(&sRing, vRingBuffer, sizeof(vRingBuffer))) {
+        return nullptr;
+    }
+    ushell_input_attach(&sRing);
+    startBackgroundThread([uBaud]() {
+        const auto tByte = std::chrono::nanoseconds((0U != uBaud) ? (1000000000LL * 10 / uBaud) : 0); /* start, 8 data, stop */
+        auto tNext = std::chrono::steady_clock::now();
+        int iKey = 0;
+        while (EOF != (iKey = (int)uSHELL_TERMINAL_GETCH())) {
+            if (0U != uBaud) {
+                tNext = std::max(tNext, std::chrono::steady_clock::now()) + tByte;
+                std::this_thread::sleep_until(tNext);
+            }
+            input_ring_put(&sRing, (uint8_t)iKey);
+        }
+        input_ring_close(&sRing);
+    }).detach();
+    return &sRing;
+}
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
+/**
+ * @brief Start preloading the plugins listed in the environment or in the preload file
+ *
+ * The plugins are loaded on worker threads while the root shell is already
+ * interactive; a later pload of one of them does not wait for the loader.
+ * In the preload file everything following a '#' up to the end of line is ignored.
+ */
+static void preloadPlugins(void)
+{
+    const char *pstrPluginList = std::getenv(PRELOAD_PLUGINS_ENV_NAME);
+
+    if (nullptr != pstrPluginList) {
+        uShellRootPreloadPlugins(pstrPluginList);
+        return;
+    }
+
+    std::ifstream file(PRELOAD_PLUGINS_FILE_NAME);
+    if (!file) {
+        uShellRootPreloadPlugins(nullptr);
+        return;
+    }
+
+    std::string strPluginList;
+    std::string strLine;
+    while (std::getline(file, strLine)) {
+        strPluginList.append(strLine, 0, strLine.find('#')).push_back(' ');
+    }
+
+    uShellRootPreloadPlugins(strPluginList.c_str());
+}
+
 /**
  * @brief Initialize and run shell with multiple instance support
  * @param pShellInst Pointer to shell instance configuration
  * @param pstrShellName Name for the shell prompt
+ * @param psBatch Commands to run instead of the interactive shell (nullptr: interactive)
  * @return Exit code
  */
-static int runShellMultiInstance(uShellInst_s *pShellInst, const char *pstrShellName)
+static int runShellMultiInstance(uShellInst_s *pShellInst, const char *pstrShellName, const BatchOptions *psBatch)
 {
     if (!pShellInst) {
         return EXIT_PLUGIN_INIT_FAILED;
@@ -50,6 +884,13 @@ static int runShellMultiInstance(uShellInst_s *pShellInst, const char *pstrShell
         return EXIT_SHELL_CREATION_FAILED;
     }
     
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    if (nullptr != psBatch) {
+        return runBatch(pShellPtr.get(), psBatch);
+    }
+#else
+    (void)psBatch;
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
     pShellPtr->Run();
     return EXIT_SUCCESS_CODE;
 }
@@ -58,9 +899,10 @@ static int runShellMultiInstance(uShellInst_s *pShellInst, const char *pstrShell
  * @brief Initialize and run shell with single instance support
  * @param pShellInst Pointer to shell instance configuration
  * @param pstrShellName Name for the shell prompt
+ * @param psBatch Commands to run instead of the interactive shell (nullptr: interactive)
  * @return Exit code
  */
-static int runShellSingleInstance(uShellInst_s *pShellInst, const char *pstrShellName)
+static int runShellSingleInstance(uShellInst_s *pShellInst, const char *pstrShellName, const BatchOptions *psBatch)
 {
     if (!pShellInst) {
         return EXIT_PLUGIN_INIT_FAILED;
@@ -72,6 +914,13 @@ static int runShellSingleInstance(uShellInst_s *pShellInst, const char *pstrShel
         return EXIT_SHELL_CREATION_FAILED;
     }
     
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    if (nullptr != psBatch) {
+        return runBatch(pShell, psBatch);
+    }
+#else
+    (void)psBatch;
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
     pShell->Run();
     return EXIT_SUCCESS_CODE;
 }
@@ -82,12 +931,82 @@ static int runShellSingleInstance(uShellInst_s *pShellInst, const char *pstrShel
 //                                  MAIN                                              //
 ////////////////////////////////////////////////////////////////////////////////////////
 
-int main()
+int main(int argc, char *argv[])
 {
     int exitCode = EXIT_SUCCESS_CODE;
-    
-    /* Initialize terminal with RAII */
-    TerminalRAII terminal;
+    BatchOptions sBatch = { nullptr, nullptr, nullptr, false, false, false, false, 0U, 0, false, false, uSHELL_COMMAND_TIMEOUT_MS };
+    const BatchOptions *psBatch = nullptr;
+
+#if (1 == APP_SUPPORTS_OPTIONS)
+    if (!parseArguments(argc, argv, &sBatch)) {
+        return EXIT_INVALID_ARGUMENTS;
+    }
+#else
+    (void)argc;
+    (void)argv;
+    (void)sBatch;
+#endif /* (1 == APP_SUPPORTS_OPTIONS) */
+#if (1 == uSHELL_SUPPORTS_BATCH_MODE)
+    if ((nullptr != sBatch.pstrCommands) || (nullptr != sBatch.pstrScript) || (nullptr != sBatch.pstrServer) || sBatch.bFrames ||
+        (!hasTerminalOptions(&sBatch) && !TerminalRAII::isInteractive())) {
+        psBatch = &sBatch;
+        Microshell::SetBatchMode(true);
+    }
+#endif /* (1 == uSHELL_SUPPORTS_BATCH_MODE) */
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+    if (hasTerminalOptions(&sBatch) && !TerminalRAII::isInteractive()) {
+        sBatch.bInputRing = true; /* the interactive loop sees the end of a pipe through the ring */
+    }
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+    Microshell::SetCommandTimeout(sBatch.uTimeoutMs);
+    ushell_cancel_catch_sigint(); /* Ctrl-C stops the running command, at the prompt it ends the shell */
+#endif /* (1 == uSHELL_SUPPORTS_CANCELLATION) */
+
+    /* Initialize terminal with RAII (interactive use only) */
+    std::unique_ptr<TerminalRAII> pTerminal;
+    if (nullptr == psBatch) {
+        pTerminal.reset(new TerminalRAII());
+    }
+#if (1 == uSHELL_SUPPORTS_INPUT_RING)
+    inputRing_s *psInputRing = nullptr;
+    if (sBatch.bInputRing) {
+        psInputRing = startInputRingProducer(sBatch.bSerial ? sBatch.uUartBaud : 0U);
+    }
+#endif /* (1 == uSHELL_SUPPORTS_INPUT_RING) */
+#if (1 == APP_SUPPORTS_SIM_UART)
+    std::unique_ptr<SimUart> pUart;
+    if (0U != sBatch.uUartBaud) {
+        pUart.reset(new SimUart());
+        if (!startSimUart(pUart.get(), &sBatch)) {
+            return EXIT_INVALID_ARGUMENTS;
+        }
+    }
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+#if (1 == APP_SUPPORTS_KEY_METER)
+    static keyMeter_s sKeyMeter;
+    if (sBatch.bSerial && pUart) {
+        key_meter_init(&sKeyMeter, sBatch.uUartBaud, psInputRing, &pUart->sRing);
+        ushell_key_meter_attach(&sKeyMeter);
+    }
+#elif (1 == uSHELL_SUPPORTS_INPUT_RING)
+    (void)psInputRing;
+#endif /* (1 == APP_SUPPORTS_KEY_METER) */
+#if (1 == APP_SUPPORTS_LINK_BUDGET)
+    std::unique_ptr<LinkBudget> pLink;
+    if (sBatch.bLinkBudget) {
+        PFLINKOUTPUT pfLinkOutput = terminalOutput;
+        void *pvLinkOutput = nullptr;
+#if (1 == APP_SUPPORTS_SIM_UART)
+        if (pUart) {
+            pfLinkOutput = simUartOutput; /* in front of the UART */
+            pvLinkOutput = pUart.get();
+        }
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+        pLink.reset(new LinkBudget());
+        startLinkBudget(pLink.get(), pfLinkOutput, pvLinkOutput);
+    }
+#endif /* (1 == APP_SUPPORTS_LINK_BUDGET) */
 
 #if (0 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
     /* Single instance mode */
@@ -98,7 +1017,7 @@ int main()
         uShellInst_s *pShellInst = uShellPluginEntry(nullptr);
     #endif
     
-    exitCode = runShellSingleInstance(pShellInst, ROOT_SHELL_NAME);
+    exitCode = runShellSingleInstance(pShellInst, ROOT_SHELL_NAME, psBatch);
     
     #if 0  /* Optional: Execute command before running interactive shell */
     if (exitCode == EXIT_SUCCESS_CODE) {
@@ -117,11 +1036,30 @@ int main()
     #else
         uShellInst_s *pShellInst = uShellPluginEntry(nullptr);
     #endif
-    
-    exitCode = runShellMultiInstance(pShellInst, ROOT_SHELL_NAME);
+
+    preloadPlugins();
+
+    exitCode = runShellMultiInstance(pShellInst, ROOT_SHELL_NAME, psBatch);
 
 #endif /* (0 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
 
+#if (1 == APP_SUPPORTS_LINK_BUDGET)
+    if (pLink) {
+        stopLinkBudget(pLink.get());
+    }
+#endif /* (1 == APP_SUPPORTS_LINK_BUDGET) */
+#if (1 == APP_SUPPORTS_SIM_UART)
+    if (pUart) {
+        stopSimUart(pUart.get());
+    }
+#endif /* (1 == APP_SUPPORTS_SIM_UART) */
+#if (1 == APP_SUPPORTS_KEY_METER)
+    if (sBatch.bSerial && pUart) {
+        ushell_key_meter_attach(nullptr);
+        printKeyMeter(&sKeyMeter, sBatch.uUartBaud);
+    }
+#endif /* (1 == APP_SUPPORTS_KEY_METER) */
+
     return exitCode;
 
 } /* main() */
@@ -10,80 +10,85 @@ static int uShellExecuteCommand( const command_s *psCmd );
     void *pvLocalUserData = nullptr;
 #endif /* (1 == uSHELL_SUPPORTS_EXTERNAL_USER_DATA) */
 
-/* disable warnings */
-#if defined (__GNUC__) && defined(__AVR__)
-    #pragma GCC diagnostic push
-    #pragma GCC diagnostic ignored "-Wmissing-braces"
-#endif /*defined (__GNUC__) && defined(__AVR__)*/
-
-#if (defined(__GNUC__) && (defined(__xtensa__) || defined(__ARM_ARCH)))
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-function-type"
-#endif /*(defined(__GNUC__) && defined(__xtensa__))*/
-
 /** \brief define array of functions (basic properties) */
 #define  uSHELL_COMMANDS_TABLE_BEGIN                        static const fctDef_s g_vsFuncDefArray[] = {
 #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
-#define  uSHELL_COMMAND(a,b,c)                                  { #a, #b },
+#define  uSHELL_COMMAND(a,b,c)                                  { #a, #b, false },
+#define  uSHELL_COMMAND_MT(a,b,c)                               { #a, #b, true },
 #define  uSHELL_COMMANDS_TABLE_END                          };
 #include uSHELL_COMMANDS_CONFIG_FILE
 #undef   uSHELL_COMMANDS_TABLE_BEGIN
 #undef   uSHELL_COMMAND_PARAMS_PATTERN
 #undef   uSHELL_COMMAND
+#undef   uSHELL_COMMAND_MT
 #undef   uSHELL_COMMANDS_TABLE_END
 
-/** \brief define array of functions (extended properties) */
-#define  uSHELL_COMMANDS_TABLE_BEGIN                        static const fctDefEx_s g_vsFuncDefExArray[] = {
+/** \brief check the signature of the functions against their pattern */
+#define  uSHELL_COMMANDS_TABLE_BEGIN
 #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
-#if (defined(__GNUC__) && (defined(__AVR__) || defined(__ARM_ARCH) || defined(__xtensa__)))
-    #define  uSHELL_COMMAND(a,b,c)                              { (v_fctptr_t)a, b##_type },
-#elif ((defined(__GNUC__) && defined(__linux__)) || defined(__MINGW32__))
-    #ifdef __cplusplus
-        #define  uSHELL_COMMAND(a,b,c)                          { (v_fctptr_t)a, b##_type },
-    #else
-        #define  uSHELL_COMMAND(a,b,c)                          { (fctype_u)(b##_fctptr_t)a, b##_type },
-    #endif  // __cplusplus
-#elif (defined(_MSC_VER)) /* i.e MinGW or Microsoft VisualStudio for Windows console */
-    #ifdef __cplusplus
-        #define  uSHELL_COMMAND(a,b,c)                          { (v_fctptr_t)a, b##_type },
-    #else
-        #define  uSHELL_COMMAND(a,b,c)                          { (b##_fctptr_t)a, b##_type },
-    #endif
-#elif (defined(__ghs) || defined(__ghs__))   /* Green Hills Software compiler */
-    #define  uSHELL_COMMAND(a,b,c)                              { a, b##_type },
-#else
-    #error "Build variant not defined, please define it..."
-#endif
-#define  uSHELL_COMMANDS_TABLE_END                          };
+#define  uSHELL_COMMAND(a,b,c)                                  static_assert(uShellCommand<a>::matches(#b), "parameters of " #a "() do not match the pattern " #b);
+#define  uSHELL_COMMAND_MT(a,b,c)                               uSHELL_COMMAND(a,b,c)
+#define  uSHELL_COMMANDS_TABLE_END
 #include uSHELL_COMMANDS_CONFIG_FILE
 #undef   uSHELL_COMMANDS_TABLE_BEGIN
 #undef   uSHELL_COMMAND_PARAMS_PATTERN
 #undef   uSHELL_COMMAND
+#undef   uSHELL_COMMAND_MT
 #undef   uSHELL_COMMANDS_TABLE_END
 
-/* end of disable warnings */
-#if (defined (__GNUC__) && (defined(__AVR__) || defined(__xtensa__)))
-    #pragma GCC diagnostic pop
-#endif /*defined (__GNUC__) && defined(__AVR__)*/
+/** \brief define array of functions (call thunks) */
+#define  uSHELL_COMMANDS_TABLE_BEGIN                        static const PFEXEC g_vpfThunkArray[] = {
+#define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+#define  uSHELL_COMMAND(a,b,c)                                  uShellCommand<a>::thunk,
+#define  uSHELL_COMMAND_MT(a,b,c)                               uSHELL_COMMAND(a,b,c)
+#define  uSHELL_COMMANDS_TABLE_END                          };
+#include uSHELL_COMMANDS_CONFIG_FILE
+#undef   uSHELL_COMMANDS_TABLE_BEGIN
+#undef   uSHELL_COMMAND_PARAMS_PATTERN
+#undef   uSHELL_COMMAND
+#undef   uSHELL_COMMAND_MT
+#undef   uSHELL_COMMANDS_TABLE_END
 
 /* info for functions */
 #if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
     #define  uSHELL_COMMANDS_TABLE_BEGIN                    static const char* const g_vstrInfoArray[] = {
     #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
     #define  uSHELL_COMMAND(a,b,c)                              c,
+    #define  uSHELL_COMMAND_MT(a,b,c)                           uSHELL_COMMAND(a,b,c)
     #define  uSHELL_COMMANDS_TABLE_END                      };
     #include uSHELL_COMMANDS_CONFIG_FILE
     #undef   uSHELL_COMMANDS_TABLE_BEGIN
     #undef   uSHELL_COMMAND_PARAMS_PATTERN
     #undef   uSHELL_COMMAND
+    #undef   uSHELL_COMMAND_MT
     #undef   uSHELL_COMMANDS_TABLE_END
 #endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
 
+/* manifest of the commands, readable without loading the plugin */
+#if defined(uSHELL_MANIFEST_ATTRIBUTE)
+    #define  uSHELL_COMMANDS_TABLE_BEGIN                    uSHELL_MANIFEST_ATTRIBUTE static const char g_vstrManifest[] = uSHELL_MANIFEST_MAGIC "\0"
+    #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+    #define  uSHELL_COMMAND(a,b,c)                              #a "\0" #b "\0" c "\0"
+    #define  uSHELL_COMMAND_MT(a,b,c)                           uSHELL_COMMAND(a,b,c)
+    #define  uSHELL_COMMANDS_TABLE_END                      ;
+    #include uSHELL_COMMANDS_CONFIG_FILE
+    #undef   uSHELL_COMMANDS_TABLE_BEGIN
+    #undef   uSHELL_COMMAND_PARAMS_PATTERN
+    #undef   uSHELL_COMMAND
+    #undef   uSHELL_COMMAND_MT
+    #undef   uSHELL_COMMANDS_TABLE_END
+#endif /*defined(uSHELL_MANIFEST_ATTRIBUTE)*/
+
 /* autocomplete index array */
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
 static int g_viAutocompleteIndexArray[uSHELL_NR_ELEMS(g_vsFuncDefArray)] = {0};
 #endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
 
+/* storage of the items of an array parameter */
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+static arrayItem_u g_vuArrayBuffer[uSHELL_MAX_ARRAY_ITEMS];
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+
 /* user shortcuts array */
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
 #define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN                  static shortcut_s g_vsShortcutsArray[] = { { ' ', nullptr }
@@ -130,6 +135,16 @@ static uShellInst_s sShellInstance = {
     .iNrFunctions                                           = uSHELL_NR_ELEMS(g_vsFuncDefArray),
     .iNrShortcuts                                           = uSHELL_NR_ELEMS(g_vsShortcutsArray),
     .pfExec                                                 = uShellExecuteCommand,
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    .pfResolve                                              = nullptr,
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    .pfReload                                               = nullptr,
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+    .puArrayBuffer                                          = g_vuArrayBuffer,
+    .iArrayBufferItems                                      = uSHELL_NR_ELEMS(g_vuArrayBuffer),
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
     .vstrPrompt                                             = {0},
     .iPromptLength                                          = 0
 };
@@ -211,16 +226,6 @@ EXPORTED void uShellPluginExit( uShellPluginInterface *ptrPlugin )
  */
 static int uShellExecuteCommand(const command_s *psCmd)
 {
-    /* void:v, (byte)u8:b:vb, (word)u16:w:vw, (int)u32:i:vi, (long)u64:l:vl, float:f:vf, string:s:vs, bool:o:vo */
-    switch(g_vsFuncDefExArray[psCmd->iFctIndex].eParamType) {
-        case v_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.v_fct          ();
-        case i_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.i_fct          (psCmd->vi[0]);
-        case s_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.s_fct          (psCmd->vs[0]);
-        case ii_type         :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.ii_fct         (psCmd->vi[0], psCmd->vi[1]);
-        case ss_type         :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.ss_fct         (psCmd->vs[0], psCmd->vs[1]);
-        case is_type         :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.is_fct         (psCmd->vi[0], psCmd->vs[0]);
-        case lio_type        :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.lio_fct        (psCmd->vl[0], psCmd->vi[0], psCmd->vo[0]);
-        default              :return uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM;
-    }
+    return g_vpfThunkArray[psCmd->iFctIndex](psCmd);
 } /* uShellExecuteCommand() */
 
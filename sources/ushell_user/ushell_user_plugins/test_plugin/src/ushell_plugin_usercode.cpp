@@ -1,9 +1,14 @@
+#include "ushell_core_cancel.h"
+#include "ushell_core_datatypes.h"
+#include "ushell_core_reader.h"
+#include "ushell_core_task.h"
 #include "ushell_core_utils.h"
 #include "ushell_user_logger.h"
 #include <stdint.h>
 #include <string.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <chrono>
 
 /*
 Note:
@@ -64,6 +69,23 @@ int itest(uint32_t i)
     return 0;
 }
 
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+/*---------------------------------------------------------------*/
+int ispin(uint32_t ms)
+{
+    uSHELL_LOG(LOG_VERBOSE, "--> ispin()" );
+
+    const auto tStart = std::chrono::steady_clock::now();
+    uint32_t uElapsedMs = 0U;
+    while (((0U == ms) || (uElapsedMs < ms)) && (false == ushell_should_stop())) {
+        uElapsedMs = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tStart).count();
+    }
+    uSHELL_LOG(LOG_INFO, "%u ms, stop: %s", uElapsedMs, cancel_reason_name(ushell_stop_reason()) );
+
+    return (int)uElapsedMs;
+}
+#endif /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+
 /*---------------------------------------------------------------*/
 int stest(char *s)
 {
@@ -116,6 +138,41 @@ int iitest(uint32_t i1, uint32_t i2)
     return 0;
 }
 
+#if (1 == uSHELL_SUPPORTS_COROUTINES)
+/*---------------------------------------------------------------*/
+static uShellTask iitick(uint32_t ms, uint32_t n)
+{
+    co_await ushell_sleep(ms);
+    uSHELL_LOG(LOG_INFO, "tick %u", n );
+
+    co_return (int)n;
+}
+
+/*---------------------------------------------------------------*/
+static uShellTask iitask_run(uint32_t ms, uint32_t count)
+{
+    int iTicks = 0;
+    for (uint32_t n = 1U; n <= count; ++n) {
+        iTicks += (co_await iitick(ms, n) > 0) ? 1 : 0;
+#if (1 == uSHELL_SUPPORTS_CANCELLATION)
+        if (true == ushell_should_stop()) {
+            break; /* #j<id> or the timeout */
+        }
+#endif /*(1 == uSHELL_SUPPORTS_CANCELLATION)*/
+    }
+
+    co_return iTicks;
+}
+
+/*---------------------------------------------------------------*/
+int iitask(uint32_t ms, uint32_t count)
+{
+    uSHELL_LOG(LOG_VERBOSE, "--> iitask()" );
+
+    return ushell_task_start(iitask_run(ms, count), "iitask");
+}
+#endif /*(1 == uSHELL_SUPPORTS_COROUTINES)*/
+
 /*---------------------------------------------------------------*/
 int istest(uint32_t i, char *s)
 {
@@ -150,6 +207,64 @@ int liotest(uint64_t l, uint32_t i, bool o) {
     return 0;
 }
 
+#if defined(uSHELL_IMPLEMENTS_BLOB)
+/*---------------------------------------------------------------*/
+int xtest(blob_t data)
+{
+    uSHELL_LOG(LOG_VERBOSE, "--> xtest() : %u bytes", (unsigned int)data.szLength);
+    for (size_t i = 0; (i < data.szLength) && (i < 16U); ++i) {
+        uSHELL_LOG(LOG_VERBOSE, "%d : %d (0x%02X)", i, data.pData[i], data.pData[i]);
+    }
+
+    return (int)data.szLength;
+}
+#endif /*defined(uSHELL_IMPLEMENTS_BLOB)*/
+
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+/*---------------------------------------------------------------*/
+int iItest(uint32_t addr, num32_span_t words)
+{
+    uSHELL_LOG(LOG_VERBOSE, "--> iItest()" );
+    for (unsigned int i = 0; i < words.iNrItems; ++i) {
+        uSHELL_LOG(LOG_INFO, "[0x%08X] = 0x%08X", addr + (i * sizeof(uint32_t)), words.pItems[i] );
+    }
+
+    return (int)words.iNrItems;
+}
+
+/*---------------------------------------------------------------*/
+int Stest(str_span_t strings)
+{
+    uSHELL_LOG(LOG_VERBOSE, "--> Stest()" );
+    for (unsigned int i = 0; i < strings.iNrItems; ++i) {
+        uSHELL_LOG(LOG_INFO, "s%u = %s", i, strings.pItems[i] );
+    }
+
+    return (int)strings.iNrItems;
+}
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+
+#if (1 == uSHELL_SUPPORTS_READER)
+/*---------------------------------------------------------------*/
+int rtest(reader_t *input)
+{
+    uint8_t vChunk[64];
+    unsigned int iNrBytes = 0, iNrLines = 0;
+    int iRead = 0;
+
+    uSHELL_LOG(LOG_VERBOSE, "--> rtest()" );
+    while ((iRead = ushell_read(input, vChunk, sizeof(vChunk))) > 0) {
+        for (int i = 0; i < iRead; ++i) {
+            iNrLines += ('\n' == vChunk[i]) ? 1U : 0U;
+        }
+        iNrBytes += (unsigned int)iRead;
+    }
+    uSHELL_LOG(LOG_INFO, "%u bytes, %u lines", iNrBytes, iNrLines);
+
+    return (iRead < 0) ? iRead : (int)iNrLines;
+}
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+
 ///////////////////////////////////////////////////////////////////
 //               USER SHORTCUTS HANDLERS                         //
 ///////////////////////////////////////////////////////////////////
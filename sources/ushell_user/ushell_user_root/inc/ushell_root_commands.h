@@ -0,0 +1,46 @@
+#ifndef USHELL_ROOT_COMMANDS_H
+#define USHELL_ROOT_COMMANDS_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+
+#if (1 == uSHELL_SUPPORTS_DYNAMIC_COMMANDS)
+
+/** \brief callback of a command registered at runtime
+ *  \param psCmd the parsed command, with the arguments in the slots of their types (vi[], vs[], ...)
+ *  \param pvContext the context given at registration
+ *  \return the command result, negative values are reported as errors
+ */
+typedef int (*PFCOMMAND)(const command_s *psCmd, void *pvContext);
+
+/** \brief add a command to the root shell at runtime; the command is available from the
+ *  next command typed (autocomplete and help included). Can be called from any thread.
+ *  \param pstrName command name (no spaces, no '.'), unique in the root shell
+ *  \param pstrParamDef parameters pattern, like in the commands config, i.e. "v", "is"
+ *  \param pfCommand callback executing the command
+ *  \param pvContext passed back to the callback, i.e. the description of a register block
+ *  \param pstrHelp help text, "description|\tparam - info" (nullptr: none)
+ *  \return true if the command was registered
+ */
+bool uShellRootRegisterCommand(const char *pstrName, const char *pstrParamDef, PFCOMMAND pfCommand, void *pvContext, const char *pstrHelp);
+
+/** \brief remove a command registered at runtime
+ *  \param pstrName command name
+ *  \return true if the command was found
+ */
+bool uShellRootUnregisterCommand(const char *pstrName);
+
+/** \brief reload hook of the root instance: switches to a command table with the
+ *  commands registered since the previous call */
+uShellInst_s *uShellRootReloadCommands(uShellInst_s *psShellInst);
+
+/** \brief the root instance with the static command table */
+uShellInst_s *uShellRootGetStaticInstance(void);
+
+/** \brief a copy of the root instance using another command table */
+uShellInst_s uShellRootCloneInstance(const fctDef_s *psFuncDefArray, const char* const* ppstrInfoArray,
+                                     int *piAutocompleteIndexArray, int iNrFunctions, PFEXEC pfExec);
+
+#endif /*(1 == uSHELL_SUPPORTS_DYNAMIC_COMMANDS)*/
+
+#endif /* USHELL_ROOT_COMMANDS_H */
@@ -0,0 +1,26 @@
+#ifndef USHELL_ROOT_PLUGINS_H
+#define USHELL_ROOT_PLUGINS_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+
+#if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
+
+/** \brief start loading plugins in the background, before they are used by pload
+ *         (called once at startup, it also removes the reload copies left by a shell which did not exit)
+ *  \param pstrPluginList plugin names separated by commas, semicolons or whitespace, nullptr: none
+ */
+void uShellRootPreloadPlugins(const char *pstrPluginList);
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+/** \brief resolve "plugin.command" to the (resident) plugin instance and the command index
+ *  \param pstrFctName qualified command name
+ *  \param piFctIndex receives the index of the command in the plugin command table
+ *  \return the plugin instance or nullptr if the plugin or the command is unknown
+ */
+uShellInst_s *uShellRootResolveCommand(const char *pstrFctName, int *piFctIndex);
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+
+#endif /*(1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)*/
+
+#endif /* USHELL_ROOT_PLUGINS_H */
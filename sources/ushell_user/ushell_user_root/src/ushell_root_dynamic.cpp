@@ -0,0 +1,365 @@
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+#include "ushell_root_commands.h"
+#include "ushell_user_logger.h"
+
+#if (1 == uSHELL_SUPPORTS_DYNAMIC_COMMANDS)
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////
+//            LOCAL DEFINES AND DATA TYPES                       //
+///////////////////////////////////////////////////////////////////
+
+    /* parameter types accepted in the pattern of a registered command (or "v") */
+    static constexpr const char* COMMAND_PARAM_TYPES = "liwbfsox";
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+    static constexpr const char* COMMAND_ARRAY_TYPES = "LIWBFS";    /* last parameter only */
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+    static constexpr char COMMAND_READER_TYPE = 'r';                /* last parameter only */
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+    static constexpr const char* COMMAND_NO_PARAMS = "v";
+    static constexpr const char* COMMAND_NO_HELP = "";
+    static constexpr char COMMAND_RESERVED_CHAR = '.';
+
+    static constexpr size_t STRING_ARENA_BLOCK_SIZE = 4096U;
+
+    /* storage of the names, patterns and help texts of the registered commands;
+       strings are only released at exit, so the published tables never dangle */
+    class StringArena
+    {
+    public:
+        const char* copy(const char *pstrText)
+        {
+            const size_t szText = strlen(pstrText) + 1U;
+            if (szText > szFree_) {
+                const size_t szBlock = std::max(STRING_ARENA_BLOCK_SIZE, szText);
+                blocks_.emplace_back(new char[szBlock]);
+                pos_ = blocks_.back().get();
+                szFree_ = szBlock;
+            }
+
+            char *pstrCopy = pos_;
+            memcpy(pstrCopy, pstrText, szText);
+            pos_ += szText;
+            szFree_ -= szText;
+            return pstrCopy;
+        }
+
+    private:
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char *pos_ = nullptr;
+        size_t szFree_ = 0;
+    };
+
+    struct DynamicCommand {
+        const char *pstrName;
+        const char *pstrParamDef;
+        const char *pstrHelp;
+        PFCOMMAND   pfCommand;
+        void       *pvContext;
+    };
+
+    /* the static commands followed by the registered ones, published as one instance */
+    struct CommandTable {
+        std::vector<DynamicCommand> vsCommands;
+        std::vector<fctDef_s>       vsFuncDefs;
+        std::vector<const char*>    vpstrInfo;
+        std::vector<int>            viAutocomplete;
+        uShellInst_s                sInst;
+
+        explicit CommandTable(std::vector<DynamicCommand> commands);
+    };
+
+///////////////////////////////////////////////////////////////////
+//            PRIVATE INTERFACES DECLARATION                     //
+///////////////////////////////////////////////////////////////////
+
+static int privExecute(const command_s *psCmd);
+static std::vector<fctDef_s> privMergeFuncDefs(const std::vector<DynamicCommand> &vsCommands);
+static std::vector<const char*> privMergeInfo(const std::vector<DynamicCommand> &vsCommands);
+static bool privIsValidName(const char *pstrName);
+static bool privIsValidParamDef(const char *pstrParamDef);
+static bool privIsCommandNameUsed(const char *pstrName);
+static void privReleaseRetiredTables(const uShellInst_s *psShellInstInUse);
+
+///////////////////////////////////////////////////////////////////
+//            LOCAL VARIABLES                                    //
+///////////////////////////////////////////////////////////////////
+
+/* registration side, any thread */
+static std::mutex mtxRegisteredCommands;
+static StringArena arenaCommandStrings;
+static std::vector<DynamicCommand> vsRegisteredCommands;
+static std::atomic<bool> bTableOutdated{false};
+
+/* shell side, shell thread only */
+static std::unique_ptr<CommandTable> pActiveTable;
+static std::vector<std::unique_ptr<CommandTable>> vRetiredTables;
+
+///////////////////////////////////////////////////////////////////
+//            APPLICATION INTERFACES IMPLEMENTATION              //
+///////////////////////////////////////////////////////////////////
+
+/*------------------------------------------------------------
+ * add a command to the root shell at runtime
+------------------------------------------------------------*/
+bool uShellRootRegisterCommand(const char *pstrName, const char *pstrParamDef, PFCOMMAND pfCommand, void *pvContext, const char *pstrHelp)
+{
+    if (!privIsValidName(pstrName) || !privIsValidParamDef(pstrParamDef) || (nullptr == pfCommand)) {
+        uSHELL_LOG(LOG_ERROR, "Invalid command registration: %s", (nullptr != pstrName) ? pstrName : "(null)");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mtxRegisteredCommands);
+
+    if (privIsCommandNameUsed(pstrName)) {
+        uSHELL_LOG(LOG_ERROR, "Command already exists: %s", pstrName);
+        return false;
+    }
+
+    vsRegisteredCommands.push_back(DynamicCommand{
+        arenaCommandStrings.copy(pstrName),
+        arenaCommandStrings.copy(pstrParamDef),
+        arenaCommandStrings.copy((nullptr != pstrHelp) ? pstrHelp : COMMAND_NO_HELP),
+        pfCommand,
+        pvContext
+    });
+    bTableOutdated.store(true, std::memory_order_release);
+
+    return true;
+
+} /* uShellRootRegisterCommand() */
+
+
+/*------------------------------------------------------------
+ * remove a command registered at runtime
+------------------------------------------------------------*/
+bool uShellRootUnregisterCommand(const char *pstrName)
+{
+    if (nullptr == pstrName) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mtxRegisteredCommands);
+
+    auto it = std::find_if(vsRegisteredCommands.begin(), vsRegisteredCommands.end(), [pstrName](const DynamicCommand &sCommand) {
+        return 0 == strcmp(sCommand.pstrName, pstrName);
+    });
+    if (it == vsRegisteredCommands.end()) {
+        return false;
+    }
+
+    vsRegisteredCommands.erase(it);
+    bTableOutdated.store(true, std::memory_order_release);
+
+    return true;
+
+} /* uShellRootUnregisterCommand() */
+
+
+/*------------------------------------------------------------
+ * reload hook of the root instance, called by the shell
+ * between two commands
+------------------------------------------------------------*/
+uShellInst_s *uShellRootReloadCommands(uShellInst_s *psShellInst)
+{
+    privReleaseRetiredTables(psShellInst);
+
+    if (!bTableOutdated.exchange(false, std::memory_order_acq_rel)) {
+        return psShellInst;
+    }
+
+    std::vector<DynamicCommand> vsCommands;
+    {
+        std::lock_guard<std::mutex> lock(mtxRegisteredCommands);
+        vsCommands = vsRegisteredCommands;
+    }
+
+    /* the table in use is released on the next call, once the shell switched */
+    if (pActiveTable) {
+        vRetiredTables.push_back(std::move(pActiveTable));
+    }
+
+    if (vsCommands.empty()) {
+        return uShellRootGetStaticInstance();
+    }
+
+    pActiveTable.reset(new CommandTable(std::move(vsCommands)));
+    return &pActiveTable->sInst;
+
+} /* uShellRootReloadCommands() */
+
+
+///////////////////////////////////////////////////////////////////
+//            PRIVATE INTERFACES IMPLEMENTATION                  //
+///////////////////////////////////////////////////////////////////
+
+/*------------------------------------------------------------
+ * the merged table of the static and the registered commands
+------------------------------------------------------------*/
+CommandTable::CommandTable(std::vector<DynamicCommand> commands)
+    : vsCommands(std::move(commands))
+    , vsFuncDefs(privMergeFuncDefs(vsCommands))
+    , vpstrInfo(privMergeInfo(vsCommands))
+    , viAutocomplete(vsFuncDefs.size(), 0)
+    , sInst(uShellRootCloneInstance(vsFuncDefs.data(), vpstrInfo.data(), viAutocomplete.data(),
+                                    static_cast<int>(vsFuncDefs.size()), privExecute))
+{
+} /* CommandTable() */
+
+
+/*------------------------------------------------------------
+ * dispatcher of the merged table: the static commands go to
+ * the static dispatcher, the registered ones to their callback
+------------------------------------------------------------*/
+static int privExecute(const command_s *psCmd)
+{
+    const uShellInst_s *psStaticInst = uShellRootGetStaticInstance();
+
+    if (psCmd->iFctIndex < psStaticInst->iNrFunctions) {
+        return psStaticInst->pfExec(psCmd);
+    }
+
+    const DynamicCommand &sCommand = pActiveTable->vsCommands[static_cast<size_t>(psCmd->iFctIndex - psStaticInst->iNrFunctions)];
+    return sCommand.pfCommand(psCmd, sCommand.pvContext);
+
+} /* privExecute() */
+
+
+/*------------------------------------------------------------
+ * command definitions: the static ones, then the registered ones
+------------------------------------------------------------*/
+static std::vector<fctDef_s> privMergeFuncDefs(const std::vector<DynamicCommand> &vsCommands)
+{
+    const uShellInst_s *psStaticInst = uShellRootGetStaticInstance();
+    std::vector<fctDef_s> vsFuncDefs;
+
+    vsFuncDefs.reserve(static_cast<size_t>(psStaticInst->iNrFunctions) + vsCommands.size());
+    for (int i = 0; i < psStaticInst->iNrFunctions; ++i) {
+        vsFuncDefs.push_back(psStaticInst->psFuncDefArray[i]);
+    }
+    for (const auto &sCommand : vsCommands) {
+        vsFuncDefs.push_back(fctDef_s{ sCommand.pstrName, sCommand.pstrParamDef, false });
+    }
+
+    return vsFuncDefs;
+
+} /* privMergeFuncDefs() */
+
+
+/*------------------------------------------------------------
+ * help texts, in the order of the command definitions
+------------------------------------------------------------*/
+static std::vector<const char*> privMergeInfo(const std::vector<DynamicCommand> &vsCommands)
+{
+    const uShellInst_s *psStaticInst = uShellRootGetStaticInstance();
+    std::vector<const char*> vpstrInfo;
+
+    vpstrInfo.reserve(static_cast<size_t>(psStaticInst->iNrFunctions) + vsCommands.size());
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+    vpstrInfo.insert(vpstrInfo.end(), psStaticInst->ppstrInfoArray, psStaticInst->ppstrInfoArray + psStaticInst->iNrFunctions);
+#else
+    vpstrInfo.insert(vpstrInfo.end(), static_cast<size_t>(psStaticInst->iNrFunctions), COMMAND_NO_HELP);
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
+    for (const auto &sCommand : vsCommands) {
+        vpstrInfo.push_back(sCommand.pstrHelp);
+    }
+
+    return vpstrInfo;
+
+} /* privMergeInfo() */
+
+
+/*------------------------------------------------------------
+ * a command name is one word, without the separator used by
+ * the qualified plugin commands
+------------------------------------------------------------*/
+static bool privIsValidName(const char *pstrName)
+{
+    if ((nullptr == pstrName) || ('\0' == *pstrName)) {
+        return false;
+    }
+
+    for (const char *pstrChar = pstrName; '\0' != *pstrChar; ++pstrChar) {
+        if ((0 != isspace(static_cast<unsigned char>(*pstrChar))) || (COMMAND_RESERVED_CHAR == *pstrChar)) {
+            return false;
+        }
+    }
+
+    return true;
+
+} /* privIsValidName() */
+
+
+/*------------------------------------------------------------
+ * "v" or a sequence of parameter types, optionally ended by an array or a reader
+------------------------------------------------------------*/
+static bool privIsValidParamDef(const char *pstrParamDef)
+{
+    if ((nullptr == pstrParamDef) || ('\0' == *pstrParamDef)) {
+        return false;
+    }
+
+    if (0 == strcmp(pstrParamDef, COMMAND_NO_PARAMS)) {
+        return true;
+    }
+
+    size_t szLength = strlen(pstrParamDef);
+    bool bTakesTheRest = false;
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+    bTakesTheRest = (nullptr != strchr(COMMAND_ARRAY_TYPES, pstrParamDef[szLength - 1U]));
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+#if (1 == uSHELL_SUPPORTS_READER)
+    bTakesTheRest = bTakesTheRest || (COMMAND_READER_TYPE == pstrParamDef[szLength - 1U]);
+#endif /*(1 == uSHELL_SUPPORTS_READER)*/
+    if (true == bTakesTheRest) {
+        --szLength;
+    }
+
+    return (szLength == strspn(pstrParamDef, COMMAND_PARAM_TYPES));
+
+} /* privIsValidParamDef() */
+
+
+/*------------------------------------------------------------
+ * check the static and the registered commands (lock held)
+------------------------------------------------------------*/
+static bool privIsCommandNameUsed(const char *pstrName)
+{
+    const uShellInst_s *psStaticInst = uShellRootGetStaticInstance();
+
+    for (int i = 0; i < psStaticInst->iNrFunctions; ++i) {
+        if (0 == strcmp(pstrName, psStaticInst->psFuncDefArray[i].pstrFctName)) {
+            return true;
+        }
+    }
+
+    return std::any_of(vsRegisteredCommands.begin(), vsRegisteredCommands.end(), [pstrName](const DynamicCommand &sCommand) {
+        return 0 == strcmp(sCommand.pstrName, pstrName);
+    });
+
+} /* privIsCommandNameUsed() */
+
+
+/*------------------------------------------------------------
+ * release the replaced tables, except the one still used
+------------------------------------------------------------*/
+static void privReleaseRetiredTables(const uShellInst_s *psShellInstInUse)
+{
+    vRetiredTables.erase(std::remove_if(vRetiredTables.begin(), vRetiredTables.end(),
+                                        [psShellInstInUse](const std::unique_ptr<CommandTable> &pTable) {
+                                            return &pTable->sInst != psShellInstInUse;
+                                        }),
+                         vRetiredTables.end());
+
+} /* privReleaseRetiredTables() */
+
+#endif /*(1 == uSHELL_SUPPORTS_DYNAMIC_COMMANDS)*/
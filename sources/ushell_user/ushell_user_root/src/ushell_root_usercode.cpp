@@ -3,18 +3,23 @@
 #include "ushell_core_printout.h"
 #include "ushell_core_settings.h"
 #include "ushell_user_plugin_loader.h"
+#include "ushell_user_plugin_catalog.h"
+#include "ushell_user_plugin_cache.h"
+#include "ushell_user_plugin_manifest.h"
+#include "ushell_user_plugin_shadow.h"
+#include "ushell_user_command_registry.h"
+#include "ushell_root_plugins.h"
 #include "ushell_user_logger.h"
 
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
+#include <algorithm>
+#include <cctype>
 #include <cstring>
+#include <map>
 #include <memory>
 #include <string>
-
-#if defined(_MSC_VER)
-    #include <dirent_vs.h>
-#else
-    #include <dirent.h>
-#endif
+#include <string_view>
+#include <vector>
 #endif /*(1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)*/
 
 ///////////////////////////////////////////////////////////////////
@@ -37,6 +42,8 @@
     /* Buffer sizes */
     static constexpr size_t PLUGIN_NAME_BUFFER_SIZE = 128U;
     static constexpr int PLUGIN_NAME_DISPLAY_WIDTH = 30;
+    static constexpr int COMMAND_NAME_DISPLAY_WIDTH = 24;
+    static constexpr int COMMAND_PATTERN_DISPLAY_WIDTH = 6;
     
     /* Error codes - standardized */
     enum PluginErrorCode {
@@ -47,44 +54,29 @@
         PLUGIN_ERROR_DIR_OPEN_FAILED = 4,
         PLUGIN_ERROR_BUFFER_OVERFLOW = 5
     };
-    
-    /* RAII wrapper for DIR* */
-    class DirHandle {
-    private:
-        DIR* dir_;
-        
-        /* Non-copyable */
-        DirHandle(const DirHandle&) = delete;
-        DirHandle& operator=(const DirHandle&) = delete;
-        
-    public:
-        explicit DirHandle(const char* path) : dir_(opendir(path)) {}
-        
-        ~DirHandle() { 
-            if (dir_) {
-                closedir(dir_); 
-            }
-        }
-        
-        /* Move support */
-        DirHandle(DirHandle&& other) noexcept : dir_(other.dir_) {
-            other.dir_ = nullptr;
-        }
-        
-        DirHandle& operator=(DirHandle&& other) noexcept {
-            if (this != &other) {
-                if (dir_) {
-                    closedir(dir_);
-                }
-                dir_ = other.dir_;
-                other.dir_ = nullptr;
-            }
-            return *this;
-        }
-        
-        DIR* get() const { return dir_; }
-        explicit operator bool() const { return dir_ != nullptr; }
-    };
+
+    /* separators accepted in a list of plugins to preload */
+    static constexpr const char* PLUGIN_LIST_SEPARATORS = ", \t\r\n;";
+
+    /* separator between the plugin and the command in a qualified name (plugin.command) */
+    static constexpr char PLUGIN_COMMAND_SEPARATOR = CommandRegistry::SEPARATOR;
+
+    /* plugins stay resident once loaded */
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    /* ... and are reloaded from shadow copies, so that a rebuilt plugin can be loaded next to the old one */
+    using PluginCache = PluginHandleCache<uShellInst_s, PluginShadowPathGenerator>;
+
+    /* plugin instances watched for rebuilds and replaced images waiting to be released */
+    static std::map<const uShellInst_s*, std::string> mapWatchedPlugins;
+    static std::vector<PluginCache::PluginHandle> vRetiredPlugins;
+#else
+    using PluginCache = PluginHandleCache<uShellInst_s, PluginCatalogPathGenerator>;
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    /* unknown commands are looked up in the plugin manifests (enabled by 'autoload') */
+    static bool bAutoloadPlugins = false;
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
 #endif /* (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
 
 ///////////////////////////////////////////////////////////////////
@@ -92,9 +84,24 @@
 ///////////////////////////////////////////////////////////////////
 
 #if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
-static int privListPlugins(const char *pstrCaption, const char *pstrPath, const char *pstrExtension);
-static bool privExtractPluginDisplayName(const char *filename, const char *extension, 
-                                         const char *prefix, std::string &displayName);
+static PluginCatalog& privGetPluginCatalog(void);
+static PluginCache& privGetPluginCache(void);
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+static CommandRegistry& privGetCommandRegistry(void);
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+static PluginShadowStore& privGetShadowStore(void);
+static void privWatchPlugin(const std::string &strPluginName, uShellInst_s *pShellInst);
+static uShellInst_s *privReloadIfOutdated(const std::string &strPluginName);
+static void privReleaseRetiredPlugins(const uShellInst_s *pShellInstInUse);
+static uShellInst_s *privReloadPlugin(uShellInst_s *pShellInst);
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
+static PluginManifestIndex& privGetManifestIndex(void);
+static void privPrintManifestCommand(const std::string &strPluginName, const PluginManifest::Command &sCommand);
+static int privListPlugins(const char *pstrCaption, PluginCatalog &catalog);
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+static bool privFindCommandOwner(const char *pstrFctName, std::string &strPluginName);
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
 #endif
 
 ///////////////////////////////////////////////////////////////////
@@ -123,7 +130,7 @@ int vtest(void)
 ------------------------------------------------------------*/
 int list(void)
 {
-    const int result = privListPlugins("shell", SHELL_PLUGINS_PATH, SHELL_PLUGIN_EXTENSION);
+    const int result = privListPlugins("shell", privGetPluginCatalog());
     return (result == PLUGIN_SUCCESS) ? 0 : result;
 } /* list() */
 
@@ -140,14 +147,14 @@ int pload(char *pstrPluginName)
         return PLUGIN_ERROR_INVALID_PARAM;
     }
 
-    /* Create plugin loader */
-    PluginLoaderFunctor<uShellInst_s> loader(
-        PluginPathGenerator(SHELL_PLUGINS_PATH, PLUGIN_PREFIX, SHELL_PLUGIN_EXTENSION),
-        PluginEntryPointResolver(SHELL_PLUGIN_ENTRY_POINT_NAME, SHELL_PLUGIN_EXIT_POINT_NAME)
-    );
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    /* Pick up a new build of an already resident plugin */
+    privReloadIfOutdated(pstrPluginName);
+    privReleaseRetiredPlugins(nullptr);
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
 
-    /* Load the plugin */
-    auto handle = loader(pstrPluginName);
+    /* Load the plugin (or take it from the resident / preloaded ones) */
+    auto handle = privGetPluginCache().acquire(pstrPluginName);
     
     if (!handle.first || !handle.second) {
         uSHELL_LOG(LOG_ERROR, "Failed to load plugin: %s", pstrPluginName);
@@ -162,6 +169,14 @@ int pload(char *pstrPluginName)
         uSHELL_LOG(LOG_ERROR, "Plugin returned null instance: %s", pstrPluginName);
         return PLUGIN_ERROR_INSTANCE_FAILED;
     }
+
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    /* Reload the plugin between two commands when it is rebuilt; the handle is
+     * not held here (the cache keeps the plugin resident) so that the old image
+     * can be released while the nested shell keeps running */
+    privWatchPlugin(pstrPluginName, pShellInst);
+    handle = PluginCache::PluginHandle{ nullptr, nullptr };
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
     
     /* Create microshell wrapper */
     std::shared_ptr<Microshell> pShellPtr = Microshell::getShellSharedPtr(pShellInst, pstrPluginName);
@@ -179,115 +194,434 @@ int pload(char *pstrPluginName)
 
 
 /*------------------------------------------------------------
- * Extract plugin display name from filename
+ * list the commands of a plugin, read from its manifest
 ------------------------------------------------------------*/
-static bool privExtractPluginDisplayName(const char *filename, const char *extension, 
-                                         const char *prefix, std::string &displayName)
+int pcmds(char *pstrPluginName)
 {
-    if (!filename || !extension || !prefix) {
-        return false;
+    if (nullptr == pstrPluginName || '\0' == *pstrPluginName) {
+        uSHELL_LOG(LOG_ERROR, "Invalid plugin name (nullptr or empty).");
+        return PLUGIN_ERROR_INVALID_PARAM;
     }
-    
-    /* Find extension in filename */
-    const char *ext_pos = strstr(filename, extension);
-    if (!ext_pos) {
-        return false;
+
+    const std::string strPluginName(pstrPluginName);
+    auto pManifest = privGetManifestIndex().manifest(strPluginName);
+    if (!pManifest) {
+        uSHELL_LOG(LOG_ERROR, "No manifest found for plugin: %s", pstrPluginName);
+        return PLUGIN_ERROR_LOAD_FAILED;
     }
-    
-    const size_t name_len = strlen(filename);
-    const size_t ext_len = strlen(extension);
-    
-    /* Verify extension is at the end */
-    if (ext_pos != filename + name_len - ext_len) {
-        return false;
+
+    for (const auto &sCommand : pManifest->commands()) {
+        privPrintManifestCommand(strPluginName, sCommand);
     }
-    
-    /* Extract name without extension */
-    const size_t base_len = name_len - ext_len;
-    std::string baseName(filename, base_len);
-    
-    /* Remove prefix if present */
-    const size_t prefix_len = strlen(prefix);
-    if (baseName.length() > prefix_len && baseName.substr(0, prefix_len) == prefix) {
-        displayName = baseName.substr(prefix_len);
+
+    return PLUGIN_SUCCESS;
+
+} /* pcmds() */
+
+
+/*------------------------------------------------------------
+ * search the commands of all the plugins, read from their manifests
+------------------------------------------------------------*/
+int pfind(char *pstrText)
+{
+    if (nullptr == pstrText) {
+        return PLUGIN_ERROR_INVALID_PARAM;
+    }
+
+    const std::string_view strText(pstrText);
+    int iNrFound = 0;
+
+    privGetManifestIndex().forEach([&strText, &iNrFound](const std::string &strPluginName, const PluginManifest::Command &sCommand) {
+        if (std::string_view::npos != sCommand.name.find(strText)) {
+            privPrintManifestCommand(strPluginName, sCommand);
+            ++iNrFound;
+        }
+    });
+
+    if (0 == iNrFound) {
+        uSHELL_LOG(LOG_INFO, "No plugin command matches: %s", pstrText);
     } else {
-        displayName = baseName;
+        uSHELL_LOG(LOG_INFO, "%d plugin command(s) match: %s", iNrFound, pstrText);
     }
-    
-    return true;
-}
+
+    return uSHELL_ERR_OK;
+
+} /* pfind() */
+
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+/*------------------------------------------------------------
+ * enable/disable the loading of plugins on first use of one
+ * of their commands (commands of the root shell always win)
+------------------------------------------------------------*/
+int autoload(bool bEnable)
+{
+    bAutoloadPlugins = bEnable;
+    uSHELL_LOG(LOG_INFO, "Plugin auto-loading %s", bAutoloadPlugins ? "enabled" : "disabled");
+
+    return PLUGIN_SUCCESS;
+
+} /* autoload() */
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
+
+
+/*------------------------------------------------------------
+ * the catalogue of the plugins directory, scanned on first use
+ * and kept up to date from the directory change notifications
+------------------------------------------------------------*/
+static PluginCatalog& privGetPluginCatalog(void)
+{
+    static PluginCatalog catalog(SHELL_PLUGINS_PATH, PLUGIN_PREFIX, SHELL_PLUGIN_EXTENSION);
+    return catalog;
+
+} /* privGetPluginCatalog() */
+
+
+/*------------------------------------------------------------
+ * the resident plugins, loaded on first use or preloaded
+------------------------------------------------------------*/
+static PluginCache& privGetPluginCache(void)
+{
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    /* the load listener below runs on the preload workers, which are joined only
+     * when the cache is destroyed: the registry is built first so that it is
+     * destroyed last (statics go in the reverse order of their construction) */
+    static CommandRegistry &registry = privGetCommandRegistry();
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
+
+    static PluginCache cache(PluginCache::Loader(
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+        PluginShadowPathGenerator(privGetShadowStore()),
+#else
+        PluginCatalogPathGenerator(privGetPluginCatalog()),
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
+        PluginEntryPointResolver(SHELL_PLUGIN_ENTRY_POINT_NAME, SHELL_PLUGIN_EXIT_POINT_NAME)
+    ));
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+    /* every plugin loaded, on any thread, enters the command registry */
+    static const bool bListening = (cache.setLoadListener([](const std::string &strPluginName, const PluginCache::PluginHandle &handle) {
+        registry.publish(strPluginName, handle.second.get());
+    }), true);
+    (void)bListening;
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
+    return cache;
+
+} /* privGetPluginCache() */
+
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+/*------------------------------------------------------------
+ * the commands of all the loaded plugins, as plugin.command
+ * and as plain names where these are unique
+------------------------------------------------------------*/
+static CommandRegistry& privGetCommandRegistry(void)
+{
+    static CommandRegistry registry;
+    return registry;
+
+} /* privGetCommandRegistry() */
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
+
+
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+/*------------------------------------------------------------
+ * the shadow copies the plugins are loaded from
+------------------------------------------------------------*/
+static PluginShadowStore& privGetShadowStore(void)
+{
+    static PluginShadowStore store(privGetPluginCatalog());
+    return store;
+
+} /* privGetShadowStore() */
+
+
+/*------------------------------------------------------------
+ * install the reload hook in a plugin instance
+------------------------------------------------------------*/
+static void privWatchPlugin(const std::string &strPluginName, uShellInst_s *pShellInst)
+{
+    pShellInst->pfReload = privReloadPlugin;
+    mapWatchedPlugins[pShellInst] = PluginCatalog::key(strPluginName);
+
+} /* privWatchPlugin() */
+
+
+/*------------------------------------------------------------
+ * load the new build of a rebuilt resident plugin; returns
+ * the new instance, nullptr if the plugin is up to date or
+ * the new build could not be loaded (the old one is kept)
+------------------------------------------------------------*/
+static uShellInst_s *privReloadIfOutdated(const std::string &strPluginName)
+{
+    if (!privGetShadowStore().isOutdated(strPluginName)) {
+        return nullptr;
+    }
+
+    auto handles = privGetPluginCache().replace(strPluginName);
+    if (!handles.second.first || !handles.second.second) {
+        uSHELL_LOG(LOG_ERROR, "Failed to reload plugin, keeping the old build: %s", strPluginName.c_str());
+        return nullptr;
+    }
+
+    if (handles.first.second) {
+        mapWatchedPlugins.erase(handles.first.second.get());
+        vRetiredPlugins.push_back(std::move(handles.first));
+    }
+
+    uShellInst_s *pShellInst = handles.second.second.get();
+    privWatchPlugin(strPluginName, pShellInst);
+    uSHELL_LOG(LOG_INFO, "Plugin reloaded: %s", strPluginName.c_str());
+
+    return pShellInst;
+
+} /* privReloadIfOutdated() */
+
+
+/*------------------------------------------------------------
+ * release (exit + unload) the replaced plugin images, except
+ * the one still used by the shell
+------------------------------------------------------------*/
+static void privReleaseRetiredPlugins(const uShellInst_s *pShellInstInUse)
+{
+    vRetiredPlugins.erase(std::remove_if(vRetiredPlugins.begin(), vRetiredPlugins.end(),
+                                         [pShellInstInUse](const PluginCache::PluginHandle &handle) {
+                                             return handle.second.get() != pShellInstInUse;
+                                         }),
+                          vRetiredPlugins.end());
+
+} /* privReleaseRetiredPlugins() */
+
+
+/*------------------------------------------------------------
+ * reload hook of the plugin instances, called by the shell
+ * between two commands
+------------------------------------------------------------*/
+static uShellInst_s *privReloadPlugin(uShellInst_s *pShellInst)
+{
+    privReleaseRetiredPlugins(pShellInst);
+
+    auto it = mapWatchedPlugins.find(pShellInst);
+    if (it == mapWatchedPlugins.end()) {
+        return pShellInst;
+    }
+
+    const std::string strPluginName = it->second; /* the entry goes away if the plugin is reloaded */
+    uShellInst_s *pNewShellInst = privReloadIfOutdated(strPluginName);
+    return (nullptr != pNewShellInst) ? pNewShellInst : pShellInst;
+
+} /* privReloadPlugin() */
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
+
+
+/*------------------------------------------------------------
+ * the manifests of the catalogued plugins
+------------------------------------------------------------*/
+static PluginManifestIndex& privGetManifestIndex(void)
+{
+    static PluginManifestIndex index(privGetPluginCatalog());
+    return index;
+
+} /* privGetManifestIndex() */
+
+
+/*------------------------------------------------------------
+ * print one manifest command as plugin.command, pattern and
+ * the first part of the help (the parameters help is skipped)
+------------------------------------------------------------*/
+static void privPrintManifestCommand(const std::string &strPluginName, const PluginManifest::Command &sCommand)
+{
+    const std::string strName = strPluginName + '.' + std::string(sCommand.name);
+    const std::string_view strHelp = sCommand.help.substr(0, sCommand.help.find('|'));
+
+    uSHELL_LOG(LOG_INFO, "%-*s %-*.*s| %.*s",
+               COMMAND_NAME_DISPLAY_WIDTH, strName.c_str(),
+               COMMAND_PATTERN_DISPLAY_WIDTH, static_cast<int>(sCommand.pattern.size()), sCommand.pattern.data(),
+               static_cast<int>(strHelp.size()), strHelp.data());
+
+} /* privPrintManifestCommand() */
 
 
 /*------------------------------------------------------------
  * list the available plugins
 ------------------------------------------------------------*/
-static int privListPlugins(const char *pstrCaption, const char *pstrPath, const char *pstrExtension)
+static int privListPlugins(const char *pstrCaption, PluginCatalog &catalog)
 {
     /* Validate parameters */
-    if (!pstrPath || !pstrExtension || !pstrCaption) {
+    if (!pstrCaption) {
         uSHELL_LOG(LOG_ERROR, "Invalid parameters to privListPlugins");
         return PLUGIN_ERROR_INVALID_PARAM;
     }
 
-    /* Open directory with RAII */
-    DirHandle dir(pstrPath);
-    if (!dir) {
-        uSHELL_LOG(LOG_ERROR, "Failed to open the plugins folder [%s]", pstrPath);
-        return PLUGIN_ERROR_DIR_OPEN_FAILED;
-    }
-
     uSHELL_LOG(LOG_INFO, "--- %s plugins ---", pstrCaption);
 
-    /* Cache string lengths outside loop */
-    const size_t ext_len = strlen(pstrExtension);
-    
-    struct dirent *entry = nullptr;
-    int plugin_count = 0;
-    
-    while ((entry = readdir(dir.get())) != nullptr) {
-        /* Extract display name */
-        std::string displayName;
-        if (!privExtractPluginDisplayName(entry->d_name, pstrExtension, PLUGIN_PREFIX, displayName)) {
-            continue;
-        }
-        
-        /* Create full name (base + extension) */
-        const size_t name_len = strlen(entry->d_name);
-        const size_t base_len = name_len - ext_len;
-        std::string fullName(entry->d_name, base_len);
-        
+    const size_t ext_len = catalog.extension().size();
+
+    const size_t plugin_count = catalog.forEach([ext_len](const PluginCatalog::Entry &entry) {
         /* Format output line using snprintf for safety */
         char formatted_line[PLUGIN_NAME_BUFFER_SIZE];
-        const int written = snprintf(formatted_line, PLUGIN_NAME_BUFFER_SIZE, 
-                                     "%*s%s | %s", 
+        const int written = snprintf(formatted_line, PLUGIN_NAME_BUFFER_SIZE,
+                                     "%*.*s%s | %s",
                                      PLUGIN_NAME_DISPLAY_WIDTH,
-                                     fullName.c_str(),
-                                     pstrExtension, 
-                                     displayName.c_str());
-        
+                                     static_cast<int>(entry.fileName.size() - ext_len),
+                                     entry.fileName.c_str(),
+                                     entry.fileName.c_str() + entry.fileName.size() - ext_len,
+                                     entry.name.c_str());
+
         /* Check for errors first, then truncation */
         if (written < 0) {
-            uSHELL_LOG(LOG_ERROR, "Error formatting plugin name: %s", entry->d_name);
-            continue;
+            uSHELL_LOG(LOG_ERROR, "Error formatting plugin name: %s", entry.fileName.c_str());
+            return;
         }
-        
+
         if (static_cast<size_t>(written) >= PLUGIN_NAME_BUFFER_SIZE) {
-            uSHELL_LOG(LOG_WARNING, "Plugin name truncated: [%s]", entry->d_name);
+            uSHELL_LOG(LOG_WARNING, "Plugin name truncated: [%s]", entry.fileName.c_str());
             /* Continue anyway - truncated output is better than no output */
         }
 
         uSHELL_LOG(LOG_INFO, "%s", formatted_line);
-        plugin_count++;
-    }
+    });
 
     if (plugin_count == 0) {
-        uSHELL_LOG(LOG_INFO, "No plugins found in %s", pstrPath);
+        uSHELL_LOG(LOG_INFO, "No plugins found in %s", catalog.directory().c_str());
     }
 
     return PLUGIN_SUCCESS;
 
 } /* privListPlugins() */
 
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+/*------------------------------------------------------------
+ * find the plugin offering a command, from an index of the
+ * manifests rebuilt only when the plugins directory changes;
+ * names offered by several plugins are not resolved
+------------------------------------------------------------*/
+static bool privFindCommandOwner(const char *pstrFctName, std::string &strPluginName)
+{
+    /* command name -> plugin name, empty if the command is offered by several plugins */
+    static std::map<std::string, std::string, std::less<>> mapCommandOwners;
+    static uint64_t u64Generation = 0;
+
+    const uint64_t u64CatalogGeneration = privGetPluginCatalog().generation();
+    if (u64CatalogGeneration != u64Generation) {
+        mapCommandOwners.clear();
+        privGetManifestIndex().forEach([](const std::string &strPlugin, const PluginManifest::Command &sCommand) {
+            auto result = mapCommandOwners.emplace(std::string(sCommand.name), strPlugin);
+            if (!result.second) {
+                result.first->second.clear();
+            }
+        });
+        u64Generation = u64CatalogGeneration;
+    }
+
+    auto it = mapCommandOwners.find(pstrFctName);
+    if (it == mapCommandOwners.end()) {
+        return false;
+    }
+
+    if (it->second.empty()) {
+        uSHELL_LOG(LOG_WARNING, "Command offered by several plugins, use <plugin>.%s", pstrFctName);
+        return false;
+    }
+
+    strPluginName = it->second;
+    return true;
+
+} /* privFindCommandOwner() */
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
+
+#endif /* (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
+
+
+///////////////////////////////////////////////////////////////////
+//            APPLICATION INTERFACES IMPLEMENTATION              //
+///////////////////////////////////////////////////////////////////
+
+#if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
+/*------------------------------------------------------------
+ * start loading the listed plugins in the background
+------------------------------------------------------------*/
+void uShellRootPreloadPlugins(const char *pstrPluginList)
+{
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    (void)privGetShadowStore(); /* created now: the stale copies go before anything is loaded */
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
+
+    if ((nullptr == pstrPluginList) || ('\0' == *pstrPluginList)) {
+        return;
+    }
+
+    std::vector<std::string> vstrPluginNames;
+    const char *pstrItem = pstrPluginList;
+
+    while ('\0' != *pstrItem) {
+        pstrItem += strspn(pstrItem, PLUGIN_LIST_SEPARATORS);
+        const size_t szLength = strcspn(pstrItem, PLUGIN_LIST_SEPARATORS);
+        if (szLength > 0U) {
+            vstrPluginNames.emplace_back(pstrItem, szLength);
+            pstrItem += szLength;
+        }
+    }
+
+    privGetPluginCache().preload(vstrPluginNames);
+
+} /* uShellRootPreloadPlugins() */
+
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+/*------------------------------------------------------------
+ * resolve plugin.command, or a plain command name from the
+ * plugin manifests if auto-loading is enabled; the plugin is
+ * loaded if needed and stays resident, but no nested shell
+ * is started for it
+------------------------------------------------------------*/
+uShellInst_s *uShellRootResolveCommand(const char *pstrFctName, int *piFctIndex)
+{
+    const char *pstrSeparator = strchr(pstrFctName, PLUGIN_COMMAND_SEPARATOR);
+    if ((nullptr == pstrSeparator) && !bAutoloadPlugins) {
+        return nullptr;
+    }
+
+    CommandRegistry &registry = privGetCommandRegistry();
+    CommandRegistry::Target sTarget{ nullptr, 0 };
+    std::string strPluginName;
+
+    /* a command of a loaded plugin */
+    bool bFound = registry.find(pstrFctName, sTarget, &strPluginName);
+
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+    if (bFound && (nullptr != privReloadIfOutdated(strPluginName))) {
+        bFound = registry.find(pstrFctName, sTarget);   /* the new build was registered when loaded */
+    }
+    privReleaseRetiredPlugins(nullptr);
+#endif /* (1 == uSHELL_SUPPORTS_HOT_RELOAD) */
+
+    /* a command of a plugin which is not loaded yet */
+    if (!bFound) {
+        if (nullptr != pstrSeparator) {
+            strPluginName.assign(pstrFctName, static_cast<size_t>(pstrSeparator - pstrFctName));
+        } else if (!privFindCommandOwner(pstrFctName, strPluginName)) {
+            return nullptr;
+        }
+
+        auto handle = privGetPluginCache().acquire(strPluginName);
+        if (!handle.first || !handle.second) {
+            return nullptr;
+        }
+
+        bFound = registry.find(pstrFctName, sTarget);   /* registered when loaded */
+    }
+
+    if (!bFound) {
+        return nullptr;
+    }
+
+    *piFctIndex = sTarget.iFctIndex;
+    return sTarget.pInst;
+
+} /* uShellRootResolveCommand() */
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER) */
 #endif /* (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
 
 
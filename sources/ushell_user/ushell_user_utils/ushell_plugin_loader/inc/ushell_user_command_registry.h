@@ -0,0 +1,241 @@
+#ifndef UCOMMAND_REGISTRY_H
+#define UCOMMAND_REGISTRY_H
+
+#include "ushell_core_datatypes.h"
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <string_view>
+
+//------------------------------------------------------------------------------
+// Registry of the commands of all the loaded plugins, in one namespace.
+//
+// Every command is registered as "plugin.command" and, optionally, under its
+// plain name as long as no other registered plugin has a command with the same
+// name. Lookups go through an open-addressing hash table which is never changed
+// once published: registering or withdrawing a plugin builds a new table and
+// swaps the table pointer (RCU style), then waits until no lookup started on
+// the old table is still running before freeing it. Lookups take no lock and
+// allocate nothing; writers are serialized by a mutex.
+//------------------------------------------------------------------------------
+
+class CommandRegistry
+{
+public:
+    static constexpr char SEPARATOR = '.';
+
+    struct Target {
+        uShellInst_s *pInst;    // instance owning the command
+        int iFctIndex;          // index of the command in the table of that instance
+    };
+
+    explicit CommandRegistry(bool withAliases = true)
+        : withAliases_(withAliases)
+        {}
+
+    ~CommandRegistry()
+    {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    CommandRegistry(const CommandRegistry&) = delete;
+    CommandRegistry& operator=(const CommandRegistry&) = delete;
+
+    // Register (or re-register, i.e. after a reload) the commands of a plugin instance
+    void publish(const std::string& pluginName, uShellInst_s *pInst)
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        plugins_[pluginName] = pInst;
+        swap(build());
+    }
+
+    // Remove the commands of a plugin; once this returns no lookup uses them any longer
+    void withdraw(const std::string& pluginName)
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (0U != plugins_.erase(pluginName)) {
+            swap(build());
+        }
+    }
+
+    // Find a command by its qualified or (unique) plain name; lock free
+    bool find(std::string_view name, Target& target, std::string *pPluginName = nullptr) const
+    {
+        const unsigned epoch = epoch_.load(std::memory_order_seq_cst) & 1U;
+        readers_[epoch].fetch_add(1U, std::memory_order_seq_cst);
+
+        bool bFound = false;
+        const Table *pTable = current_.load(std::memory_order_seq_cst);
+        const Slot *pSlot = (nullptr != pTable) ? pTable->find(name, hash(name)) : nullptr;
+
+        if (nullptr != pSlot) {
+            target = Target{ pSlot->pInst, pSlot->iFctIndex };
+            if (nullptr != pPluginName) {
+                pPluginName->assign(pSlot->pstrOwner, pSlot->szOwner);
+            }
+            bFound = true;
+        }
+
+        readers_[epoch].fetch_sub(1U, std::memory_order_release);
+        return bFound;
+    }
+
+    // Number of names (qualified names and aliases) in the published table
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        const Table *pTable = current_.load(std::memory_order_acquire);
+        return (nullptr != pTable) ? pTable->count : 0U;
+    }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        const char *pstrName = nullptr;     // nullptr: empty slot
+        size_t szName = 0;
+        const char *pstrOwner = nullptr;
+        size_t szOwner = 0;
+        uShellInst_s *pInst = nullptr;
+        int iFctIndex = 0;
+    };
+
+    struct Table {
+        std::unique_ptr<char[]> names;      // arena with all the names of the table
+        std::vector<Slot> slots;
+        size_t mask = 0;
+        size_t count = 0;
+
+        const Slot* find(std::string_view name, uint64_t h) const
+        {
+            for (size_t i = h & mask; nullptr != slots[i].pstrName; i = (i + 1U) & mask) {
+                if ((slots[i].hash == h) && (slots[i].szName == name.size()) &&
+                    (0 == memcmp(slots[i].pstrName, name.data(), name.size()))) {
+                    return &slots[i];
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    const bool withAliases_;
+    mutable std::mutex writerMutex_;
+    std::map<std::string, uShellInst_s*> plugins_;
+    std::atomic<const Table*> current_{nullptr};
+    std::atomic<unsigned> epoch_{0};
+    mutable std::atomic<unsigned> readers_[2] = {};
+
+    // FNV-1a
+    static uint64_t hash(std::string_view name)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (const char c : name) {
+            h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        return h;
+    }
+
+    // build the table of the registered plugins (writerMutex_ held)
+    Table* build() const
+    {
+        struct Name {
+            std::string_view owner;
+            size_t szCommand;
+            const char *pstrCommand;
+            uShellInst_s *pInst;
+            int iFctIndex;
+        };
+
+        std::vector<Name> vNames;
+        std::map<std::string_view, size_t> mapAliasUse;
+        size_t szArena = 0;
+
+        for (const auto& plugin : plugins_) {
+            for (int i = 0; i < plugin.second->iNrFunctions; ++i) {
+                const char *pstrCommand = plugin.second->psFuncDefArray[i].pstrFctName;
+                const size_t szCommand = strlen(pstrCommand);
+                vNames.push_back(Name{ plugin.first, szCommand, pstrCommand, plugin.second, i });
+                szArena += plugin.first.size() + 1U + szCommand;
+                if (withAliases_) {
+                    ++mapAliasUse[std::string_view(pstrCommand, szCommand)];
+                }
+            }
+        }
+
+        Table *pTable = new Table;
+        size_t szSlots = 16U;
+        while (szSlots < (4U * vNames.size())) {    /* load factor below 1/2 with the aliases */
+            szSlots <<= 1;
+        }
+        pTable->slots.resize(szSlots);
+        pTable->mask = szSlots - 1U;
+        pTable->names.reset(new char[szArena + 1U]);
+
+        char *pos = pTable->names.get();
+        for (const auto& name : vNames) {
+            /* "owner.command"; the owner and the plain name are views inside it */
+            const char *pstrQualified = pos;
+            memcpy(pos, name.owner.data(), name.owner.size());
+            pos += name.owner.size();
+            *pos++ = SEPARATOR;
+            memcpy(pos, name.pstrCommand, name.szCommand);
+            const char *pstrPlain = pos;
+            pos += name.szCommand;
+
+            Slot slot;
+            slot.pstrOwner = pstrQualified;
+            slot.szOwner = name.owner.size();
+            slot.pInst = name.pInst;
+            slot.iFctIndex = name.iFctIndex;
+
+            insert(*pTable, slot, std::string_view(pstrQualified, static_cast<size_t>(pos - pstrQualified)));
+
+            if (withAliases_ && (1U == mapAliasUse[std::string_view(name.pstrCommand, name.szCommand)])) {
+                insert(*pTable, slot, std::string_view(pstrPlain, name.szCommand));
+            }
+        }
+
+        return pTable;
+    }
+
+    static void insert(Table& table, Slot slot, std::string_view name)
+    {
+        slot.hash = hash(name);
+        slot.pstrName = name.data();
+        slot.szName = name.size();
+
+        size_t i = slot.hash & table.mask;
+        while (nullptr != table.slots[i].pstrName) {
+            i = (i + 1U) & table.mask;
+        }
+        table.slots[i] = slot;
+        ++table.count;
+    }
+
+    // publish a new table and free the old one once no lookup uses it (writerMutex_ held)
+    void swap(const Table *pTable)
+    {
+        const Table *pOld = current_.exchange(pTable, std::memory_order_seq_cst);
+
+        /* flip the counter used by new lookups and wait for the ones counted on the
+         * other counter, twice: a lookup may have read the epoch before an earlier
+         * flip and still have picked up the table replaced now */
+        for (int iPhase = 0; iPhase < 2; ++iPhase) {
+            const unsigned epoch = epoch_.fetch_add(1U, std::memory_order_seq_cst) & 1U;
+            while (0U != readers_[epoch].load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        delete pOld;
+    }
+};
+
+#endif /* UCOMMAND_REGISTRY_H */
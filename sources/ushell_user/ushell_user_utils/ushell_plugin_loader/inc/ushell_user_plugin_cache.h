@@ -0,0 +1,289 @@
+#ifndef UPLUGIN_CACHE_H
+#define UPLUGIN_CACHE_H
+
+#include "ushell_user_plugin_loader.h"
+
+#include <map>
+#include <deque>
+#include <chrono>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cctype>
+#include <utility>
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <signal.h>
+#endif /* !defined(_WIN32) */
+
+//------------------------------------------------------------------------------
+// Cache of resident plugin handles.
+//
+// A plugin is loaded once, either on first use or ahead of time by preload(),
+// and stays loaded until the cache is cleared. Preloading runs the loader on
+// worker threads; a caller asking for a plugin which is still being preloaded
+// waits for that load instead of starting a second one, and a plugin still
+// queued for preloading is loaded directly by the caller.
+//------------------------------------------------------------------------------
+
+template <
+    typename TPluginInterface,
+    typename PathGenerator = PluginPathGenerator,
+    typename EntryPointResolver = PluginEntryPointResolver
+    >
+class PluginHandleCache
+{
+public:
+    using Loader = PluginLoaderFunctor<TPluginInterface, PathGenerator, EntryPointResolver>;
+    using PluginHandle = typename Loader::PluginHandle;
+    using LoadListener = std::function<void(const std::string&, const PluginHandle&)>;
+
+    explicit PluginHandleCache(Loader loader)
+        : loader_(std::move(loader))
+        {}
+
+    ~PluginHandleCache()
+    {
+        clear();
+    }
+
+    PluginHandleCache(const PluginHandleCache&) = delete;
+    PluginHandleCache& operator=(const PluginHandleCache&) = delete;
+
+    // Call listener(pluginName, handle) after every successful load, on the thread
+    // which ran the load (i.e. a preload worker); to be set before the first load
+    void setLoadListener(LoadListener listener)
+    {
+        listener_ = std::move(listener);
+    }
+
+    // Return the handle of a plugin, loading it first if it is not resident yet;
+    // failed loads are not cached so that a later call can retry
+    PluginHandle acquire(const std::string& pluginName)
+    {
+        const std::string key = tolowercase(pluginName);
+        std::shared_future<PluginHandle> future;
+        std::promise<PluginHandle> promise;
+        bool loadHere = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto it = handles_.find(key);
+            if (it != handles_.end()) {
+                future = it->second;
+                loadHere = stealPending(key, promise);
+            } else {
+                future = promise.get_future().share();
+                handles_.emplace(key, future);
+                loadHere = true;
+            }
+        }
+
+        if (loadHere) {
+            promise.set_value(load(key));
+        }
+
+        PluginHandle handle = future.get();
+
+        if (!handle.first || !handle.second) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = handles_.find(key);
+            if ((it != handles_.end()) && isSameState(it->second, future)) {
+                handles_.erase(it);
+            }
+        }
+
+        return handle;
+    }
+
+    // Start loading the given plugins in the background, on at most maxThreads
+    // worker threads (0: one per hardware thread); returns immediately. The workers
+    // block SIGINT and SIGTERM, whose handlers must run on the shell thread.
+    void preload(const std::vector<std::string>& pluginNames, size_t maxThreads = 0)
+    {
+        size_t nrQueued = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            for (const auto& pluginName : pluginNames) {
+                const std::string key = tolowercase(pluginName);
+                if (key.empty() || (handles_.find(key) != handles_.end())) {
+                    continue;
+                }
+
+                std::promise<PluginHandle> promise;
+                handles_.emplace(key, promise.get_future().share());
+                pending_.emplace_back(key, std::move(promise));
+                ++nrQueued;
+            }
+        }
+
+        if (0U == maxThreads) {
+            maxThreads = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        const size_t nrWorkers = std::min(maxThreads, nrQueued);
+
+#if !defined(_WIN32)
+        sigset_t blocked;
+        sigset_t previous;
+        sigemptyset(&blocked);
+        sigaddset(&blocked, SIGINT);
+        sigaddset(&blocked, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+#endif /* !defined(_WIN32) */
+        {
+            std::lock_guard<std::mutex> lock(workersMutex_);
+            for (size_t i = 0; i < nrWorkers; ++i) {
+                workers_.emplace_back([this]() { workerLoop(); });
+            }
+        }
+#if !defined(_WIN32)
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif /* !defined(_WIN32) */
+    }
+
+    // Load the plugin again and make the new handle the resident one; the replaced
+    // handle is returned instead of being released, so that the caller decides when
+    // the old image goes away. If the new load fails the resident handle is kept and
+    // an empty handle is returned in place of the new one (second member).
+    std::pair<PluginHandle, PluginHandle> replace(const std::string& pluginName)
+    {
+        const std::string key = tolowercase(pluginName);
+        PluginHandle handle = load(key);
+        PluginHandle previous{ nullptr, nullptr };
+
+        if (!handle.first || !handle.second) {
+            return { previous, PluginHandle{ nullptr, nullptr } };
+        }
+
+        std::promise<PluginHandle> promise;
+        promise.set_value(handle);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        /* a queued preload of the old build is no longer needed */
+        std::promise<PluginHandle> pending;
+        if (stealPending(key, pending)) {
+            pending.set_value(handle);
+        }
+
+        auto it = handles_.find(key);
+        if (it != handles_.end()) {
+            if (std::future_status::ready == it->second.wait_for(std::chrono::seconds(0))) {
+                previous = it->second.get();
+            }
+            it->second = promise.get_future().share();
+        } else {
+            handles_.emplace(key, promise.get_future().share());
+        }
+
+        return { previous, handle };
+    }
+
+    // true if the plugin is loaded or being loaded
+    bool isResident(const std::string& pluginName)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return handles_.find(tolowercase(pluginName)) != handles_.end();
+    }
+
+    // Wait for the background loads and release every handle (plugin exit + unload)
+    void clear()
+    {
+        {
+            std::lock_guard<std::mutex> lock(workersMutex_);
+            for (auto& worker : workers_) {
+                if (worker.joinable()) {
+                    worker.join();
+                }
+            }
+            workers_.clear();
+        }
+
+        std::map<std::string, std::shared_future<PluginHandle>> handles;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            handles.swap(handles_);
+        }
+    }
+
+private:
+    Loader loader_;
+    LoadListener listener_;
+    std::mutex mutex_;
+    std::map<std::string, std::shared_future<PluginHandle>> handles_;
+    std::deque<std::pair<std::string, std::promise<PluginHandle>>> pending_;
+    std::mutex workersMutex_;
+    std::vector<std::thread> workers_;
+
+    PluginHandle load(const std::string& key)
+    {
+        PluginHandle handle = loader_(key);
+        if (handle.first && handle.second && listener_) {
+            listener_(key, handle);
+        }
+        return handle;
+    }
+
+    void workerLoop()
+    {
+        for (;;) {
+            std::pair<std::string, std::promise<PluginHandle>> job;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (pending_.empty()) {
+                    return;
+                }
+                job = std::move(pending_.front());
+                pending_.pop_front();
+            }
+
+            job.second.set_value(load(job.first));
+        }
+    }
+
+    // take over a preload which has not been started yet (mutex_ held)
+    bool stealPending(const std::string& key, std::promise<PluginHandle>& promise)
+    {
+        auto it = std::find_if(pending_.begin(), pending_.end(),
+                               [&key](const auto& job) { return job.first == key; });
+        if (it == pending_.end()) {
+            return false;
+        }
+
+        promise = std::move(it->second);
+        pending_.erase(it);
+        return true;
+    }
+
+    // true if the cached future 'a' belongs to the same (finished) load as 'b'
+    static bool isSameState(const std::shared_future<PluginHandle>& a, const std::shared_future<PluginHandle>& b)
+    {
+        if (std::future_status::ready != a.wait_for(std::chrono::seconds(0))) {
+            return false;
+        }
+
+        /* shared futures of one promise hand out references to the same stored value */
+        return &a.get() == &b.get();
+    }
+
+    static std::string tolowercase(const std::string& input)
+    {
+        std::string result = input;
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) {
+            return std::tolower(c);
+        });
+        return result;
+    }
+};
+
+#endif /* UPLUGIN_CACHE_H */
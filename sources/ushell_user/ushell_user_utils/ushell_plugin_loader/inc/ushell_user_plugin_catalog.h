@@ -0,0 +1,326 @@
+#ifndef UPLUGIN_CATALOG_H
+#define UPLUGIN_CATALOG_H
+
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <cctype>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#if defined(__linux__)
+    #include <unistd.h>
+    #include <sys/inotify.h>
+#endif
+
+//------------------------------------------------------------------------------
+// Plugin catalogue: an in-memory index of the plugins found in a directory.
+//
+// The directory is scanned once; afterwards the index is updated incrementally
+// from inotify events (Linux) or, where no change notification is available,
+// rescanned only when the directory modification time changes (polled at most
+// once per poll interval). Lookups never touch the filesystem.
+//------------------------------------------------------------------------------
+
+class PluginCatalog
+{
+public:
+    struct Entry {
+        std::string name;       // display name, i.e. "test" for libtest_plugin.so
+        std::string fileName;   // file name inside the plugins directory
+        std::filesystem::file_time_type writeTime;  // modification time of the library when catalogued
+    };
+
+    PluginCatalog(std::string directory, std::string prefix, std::string extension,
+                  std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000))
+        : pluginDirectory_(std::move(directory))
+        , pluginPrefix_(std::move(prefix))
+        , pluginExtension_(std::move(extension))
+        , pollInterval_(pollInterval)
+        {}
+
+    ~PluginCatalog()
+    {
+        closeWatch();
+    }
+
+    PluginCatalog(const PluginCatalog&) = delete;
+    PluginCatalog& operator=(const PluginCatalog&) = delete;
+
+    // Apply the pending directory changes; cheap when nothing has changed
+    void refresh()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refreshLocked();
+    }
+
+    // Resolve a plugin name to the full path of its library, false if unknown
+    bool resolve(const std::string& pluginName, std::string& pathName)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refreshLocked();
+
+        auto it = entries_.find(key(pluginName));
+        if (it == entries_.end()) {
+            return false;
+        }
+
+        pathName = pluginDirectory_ + it->second.fileName;
+        return true;
+    }
+
+    // Call fct(const Entry&) for every catalogued plugin, sorted by name
+    template<typename TFunction>
+    size_t forEach(TFunction&& fct)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refreshLocked();
+
+        for (const auto& item : entries_) {
+            fct(item.second);
+        }
+        return entries_.size();
+    }
+
+    // Incremented on every change of the index (a plugin added, removed or rewritten); lets callers cache derived data
+    uint64_t generation()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refreshLocked();
+        return generation_;
+    }
+
+    const std::string& directory() const { return pluginDirectory_; }
+    const std::string& extension() const { return pluginExtension_; }
+
+    // true if the index is kept up to date by change notifications instead of polling
+    bool isWatched() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return watchFd_ >= 0;
+    }
+
+    // Plugin names are case insensitive: the key of a name in the index and its lookups
+    static std::string key(const std::string& pluginName)
+    {
+        std::string result = pluginName;
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) {
+            return std::tolower(c);
+        });
+        return result;
+    }
+
+private:
+    std::string pluginDirectory_;
+    std::string pluginPrefix_;
+    std::string pluginExtension_;
+    std::chrono::milliseconds pollInterval_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+    uint64_t generation_ = 0;
+    bool scanned_ = false;
+    bool dirty_ = false;
+    int watchFd_ = -1;
+    std::filesystem::file_time_type lastWriteTime_{};
+    std::chrono::steady_clock::time_point lastPoll_{};
+
+    void refreshLocked()
+    {
+        if (!scanned_) {
+            openWatch();
+            rescan();
+            return;
+        }
+
+        if (watchFd_ >= 0) {
+            drainEvents();
+        } else {
+            pollDirectory();
+        }
+
+        if (dirty_) {
+            if (watchFd_ < 0) {
+                openWatch();
+            }
+            rescan();
+        }
+    }
+
+    void rescan()
+    {
+        std::error_code ec;
+
+        entries_.clear();
+        scanned_ = true;
+        dirty_ = false;
+        lastPoll_ = std::chrono::steady_clock::now();
+        lastWriteTime_ = std::filesystem::last_write_time(pluginDirectory_, ec);
+
+        for (std::filesystem::directory_iterator it(pluginDirectory_, ec), end; !ec && (it != end); it.increment(ec)) {
+            insert(it->path().filename().string());
+        }
+
+        ++generation_;
+    }
+
+    void pollDirectory()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if ((now - lastPoll_) < pollInterval_) {
+            return;
+        }
+        lastPoll_ = now;
+
+        std::error_code ec;
+        const auto writeTime = std::filesystem::last_write_time(pluginDirectory_, ec);
+        if (ec || (writeTime != lastWriteTime_)) {
+            dirty_ = true;
+        }
+    }
+
+    // false if the entry is already there with the same file and modification time (i.e. a file
+    // opened for writing and closed without a change)
+    bool insert(const std::string& fileName)
+    {
+        std::string name;
+        if (!extractName(fileName, name)) {
+            return false;
+        }
+
+        std::error_code ec;
+        const auto writeTime = std::filesystem::last_write_time(pluginDirectory_ + fileName, ec);
+        Entry& entry = entries_[key(name)];
+        if ((entry.name == name) && (entry.fileName == fileName) && !ec && (entry.writeTime == writeTime)) {
+            return false;
+        }
+
+        entry = Entry{ name, fileName, ec ? std::filesystem::file_time_type{} : writeTime };
+        return true;
+    }
+
+    bool erase(const std::string& fileName)
+    {
+        std::string name;
+        if (!extractName(fileName, name)) {
+            return false;
+        }
+
+        auto it = entries_.find(key(name));
+        if ((it == entries_.end()) || (it->second.fileName != fileName)) {
+            return false;
+        }
+
+        entries_.erase(it);
+        return true;
+    }
+
+    // <prefix><name><extension> -> <name>; the prefix is optional
+    bool extractName(const std::string& fileName, std::string& name) const
+    {
+        if ((fileName.size() <= pluginExtension_.size()) ||
+            (0 != fileName.compare(fileName.size() - pluginExtension_.size(), pluginExtension_.size(), pluginExtension_))) {
+            return false;
+        }
+
+        const size_t baseLength = fileName.size() - pluginExtension_.size();
+        const size_t prefixLength = ((baseLength > pluginPrefix_.size()) &&
+                                     (0 == fileName.compare(0, pluginPrefix_.size(), pluginPrefix_))) ? pluginPrefix_.size() : 0U;
+
+        name.assign(fileName, prefixLength, baseLength - prefixLength);
+        return true;
+    }
+
+#if defined(__linux__)
+    void openWatch()
+    {
+        watchFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watchFd_ < 0) {
+            return;
+        }
+
+        const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF;
+        if (inotify_add_watch(watchFd_, pluginDirectory_.c_str(), mask) < 0) {
+            closeWatch();
+        }
+    }
+
+    void closeWatch()
+    {
+        if (watchFd_ >= 0) {
+            close(watchFd_);
+            watchFd_ = -1;
+        }
+    }
+
+    void drainEvents()
+    {
+        alignas(struct inotify_event) char buffer[4096];
+        bool changed = false;
+        ssize_t length;
+
+        while ((length = read(watchFd_, buffer, sizeof(buffer))) > 0) {
+            for (char *pos = buffer; pos < (buffer + length); ) {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(pos);
+                pos += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                    /* events were lost or the directory itself went away: fall back to polling */
+                    dirty_ = true;
+                    continue;
+                }
+
+                if ((0U == event->len) || (event->mask & IN_ISDIR)) {
+                    continue;
+                }
+
+                if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    changed |= erase(event->name);
+                } else {
+                    changed |= insert(event->name);
+                }
+            }
+        }
+
+        if (changed) {
+            ++generation_;
+        }
+
+        if (dirty_) {
+            closeWatch();
+        }
+    }
+#else
+    void openWatch()   {}
+    void closeWatch()  {}
+    void drainEvents() {}
+#endif
+};
+
+//------------------------------------------------------------------------------
+// Path generator resolving plugin names through a catalogue (no filesystem access)
+//------------------------------------------------------------------------------
+
+class PluginCatalogPathGenerator
+{
+public:
+    explicit PluginCatalogPathGenerator(PluginCatalog& catalog)
+        : catalog_(catalog)
+        {}
+
+    std::string operator()(const std::string& pluginName) const
+    {
+        std::string strPathName;
+        catalog_.resolve(pluginName, strPathName);
+        return strPathName;
+    }
+
+private:
+    PluginCatalog& catalog_;
+};
+
+#endif /* UPLUGIN_CATALOG_H */
@@ -5,7 +5,6 @@
 #include <memory>
 #include <utility>
 #include <algorithm>
-#include <filesystem>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -125,7 +124,7 @@ public:
         PluginHandle aRetVal{ nullptr, nullptr };
         std::string strPluginPathName = pathGen_(pluginName);
 
-        if (std::filesystem::exists(strPluginPathName)) {
+        if (!strPluginPathName.empty()) {
 #ifdef _WIN32
             LibHandle hPlugin = LoadLibraryEx(TEXT(strPluginPathName.c_str()), nullptr, LOAD_WITH_ALTERED_SEARCH_PATH);
 #else
@@ -0,0 +1,332 @@
+#ifndef UPLUGIN_MANIFEST_H
+#define UPLUGIN_MANIFEST_H
+
+#include "ushell_core_datatypes.h"
+#include "ushell_user_plugin_catalog.h"
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+#if defined(__linux__)
+    #include <elf.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+//------------------------------------------------------------------------------
+// Read-only view of the manifest embedded in a plugin image.
+//
+// The plugin file is mapped in memory only while the manifest section is located
+// from the ELF section headers and copied out; the plugin code is neither loaded
+// nor run, and the command names, patterns and help strings point into the copy,
+// so a plugin rebuilt in place does not invalidate them.
+//------------------------------------------------------------------------------
+
+class PluginManifest
+{
+public:
+    struct Command {
+        std::string_view name;
+        std::string_view pattern;
+        std::string_view help;
+    };
+
+    PluginManifest() = default;
+
+    PluginManifest(const PluginManifest&) = delete;
+    PluginManifest& operator=(const PluginManifest&) = delete;
+
+    // the views point into the buffer of section_, which a move does not reallocate
+    PluginManifest(PluginManifest&&) noexcept = default;
+    PluginManifest& operator=(PluginManifest&&) noexcept = default;
+
+    // Copy the manifest out of the plugin image and parse it; false if the file has none
+    bool open(const std::string& pathName)
+    {
+        commands_.clear();
+        section_.clear();
+
+        if (!map(pathName)) {
+            return false;
+        }
+
+        const char *pstrSection = nullptr;
+        size_t szSection = 0;
+
+        if (locateSection(pstrSection, szSection)) {
+            section_.assign(pstrSection, pstrSection + szSection);
+        }
+        unmap();
+
+        if (section_.empty() || !parse(section_.data(), section_.size())) {
+            commands_.clear();
+            section_.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool isValid() const { return !section_.empty(); }
+
+    const std::vector<Command>& commands() const { return commands_; }
+
+    const Command* find(std::string_view name) const
+    {
+        for (const auto& command : commands_) {
+            if (command.name == name) {
+                return &command;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    const uint8_t *image_ = nullptr;    // mapping of the plugin file, only while open() runs
+    size_t imageSize_ = 0;
+    std::vector<char> section_;
+    std::vector<Command> commands_;
+
+    // magic, then name/pattern/help triplets up to an empty name
+    bool parse(const char *pstrSection, size_t szSection)
+    {
+        const std::string_view magic(uSHELL_MANIFEST_MAGIC);
+        if ((szSection <= magic.size()) || (0 != memcmp(pstrSection, magic.data(), magic.size() + 1U))) {
+            return false;
+        }
+
+        const char *pos = pstrSection + magic.size() + 1U;
+        const char *const end = pstrSection + szSection;
+
+        auto next = [&pos, end](std::string_view& item) -> bool {
+            const void *terminator = memchr(pos, '\0', static_cast<size_t>(end - pos));
+            if (nullptr == terminator) {
+                return false;
+            }
+            item = std::string_view(pos, static_cast<size_t>(static_cast<const char*>(terminator) - pos));
+            pos = static_cast<const char*>(terminator) + 1;
+            return true;
+        };
+
+        Command command;
+        while ((pos < end) && next(command.name) && !command.name.empty()) {
+            if (!next(command.pattern) || !next(command.help)) {
+                return false;
+            }
+            commands_.push_back(command);
+        }
+
+        return true;
+    }
+
+#if defined(__linux__)
+    bool map(const std::string& pathName)
+    {
+        const int fd = ::open(pathName.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat sStat;
+        void *pvImage = MAP_FAILED;
+        if ((0 == fstat(fd, &sStat)) && (sStat.st_size > 0)) {
+            pvImage = mmap(nullptr, static_cast<size_t>(sStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+
+        if (MAP_FAILED == pvImage) {
+            return false;
+        }
+
+        image_ = static_cast<const uint8_t*>(pvImage);
+        imageSize_ = static_cast<size_t>(sStat.st_size);
+        return true;
+    }
+
+    void unmap()
+    {
+        if (nullptr != image_) {
+            munmap(const_cast<uint8_t*>(image_), imageSize_);
+            image_ = nullptr;
+            imageSize_ = 0;
+        }
+    }
+
+    bool locateSection(const char*& pstrSection, size_t& szSection) const
+    {
+        if ((imageSize_ < EI_NIDENT) || (0 != memcmp(image_, ELFMAG, SELFMAG))) {
+            return false;
+        }
+
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        if (ELFDATA2LSB != image_[EI_DATA]) {
+#else
+        if (ELFDATA2MSB != image_[EI_DATA]) {
+#endif
+            return false;
+        }
+
+        switch (image_[EI_CLASS]) {
+            case ELFCLASS64 : return locateElfSection<Elf64_Ehdr, Elf64_Shdr>(pstrSection, szSection);
+            case ELFCLASS32 : return locateElfSection<Elf32_Ehdr, Elf32_Shdr>(pstrSection, szSection);
+            default         : return false;
+        }
+    }
+
+    template <typename TEhdr, typename TShdr>
+    bool locateElfSection(const char*& pstrSection, size_t& szSection) const
+    {
+        TEhdr header;
+        if (imageSize_ < sizeof(header)) {
+            return false;
+        }
+        memcpy(&header, image_, sizeof(header));
+
+        if ((sizeof(TShdr) != header.e_shentsize) || (header.e_shstrndx >= header.e_shnum) ||
+            (header.e_shoff > imageSize_) || ((imageSize_ - header.e_shoff) / sizeof(TShdr) < header.e_shnum)) {
+            return false;
+        }
+
+        auto sectionHeader = [this, &header](size_t index) {
+            TShdr section;
+            memcpy(&section, image_ + header.e_shoff + (index * sizeof(TShdr)), sizeof(section));
+            return section;
+        };
+
+        const TShdr names = sectionHeader(header.e_shstrndx);
+        if ((names.sh_offset > imageSize_) || (names.sh_size > (imageSize_ - names.sh_offset))) {
+            return false;
+        }
+
+        const std::string_view wanted(uSHELL_MANIFEST_SECTION_NAME);
+        const char *pstrNames = reinterpret_cast<const char*>(image_ + names.sh_offset);
+
+        for (size_t i = 0; i < header.e_shnum; ++i) {
+            const TShdr section = sectionHeader(i);
+
+            if ((SHT_PROGBITS != section.sh_type) || (section.sh_name >= names.sh_size) ||
+                (wanted.size() >= (names.sh_size - section.sh_name)) ||
+                (0 != memcmp(pstrNames + section.sh_name, wanted.data(), wanted.size() + 1U))) {
+                continue;
+            }
+
+            if ((section.sh_offset > imageSize_) || (section.sh_size > (imageSize_ - section.sh_offset))) {
+                return false;
+            }
+
+            pstrSection = reinterpret_cast<const char*>(image_ + section.sh_offset);
+            szSection = static_cast<size_t>(section.sh_size);
+            return true;
+        }
+
+        return false;
+    }
+#else
+    bool map(const std::string&) { return false; }
+    void unmap() {}
+    bool locateSection(const char*&, size_t&) const { return false; }
+#endif
+};
+
+//------------------------------------------------------------------------------
+// Manifests of all the plugins of a catalogue.
+//
+// Kept in step with the catalogue: a manifest is (re)read only for plugins that
+// were added or whose file changed since the previous update.
+//------------------------------------------------------------------------------
+
+class PluginManifestIndex
+{
+public:
+    explicit PluginManifestIndex(PluginCatalog& catalog)
+        : catalog_(catalog)
+        {}
+
+    PluginManifestIndex(const PluginManifestIndex&) = delete;
+    PluginManifestIndex& operator=(const PluginManifestIndex&) = delete;
+
+    // The manifest of one plugin (case insensitive, as in the catalogue), nullptr if the plugin is unknown or has none
+    std::shared_ptr<const PluginManifest> manifest(const std::string& pluginName)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        update();
+
+        auto it = plugins_.find(PluginCatalog::key(pluginName));
+        return (it != plugins_.end()) ? it->second.manifest : nullptr;
+    }
+
+    // Call fct(const std::string& pluginName, const PluginManifest::Command&) for
+    // every command of every plugin having a manifest
+    template<typename TFunction>
+    void forEach(TFunction&& fct)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        update();
+
+        for (const auto& plugin : plugins_) {
+            if (plugin.second.manifest) {
+                for (const auto& command : plugin.second.manifest->commands()) {
+                    fct(plugin.second.name, command);
+                }
+            }
+        }
+    }
+
+private:
+    struct Item {
+        std::string name;
+        std::filesystem::file_time_type writeTime;
+        std::shared_ptr<const PluginManifest> manifest;
+    };
+
+    PluginCatalog& catalog_;
+    std::mutex mutex_;
+    std::map<std::string, Item> plugins_;
+    uint64_t generation_ = 0;
+
+    void update()
+    {
+        const uint64_t generation = catalog_.generation();
+        if (generation == generation_) {
+            return;
+        }
+        generation_ = generation;
+
+        std::map<std::string, Item> plugins;
+
+        catalog_.forEach([this, &plugins](const PluginCatalog::Entry& entry) {
+            const std::string pathName = catalog_.directory() + entry.fileName;
+
+            std::error_code ec;
+            Item item{ entry.name, std::filesystem::last_write_time(pathName, ec), nullptr };
+            const std::string key = PluginCatalog::key(entry.name);
+
+            auto it = plugins_.find(key);
+            if (!ec && (it != plugins_.end()) && (it->second.writeTime == item.writeTime)) {
+                item.manifest = std::move(it->second.manifest);
+            } else {
+                auto manifest = std::make_shared<PluginManifest>();
+                if (manifest->open(pathName)) {
+                    item.manifest = std::move(manifest);
+                }
+            }
+
+            plugins.emplace(key, std::move(item));
+        });
+
+        plugins_.swap(plugins);
+    }
+};
+
+#endif /* UPLUGIN_MANIFEST_H */
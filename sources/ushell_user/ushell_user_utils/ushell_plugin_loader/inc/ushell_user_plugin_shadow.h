@@ -0,0 +1,203 @@
+#ifndef UPLUGIN_SHADOW_H
+#define UPLUGIN_SHADOW_H
+
+#include "ushell_user_plugin_catalog.h"
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include <filesystem>
+#include <system_error>
+
+#if defined(_WIN32)
+    #include <process.h>
+#else
+    #include <signal.h>
+    #include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+// Shadow copies of the catalogued plugins, for their reloads.
+//
+// A plugin is first loaded from its own file. A rebuilt plugin is loaded from a
+// private copy with a unique (versioned) name, in a directory next to the
+// plugins: the new image is mapped next to the old one instead of the loader
+// handing out the one already loaded from the same path. The store remembers
+// the state of the source file, so a rebuilt plugin is detected with no
+// filesystem access as long as the catalogue reports no change. The copies left
+// by a shell which did not exit cleanly are removed when the store is created.
+//------------------------------------------------------------------------------
+
+class PluginShadowStore
+{
+public:
+    static constexpr const char* SHADOW_DIRECTORY = ".ushell_reload";
+
+    explicit PluginShadowStore(PluginCatalog& catalog)
+        : catalog_(catalog)
+        , shadowDirectory_(std::filesystem::path(catalog.directory()) / SHADOW_DIRECTORY)
+        {
+            removeStaleCopies();
+        }
+
+    ~PluginShadowStore()
+    {
+        std::error_code ec;
+        for (const auto& item : copies_) {
+            if (!item.second.copyPath.empty()) {
+                std::filesystem::remove(item.second.copyPath, ec);
+            }
+        }
+        std::filesystem::remove(shadowDirectory_, ec); /* only if no other shell uses it */
+    }
+
+    PluginShadowStore(const PluginShadowStore&) = delete;
+    PluginShadowStore& operator=(const PluginShadowStore&) = delete;
+
+    // The file to load a plugin from, "" if the plugin is unknown or the copy failed: the
+    // plugin file the first time, a new copy of it afterwards (a reload); the previous copy
+    // of the plugin is removed (a mapped image is not affected on Linux)
+    std::string path(const std::string& pluginName)
+    {
+        const std::string key = PluginCatalog::key(pluginName);
+        std::string strSourcePath;
+        if (!catalog_.resolve(pluginName, strSourcePath)) {
+            return std::string();
+        }
+
+        Item item{ strSourcePath, stamp(strSourcePath), std::filesystem::path(), catalog_.generation() };
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = copies_.find(key);
+        if (it == copies_.end()) {
+            copies_.emplace(key, item);
+            return strSourcePath;
+        }
+
+        const std::filesystem::path sourcePath(strSourcePath);
+        item.copyPath = shadowDirectory_ / (std::to_string(processId()) + "_" +
+                                            std::to_string(++version_) + "_" + sourcePath.filename().string());
+
+        std::error_code ec;
+        std::filesystem::create_directories(shadowDirectory_, ec);
+        if (!std::filesystem::copy_file(sourcePath, item.copyPath, std::filesystem::copy_options::overwrite_existing, ec)) {
+            return std::string();
+        }
+
+        if (!it->second.copyPath.empty()) {
+            std::filesystem::remove(it->second.copyPath, ec);
+        }
+        it->second = item;
+
+        return item.copyPath.string();
+    }
+
+    // true if the plugin file changed since it was last loaded
+    bool isOutdated(const std::string& pluginName)
+    {
+        const uint64_t generation = catalog_.generation();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = copies_.find(PluginCatalog::key(pluginName));
+        if ((it == copies_.end()) || (it->second.generation == generation)) {
+            return false;
+        }
+
+        it->second.generation = generation;
+        return stamp(it->second.sourcePath) != it->second.sourceStamp;
+    }
+
+private:
+    struct Stamp {
+        std::filesystem::file_time_type writeTime{};
+        std::uintmax_t size = 0;
+
+        bool operator!=(const Stamp& other) const
+        {
+            return (writeTime != other.writeTime) || (size != other.size);
+        }
+    };
+
+    struct Item {
+        std::string sourcePath;
+        Stamp sourceStamp;
+        std::filesystem::path copyPath; // empty: loaded from the plugin file
+        uint64_t generation;            // catalogue generation of the last check
+    };
+
+    PluginCatalog& catalog_;
+    std::filesystem::path shadowDirectory_;
+    std::mutex mutex_;
+    std::map<std::string, Item> copies_;
+    std::atomic<uint64_t> version_{0};
+
+    // <pid>_<version>_<file>: the copies of the shells which are not running any more
+    void removeStaleCopies()
+    {
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(shadowDirectory_, ec), end; !ec && (it != end); it.increment(ec)) {
+            const std::string fileName = it->path().filename().string();
+            const long pid = std::strtol(fileName.c_str(), nullptr, 10);
+            if ((pid > 0) && (pid != processId()) && isRunning(pid)) {
+                continue;
+            }
+            std::error_code ecRemove;
+            std::filesystem::remove(it->path(), ecRemove); /* fails for a library still loaded on Windows */
+        }
+    }
+
+    static Stamp stamp(const std::string& pathName)
+    {
+        std::error_code ec;
+        Stamp result;
+        result.writeTime = std::filesystem::last_write_time(pathName, ec);
+        result.size = std::filesystem::file_size(pathName, ec);
+        return result;
+    }
+
+    static long processId()
+    {
+#if defined(_WIN32)
+        return static_cast<long>(_getpid());
+#else
+        return static_cast<long>(getpid());
+#endif
+    }
+
+    static bool isRunning(long pid)
+    {
+#if defined(_WIN32)
+        (void)pid;
+        return true;
+#else
+        return (0 == kill(static_cast<pid_t>(pid), 0)) || (EPERM == errno);
+#endif
+    }
+};
+
+//------------------------------------------------------------------------------
+// Path generator loading plugins from their files, and their reloads from shadow copies
+//------------------------------------------------------------------------------
+
+class PluginShadowPathGenerator
+{
+public:
+    explicit PluginShadowPathGenerator(PluginShadowStore& store)
+        : store_(store)
+        {}
+
+    std::string operator()(const std::string& pluginName) const
+    {
+        return store_.path(pluginName);
+    }
+
+private:
+    PluginShadowStore& store_;
+};
+
+#endif /* UPLUGIN_SHADOW_H */
@@ -0,0 +1,32 @@
+# cmake -DUSHELL=<ushell> -DPLUGIN=<libtest_plugin> -DWORK_DIR=<dir> -P batch_pload.cmake
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/plugins)
+file(COPY ${PLUGIN} DESTINATION ${WORK_DIR}/plugins)
+file(WRITE ${WORK_DIR}/commands.txt "pload test\ntest.itest 3\n")
+
+function(check_batch name result output expected)
+    if(NOT "${result}" STREQUAL "0")
+        message(FATAL_ERROR "${name}: ${result}\n${output}")
+    endif()
+    if(NOT output MATCHES "Plugin loaded successfully: test" OR NOT output MATCHES "${expected}")
+        message(FATAL_ERROR "${name}: '${expected}' expected\n${output}")
+    endif()
+endfunction()
+
+execute_process(COMMAND ${USHELL} -c "pload test; test.itest 2"
+                WORKING_DIRECTORY ${WORK_DIR}
+                TIMEOUT 10
+                RESULT_VARIABLE result
+                OUTPUT_VARIABLE output
+                ERROR_VARIABLE output)
+check_batch("-c" "${result}" "${output}" "i = 2")
+
+execute_process(COMMAND ${USHELL}
+                WORKING_DIRECTORY ${WORK_DIR}
+                INPUT_FILE ${WORK_DIR}/commands.txt
+                TIMEOUT 10
+                RESULT_VARIABLE result
+                OUTPUT_VARIABLE output
+                ERROR_VARIABLE output)
+check_batch("piped input" "${result}" "${output}" "i = 3")
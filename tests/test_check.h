@@ -0,0 +1,36 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+/*
+ * Checks of the unit tests: a failed check is reported with its line and the test goes on,
+ * the exit code of the test is the number of failed checks (0: passed)
+ */
+
+static unsigned int g_uTestFailures = 0U;
+
+#define TEST_CHECK(cond)                                                        \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            ++g_uTestFailures;                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                       \
+    } while (0)
+
+/* the same check for each row of a table, the row is reported with the line */
+#define TEST_CHECK_ROW(cond, row)                                               \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            ++g_uTestFailures;                                                  \
+            fprintf(stderr, "%s:%d: check failed for \"%s\": %s\n", __FILE__, __LINE__, (row), #cond); \
+        }                                                                       \
+    } while (0)
+
+/* the exit code of the test */
+static inline int test_result(const char *pstrTest) {
+    printf("%s: %s (%u failed checks)\n", pstrTest, (0U == g_uTestFailures) ? "passed" : "FAILED", g_uTestFailures);
+    return (0U == g_uTestFailures) ? 0 : 1;
+}
+
+#endif /* TEST_CHECK_H */
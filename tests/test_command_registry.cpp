@@ -0,0 +1,190 @@
+#include "ushell_user_command_registry.h"
+
+#include "test_check.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * The registry of the plugin commands: a plain name shared by two plugins is no longer an
+ * alias while the qualified names of both resolve, a withdrawn plugin is gone once withdraw()
+ * returns, and the lookups running while the tables are swapped only see valid entries
+ */
+
+#define TEST_READERS               (4)
+#define TEST_SWAPS                 (2000)
+
+static const fctDef_s g_vsAlphaCommands[] = {
+    { "ping", "v", false },
+    { "only_a", "i", false },
+};
+
+static const fctDef_s g_vsBetaCommands[] = {
+    { "ping", "v", false },
+    { "only_b", "s", false },
+};
+
+/*----------------------------------------------------------------------------*/
+/* an instance with a command table, the registry only reads the table */
+static uShellInst_s testInstance(const fctDef_s *psFuncDefArray, int iNrFunctions) {
+    return uShellInst_s {
+        .psFuncDefArray                                     = psFuncDefArray,
+        .psShortcutsArray                                   = nullptr,
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+        .ppstrInfoArray                                     = nullptr,
+#if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
+        .ppstrShortcutsInfoArray                            = nullptr,
+#endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+#endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        .piAutocompleteIndexArray                           = nullptr,
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+        .pstrPromptName                                     = nullptr,
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+        .bKeepRuning                                        = true,
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+        .iNrFunctions                                       = iNrFunctions,
+        .iNrShortcuts                                       = 0,
+        .pfExec                                             = nullptr,
+#if (1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)
+        .pfResolve                                          = nullptr,
+#endif /*(1 == uSHELL_SUPPORTS_COMMAND_RESOLVER)*/
+#if (1 == uSHELL_SUPPORTS_HOT_RELOAD)
+        .pfReload                                           = nullptr,
+#endif /*(1 == uSHELL_SUPPORTS_HOT_RELOAD)*/
+#if (1 == uSHELL_SUPPORTS_ARRAY_PARAMS)
+        .puArrayBuffer                                      = nullptr,
+        .iArrayBufferItems                                  = 0,
+#endif /*(1 == uSHELL_SUPPORTS_ARRAY_PARAMS)*/
+        .vstrPrompt                                         = {0},
+        .iPromptLength                                      = 0
+    };
+}
+
+static uShellInst_s g_sAlpha = testInstance(g_vsAlphaCommands, 2);
+static uShellInst_s g_sBeta = testInstance(g_vsBetaCommands, 2);
+
+/*----------------------------------------------------------------------------*/
+/* the name resolves to the command iFctIndex of the plugin */
+static bool resolves(const CommandRegistry &registry, const char *pstrName, const uShellInst_s *psInst, int iFctIndex, const char *pstrPlugin) {
+    CommandRegistry::Target sTarget{ nullptr, -1 };
+    std::string strPlugin;
+    return registry.find(pstrName, sTarget, &strPlugin) && (psInst == sTarget.pInst) &&
+           (iFctIndex == sTarget.iFctIndex) && (strPlugin == pstrPlugin);
+}
+
+/*----------------------------------------------------------------------------*/
+static bool found(const CommandRegistry &registry, const char *pstrName) {
+    CommandRegistry::Target sTarget{ nullptr, -1 };
+    return registry.find(pstrName, sTarget);
+}
+
+/*----------------------------------------------------------------------------*/
+static void testAliases(void) {
+    CommandRegistry registry;
+
+    TEST_CHECK(false == found(registry, "ping"));
+    TEST_CHECK(0U == registry.size());
+
+    registry.publish("alpha", &g_sAlpha);
+    TEST_CHECK(4U == registry.size());
+    TEST_CHECK(resolves(registry, "ping", &g_sAlpha, 0, "alpha"));
+    TEST_CHECK(resolves(registry, "alpha.ping", &g_sAlpha, 0, "alpha"));
+    TEST_CHECK(resolves(registry, "only_a", &g_sAlpha, 1, "alpha"));
+
+    registry.publish("beta", &g_sBeta);                 /* ping is no longer unique */
+    TEST_CHECK(6U == registry.size());
+    TEST_CHECK(false == found(registry, "ping"));
+    TEST_CHECK(resolves(registry, "alpha.ping", &g_sAlpha, 0, "alpha"));
+    TEST_CHECK(resolves(registry, "beta.ping", &g_sBeta, 0, "beta"));
+    TEST_CHECK(resolves(registry, "only_a", &g_sAlpha, 1, "alpha"));
+    TEST_CHECK(resolves(registry, "only_b", &g_sBeta, 1, "beta"));
+    TEST_CHECK(false == found(registry, "beta.only_a"));
+    TEST_CHECK(false == found(registry, "beta."));
+    TEST_CHECK(false == found(registry, ".ping"));
+
+    registry.publish("beta", &g_sBeta);                 /* published again (reload): the same names */
+    TEST_CHECK(6U == registry.size());
+
+    registry.withdraw("beta");                          /* ping is unique again */
+    TEST_CHECK(4U == registry.size());
+    TEST_CHECK(false == found(registry, "beta.ping"));
+    TEST_CHECK(false == found(registry, "only_b"));
+    TEST_CHECK(resolves(registry, "ping", &g_sAlpha, 0, "alpha"));
+
+    registry.withdraw("beta");                          /* unknown: nothing changes */
+    registry.withdraw("alpha");
+    TEST_CHECK(0U == registry.size());
+    TEST_CHECK(false == found(registry, "alpha.ping"));
+    TEST_CHECK(false == found(registry, "ping"));
+
+    CommandRegistry qualifiedOnly(false);
+    qualifiedOnly.publish("alpha", &g_sAlpha);
+    TEST_CHECK(2U == qualifiedOnly.size());
+    TEST_CHECK(false == found(qualifiedOnly, "ping"));
+    TEST_CHECK(resolves(qualifiedOnly, "alpha.ping", &g_sAlpha, 0, "alpha"));
+}
+
+/*----------------------------------------------------------------------------*/
+/* lookups on several threads while a plugin is published and withdrawn again and again:
+ * each table swapped out is freed after the grace period, a lookup never sees a wrong entry */
+static void testConcurrentLookups(void) {
+    CommandRegistry registry;
+    std::atomic<bool> bStop{false};
+    std::atomic<unsigned> uBadLookups{0U};
+    std::atomic<unsigned> uBetaSeen{0U};
+    std::atomic<unsigned> uBetaMissed{0U};
+
+    registry.publish("alpha", &g_sAlpha);
+
+    std::vector<std::thread> vReaders;
+    for (int i = 0; i < TEST_READERS; ++i) {
+        vReaders.emplace_back([&]() {
+            while (!bStop.load()) {
+                CommandRegistry::Target sTarget{ nullptr, -1 };
+                std::string strPlugin;
+                if (!resolves(registry, "alpha.ping", &g_sAlpha, 0, "alpha") || !resolves(registry, "only_a", &g_sAlpha, 1, "alpha")) {
+                    ++uBadLookups;                      /* alpha stays published */
+                }
+                if (registry.find("beta.only_b", sTarget, &strPlugin)) {
+                    uBadLookups += ((&g_sBeta != sTarget.pInst) || (1 != sTarget.iFctIndex) || ("beta" != strPlugin)) ? 1U : 0U;
+                    ++uBetaSeen;
+                } else {
+                    ++uBetaMissed;
+                }
+                if (registry.find("ping", sTarget, &strPlugin)) { /* only while beta is withdrawn */
+                    uBadLookups += ((&g_sAlpha != sTarget.pInst) || (0 != sTarget.iFctIndex) || ("alpha" != strPlugin)) ? 1U : 0U;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < TEST_SWAPS; ++i) {
+        registry.publish("beta", &g_sBeta);
+        TEST_CHECK(resolves(registry, "beta.ping", &g_sBeta, 0, "beta"));
+        TEST_CHECK(false == found(registry, "ping"));
+        registry.withdraw("beta");
+        TEST_CHECK(false == found(registry, "beta.ping"));   /* gone once withdraw() returned */
+        TEST_CHECK(resolves(registry, "ping", &g_sAlpha, 0, "alpha"));
+    }
+
+    bStop = true;
+    for (std::thread &reader : vReaders) {
+        reader.join();
+    }
+    printf("lookups of beta during the swaps: %u found, %u missed\n", uBetaSeen.load(), uBetaMissed.load());
+    TEST_CHECK(0U == uBadLookups.load());
+    TEST_CHECK(0U != uBetaSeen.load() + uBetaMissed.load());
+    TEST_CHECK(4U == registry.size());
+}
+
+/*----------------------------------------------------------------------------*/
+int main(void) {
+    testAliases();
+    testConcurrentLookups();
+    return test_result("command_registry");
+}
@@ -0,0 +1,105 @@
+#include "ushell_core_fanout.h"
+
+#include "test_check.h"
+
+#include <string>
+
+/*
+ * The placeholder of #p: ranges (decimal, hexadecimal, descending, with a step), lists of words,
+ * the templates refused and the ones with too many values
+ */
+
+typedef struct {
+    const char     *pstrTemplate;
+    fanOutError_e   eError;
+    uint64_t        ullValues;      /* also given for FAN_OUT_TOO_MANY */
+    const char     *pstrLines;      /* the lines, separated by '|' */
+} fanOutCase_s;
+
+static const fanOutCase_s g_vsCases[] = {
+    { "t.itest {0..3}",                 FAN_OUT_OK,       4U,  "t.itest 0|t.itest 1|t.itest 2|t.itest 3" },
+    { "t.itest {5..5}",                 FAN_OUT_OK,       1U,  "t.itest 5" },
+    { "t.itest {1..10..3}",             FAN_OUT_OK,       4U,  "t.itest 1|t.itest 4|t.itest 7|t.itest 10" },
+    { "t.itest {1..9..3} x",            FAN_OUT_OK,       3U,  "t.itest 1 x|t.itest 4 x|t.itest 7 x" },
+    { "t.itest {3..0}",                 FAN_OUT_OK,       4U,  "t.itest 3|t.itest 2|t.itest 1|t.itest 0" },
+    { "t.itest {10..1..4}",             FAN_OUT_OK,       3U,  "t.itest 10|t.itest 6|t.itest 2" },
+    { "t.iitest 1 {0x100..0x130..0x10}", FAN_OUT_OK,      4U,  "t.iitest 1 0x100|t.iitest 1 0x110|t.iitest 1 0x120|t.iitest 1 0x130" },
+    { "t.itest {0xff..0xFC}",           FAN_OUT_OK,       4U,  "t.itest 0xFF|t.itest 0xFE|t.itest 0xFD|t.itest 0xFC" },
+    { "t.itest {0..0x3}",               FAN_OUT_OK,       4U,  "t.itest 0|t.itest 1|t.itest 2|t.itest 3" },
+    { "t.stest {eth0,eth1,wlan0}",      FAN_OUT_OK,       3U,  "t.stest eth0|t.stest eth1|t.stest wlan0" },
+    { "{a,b} x",                        FAN_OUT_OK,       2U,  "a x|b x" },
+#if (32U == uSHELL_FAN_OUT_MAX_ITEMS)
+    { "t.itest {0..31}",                FAN_OUT_OK,       32U, nullptr },
+    { "t.itest {0..32}",                FAN_OUT_TOO_MANY, 33U, nullptr },
+    { "t.itest {31..0}",                FAN_OUT_OK,       32U, nullptr },
+    { "t.itest {0..1000..10}",          FAN_OUT_TOO_MANY, 101U, nullptr },
+    { "t.itest {0..0xFFFFFFFFFFFFFFFF}", FAN_OUT_TOO_MANY, UINT64_MAX, nullptr },
+    { "t.stest {a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p,q,r,s,t,u,v,w,x,y,z,0,1,2,3,4,5,6}", FAN_OUT_TOO_MANY, 33U, nullptr },
+#endif /* (32U == uSHELL_FAN_OUT_MAX_ITEMS) */
+    { "t.itest 5",                      FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {0..3",                  FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {}",                     FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {0..}",                  FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {..3}",                  FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {0..3..0}",              FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {0..3..}",               FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {0x..3}",                FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {-1..3}",                FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {0..0x1G}",              FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.itest {0..18446744073709551616}", FAN_OUT_INVALID, 0U, nullptr },
+    { "t.stest {a,,b}",                 FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.stest {,a}",                   FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.stest {a,}",                   FAN_OUT_INVALID,  0U,  nullptr },
+    { "t.stest {,}",                    FAN_OUT_INVALID,  0U,  nullptr },
+};
+
+/*----------------------------------------------------------------------------*/
+/* the lines of a template, '|' separated */
+static std::string linesOf(const fanOut_s *psFanOut) {
+    std::string strLines;
+    char vLine[128];
+    for (size_t i = 0U; i < psFanOut->szItems; ++i) {
+        if (false == fan_out_line(psFanOut, i, vLine, sizeof(vLine))) {
+            return "(too long)";
+        }
+        strLines += (0U == i) ? "" : "|";
+        strLines += vLine;
+    }
+    return strLines;
+}
+
+/*----------------------------------------------------------------------------*/
+static void testCases(void) {
+    for (const fanOutCase_s &sCase : g_vsCases) {
+        fanOut_s sFanOut;
+        const fanOutError_e eError = fan_out_parse(&sFanOut, sCase.pstrTemplate);
+        TEST_CHECK_ROW(sCase.eError == eError, sCase.pstrTemplate);
+        if (FAN_OUT_INVALID != sCase.eError) {
+            TEST_CHECK_ROW(sCase.ullValues == sFanOut.ullValues, sCase.pstrTemplate);
+        }
+        if (FAN_OUT_OK == eError) {
+            TEST_CHECK_ROW(sCase.ullValues == (uint64_t)sFanOut.szItems, sCase.pstrTemplate);
+        }
+        if ((FAN_OUT_OK == eError) && (nullptr != sCase.pstrLines)) {
+            TEST_CHECK_ROW(linesOf(&sFanOut) == sCase.pstrLines, sCase.pstrTemplate);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* a line which does not fit is reported, not cut */
+static void testLineTooLong(void) {
+    fanOut_s sFanOut;
+    char vLine[12];
+    TEST_CHECK(FAN_OUT_OK == fan_out_parse(&sFanOut, "t.itest {9..10}"));
+    TEST_CHECK(true == fan_out_line(&sFanOut, 0U, vLine, sizeof(vLine)));     /* "t.itest 9" */
+    TEST_CHECK(true == fan_out_line(&sFanOut, 1U, vLine, sizeof(vLine)));     /* "t.itest 10" */
+    TEST_CHECK(false == fan_out_line(&sFanOut, 1U, vLine, 10U));
+}
+
+/*----------------------------------------------------------------------------*/
+int main(void) {
+    testCases();
+    testLineTooLong();
+    return test_result("fanout");
+}
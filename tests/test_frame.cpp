@@ -0,0 +1,257 @@
+#include "ushell_core_frame.h"
+
+#include "test_check.h"
+
+#include <cstring>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif /* !defined(_WIN32) */
+
+/*
+ * Malformed binary requests: truncated and oversized lengths, empty texts, texts without their
+ * '\0', array counts overflowing once multiplied by the item size. Each request is copied to
+ * the end of a page followed by an inaccessible one, a byte read past the request crashes the test.
+ */
+
+typedef std::vector<uint8_t> bytes_t;
+
+/* a page followed by a guard page, the request is copied at the end of the first one */
+typedef struct {
+    uint8_t *pPages;
+    size_t   szPage;
+} guardedBuffer_s;
+
+static guardedBuffer_s g_sGuarded = { nullptr, 0U };
+
+/*----------------------------------------------------------------------------*/
+static bool guardInit(void) {
+#if !defined(_WIN32)
+    g_sGuarded.szPage = (size_t)sysconf(_SC_PAGESIZE);
+    void *pvPages = mmap(nullptr, 2U * g_sGuarded.szPage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == pvPages) {
+        return false;
+    }
+    g_sGuarded.pPages = (uint8_t *)pvPages;
+    return (0 == mprotect(g_sGuarded.pPages + g_sGuarded.szPage, g_sGuarded.szPage, PROT_NONE));
+#else
+    static uint8_t vPage[4096];    /* no guard page: the results are checked, not the reads */
+    g_sGuarded.pPages = vPage;
+    g_sGuarded.szPage = sizeof(vPage);
+    return true;
+#endif /* !defined(_WIN32) */
+}
+
+/*----------------------------------------------------------------------------*/
+/* the request, its last byte just before the guard page */
+static uint8_t *guarded(const bytes_t &vRequest) {
+    uint8_t *pRequest = g_sGuarded.pPages + g_sGuarded.szPage - vRequest.size();
+    if (!vRequest.empty()) {
+        memcpy(pRequest, vRequest.data(), vRequest.size());
+    }
+    return pRequest;
+}
+
+/*----------------------------------------------------------------------------*/
+static void putU32(bytes_t &vData, uint32_t uValue) {
+    for (int i = 0; i < 4; ++i) {
+        vData.push_back((uint8_t)(uValue >> (8 * i)));
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+static void putText(bytes_t &vData, const char *pstrText) {
+    putU32(vData, (uint32_t)strlen(pstrText) + 1U);
+    vData.insert(vData.end(), pstrText, pstrText + strlen(pstrText) + 1U);
+}
+
+/*----------------------------------------------------------------------------*/
+/* tag 0x1234, FRAME_LIST, the arguments follow */
+static bytes_t listRequest(const bytes_t &vArgs) {
+    bytes_t vRequest = { 0x34, 0x12, (uint8_t)FRAME_LIST, 1U };
+    vRequest.insert(vRequest.end(), vArgs.begin(), vArgs.end());
+    return vRequest;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the header of the request is valid, its only argument is not */
+static void checkArgRejected(const bytes_t &vArgs, const char *pstrCase) {
+    const bytes_t vRequest = listRequest(vArgs);
+    frameRequest_s sRequest;
+    frameArg_s sArg;
+
+    TEST_CHECK_ROW(true == frame_decode_request(guarded(vRequest), vRequest.size(), &sRequest), pstrCase);
+    TEST_CHECK_ROW(vArgs.size() == sRequest.szArgs, pstrCase);
+    TEST_CHECK_ROW(false == frame_next_arg(&sRequest, &sArg), pstrCase);
+}
+
+/*----------------------------------------------------------------------------*/
+static void testHeaders(void) {
+    frameRequest_s sRequest;
+    const struct {
+        const char *pstrCase;
+        bytes_t     vRequest;
+    } vsCases[] = {
+        { "empty",                  {} },
+        { "truncated header",       { 0x34, 0x12, FRAME_LIST } },
+        { "truncated index",        { 0x34, 0x12, FRAME_BY_INDEX, 0, 1, 2, 3 } },
+        { "truncated hash",         { 0x34, 0x12, FRAME_BY_HASH, 0 } },
+        { "no name length",         { 0x34, 0x12, FRAME_BY_NAME, 0 } },
+        { "empty name",             { 0x34, 0x12, FRAME_BY_NAME, 0, 0 } },
+        { "name past the end",      { 0x34, 0x12, FRAME_BY_NAME, 0, 4, 'a', 'b', 0 } },
+        { "name without its NUL",   { 0x34, 0x12, FRAME_BY_NAME, 0, 3, 'a', 'b', 'c' } },
+        { "oversized name length",  { 0x34, 0x12, FRAME_BY_NAME, 0, 0xFF, 'a', 0 } },
+        { "unknown selector",       { 0x34, 0x12, FRAME_SELECTOR_LAST, 0, 0, 0, 0, 0 } },
+    };
+
+    for (const auto &sCase : vsCases) {
+        TEST_CHECK_ROW(false == frame_decode_request(guarded(sCase.vRequest), sCase.vRequest.size(), &sRequest), sCase.pstrCase);
+        if (sCase.vRequest.size() >= FRAME_REQUEST_HEADER_SIZE) {
+            TEST_CHECK_ROW(0x1234U == sRequest.uTag, sCase.pstrCase);  /* the tag goes back in the error response */
+        }
+    }
+
+    const bytes_t vByName = { 0x34, 0x12, FRAME_BY_NAME, 0, 3, 'a', 'b', 0 };
+    TEST_CHECK(true == frame_decode_request(guarded(vByName), vByName.size(), &sRequest));
+    TEST_CHECK(0 == strcmp("ab", sRequest.pstrName));
+    TEST_CHECK(0U == sRequest.szArgs);
+}
+
+/*----------------------------------------------------------------------------*/
+static void testArgs(void) {
+    bytes_t vArgs;
+
+    checkArgRejected({}, "no argument");
+    checkArgRejected({ 'z', 0, 0, 0, 0 }, "unknown type");
+    checkArgRejected({ 'l', 1, 2, 3, 4, 5, 6, 7 }, "truncated l");
+    checkArgRejected({ 'i', 1, 2, 3 }, "truncated i");
+    checkArgRejected({ 'w', 1 }, "truncated w");
+    checkArgRejected({ 'b' }, "truncated b");
+
+    checkArgRejected({ 's', 2, 0, 0 }, "truncated text length");
+    vArgs = { 's' }; putU32(vArgs, 0U);
+    checkArgRejected(vArgs, "zero length text");
+    vArgs = { 's' }; putU32(vArgs, 5U); vArgs.insert(vArgs.end(), { 'a', 'b', 'c', 0 });
+    checkArgRejected(vArgs, "text past the end");
+    vArgs = { 's' }; putU32(vArgs, 0xFFFFFFFFU); vArgs.insert(vArgs.end(), { 'a', 0 });
+    checkArgRejected(vArgs, "oversized text length");
+    vArgs = { 's' }; putU32(vArgs, 3U); vArgs.insert(vArgs.end(), { 'a', 'b', 'c' });
+    checkArgRejected(vArgs, "text without its NUL");
+    vArgs = { 'r' }; putU32(vArgs, 2U); vArgs.insert(vArgs.end(), { '-', '-' });
+    checkArgRejected(vArgs, "reader without its NUL");
+
+    vArgs = { 'x' }; putU32(vArgs, 4U); vArgs.insert(vArgs.end(), { 1, 2, 3 });
+    checkArgRejected(vArgs, "blob past the end");
+    vArgs = { 'x' }; putU32(vArgs, 0xFFFFFFFFU); vArgs.insert(vArgs.end(), { 1, 2, 3 });
+    checkArgRejected(vArgs, "oversized blob length");
+
+    /* count * size wraps around 2^32 to the bytes present */
+    vArgs = { 'L' }; putU32(vArgs, 0x20000001U); vArgs.insert(vArgs.end(), 8U, 0xAA);
+    checkArgRejected(vArgs, "L count overflow");
+    vArgs = { 'I' }; putU32(vArgs, 0x40000001U); vArgs.insert(vArgs.end(), 4U, 0xAA);
+    checkArgRejected(vArgs, "I count overflow");
+    vArgs = { 'F' }; putU32(vArgs, 0x40000002U); vArgs.insert(vArgs.end(), 8U, 0xAA);
+    checkArgRejected(vArgs, "F count overflow");
+    vArgs = { 'W' }; putU32(vArgs, 0x80000002U); vArgs.insert(vArgs.end(), 4U, 0xAA);
+    checkArgRejected(vArgs, "W count overflow");
+    vArgs = { 'B' }; putU32(vArgs, 0xFFFFFFFFU); vArgs.insert(vArgs.end(), 4U, 0xAA);
+    checkArgRejected(vArgs, "B oversized count");
+    vArgs = { 'I' }; putU32(vArgs, 3U); vArgs.insert(vArgs.end(), 11U, 0xAA);
+    checkArgRejected(vArgs, "I items past the end");
+    checkArgRejected({ 'I', 1, 0 }, "truncated array count");
+
+    vArgs = { 'S' }; putU32(vArgs, 2U); putText(vArgs, "one");
+    checkArgRejected(vArgs, "S missing text");
+    vArgs = { 'S' }; putU32(vArgs, 0xFFFFFFFFU); putText(vArgs, "one");
+    checkArgRejected(vArgs, "S oversized count");
+    vArgs = { 'S' }; putU32(vArgs, 2U); putText(vArgs, "one"); putU32(vArgs, 0U);
+    checkArgRejected(vArgs, "S zero length text");
+    vArgs = { 'S' }; putU32(vArgs, 1U); putU32(vArgs, 3U); vArgs.insert(vArgs.end(), { 'o', 'n', 'e' });
+    checkArgRejected(vArgs, "S text without its NUL");
+}
+
+/*----------------------------------------------------------------------------*/
+/* the slots of a valid request are taken one after the other, up to its end */
+static void testValidArgs(void) {
+    bytes_t vArgs = { 'i', 7, 0, 0, 0, 's' };
+    putText(vArgs, "abc");
+    vArgs.push_back('x'); putU32(vArgs, 2U); vArgs.insert(vArgs.end(), { 0xDE, 0xAD });
+    vArgs.push_back('W'); putU32(vArgs, 2U); vArgs.insert(vArgs.end(), { 1, 0, 2, 0 });
+    vArgs.push_back('S'); putU32(vArgs, 2U); putText(vArgs, "x"); putText(vArgs, "yz");
+    const bytes_t vRequest = listRequest(vArgs);
+    frameRequest_s sRequest;
+    frameArg_s sArg;
+
+    TEST_CHECK(true == frame_decode_request(guarded(vRequest), vRequest.size(), &sRequest));
+    TEST_CHECK((true == frame_next_arg(&sRequest, &sArg)) && ('i' == sArg.cType) && (7U == frame_get_u32(sArg.pData)));
+    TEST_CHECK((true == frame_next_arg(&sRequest, &sArg)) && ('s' == sArg.cType) && (4U == sArg.uLength) &&
+               (0 == strcmp("abc", (const char *)sArg.pData)));
+    TEST_CHECK((true == frame_next_arg(&sRequest, &sArg)) && ('x' == sArg.cType) && (2U == sArg.uLength) && (0xAD == sArg.pData[1]));
+    TEST_CHECK((true == frame_next_arg(&sRequest, &sArg)) && ('W' == sArg.cType) && (2U == sArg.uLength) && (2U == frame_get_u16(sArg.pData + 2)));
+    TEST_CHECK((true == frame_next_arg(&sRequest, &sArg)) && ('S' == sArg.cType) && (2U == sArg.uLength));
+    uint8_t *pText = sArg.pData;
+    TEST_CHECK(0 == strcmp("x", frame_next_string(&pText)));
+    TEST_CHECK(0 == strcmp("yz", frame_next_string(&pText)));
+    TEST_CHECK(0U == sRequest.szArgs);
+    TEST_CHECK(false == frame_next_arg(&sRequest, &sArg));
+}
+
+/*----------------------------------------------------------------------------*/
+/* the length prefix of a stream: 0 and above uSHELL_MAX_FRAME_LEN are refused, a truncated request waits */
+static void testStreamLengths(void) {
+    frameAssembler_s sAssembler;
+    const uint8_t *pData = nullptr;
+    size_t szAvail = 0U;
+    bytes_t vStream;
+
+    memset(&sAssembler, 0, sizeof(sAssembler));
+    putU32(vStream, 0U);
+    pData = vStream.data(); szAvail = vStream.size();
+    TEST_CHECK(-1 == frame_feed(&sAssembler, &pData, &szAvail));
+    frame_assembler_release(&sAssembler);
+
+    vStream.clear();
+    putU32(vStream, (uint32_t)uSHELL_MAX_FRAME_LEN + 1U);
+    pData = vStream.data(); szAvail = vStream.size();
+    TEST_CHECK(-1 == frame_feed(&sAssembler, &pData, &szAvail));
+    TEST_CHECK(nullptr == sAssembler.pFrame);
+    frame_assembler_release(&sAssembler);
+
+    vStream.clear();
+    putU32(vStream, 0xFFFFFFFFU);
+    pData = vStream.data(); szAvail = vStream.size();
+    TEST_CHECK(-1 == frame_feed(&sAssembler, &pData, &szAvail));
+    frame_assembler_release(&sAssembler);
+
+    /* a request of 8 bytes given in pieces: the length split, then the request short of its end */
+    vStream.clear();
+    putU32(vStream, 8U);
+    vStream.insert(vStream.end(), { 0x34, 0x12, FRAME_BY_INDEX, 0, 5, 0, 0, 0 });
+    pData = vStream.data(); szAvail = 2U;
+    TEST_CHECK(0 == frame_feed(&sAssembler, &pData, &szAvail));
+    szAvail = 5U;
+    TEST_CHECK(0 == frame_feed(&sAssembler, &pData, &szAvail));
+    TEST_CHECK(0U == szAvail);
+    szAvail = vStream.size() - 7U;
+    TEST_CHECK(1 == frame_feed(&sAssembler, &pData, &szAvail));
+    TEST_CHECK(8U == sAssembler.szLength);
+    frameRequest_s sRequest;
+    TEST_CHECK(true == frame_decode_request(sAssembler.pFrame, sAssembler.szLength, &sRequest));
+    TEST_CHECK(5U == sRequest.uCommand);
+    frame_assembler_release(&sAssembler);
+}
+
+/*----------------------------------------------------------------------------*/
+int main(void) {
+    if (false == guardInit()) {
+        fprintf(stderr, "no guard page\n");
+        return 1;
+    }
+    testHeaders();
+    testArgs();
+    testValidArgs();
+    testStreamLengths();
+    return test_result("frame");
+}
@@ -0,0 +1,133 @@
+#include "ushell_core.h"
+#include "ushell_core_input.h"
+#include "ushell_core_keys.h"
+#include "ushell_root_commands.h"
+
+#include "test_check.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * The input ring between a producer thread and the shell: the lines put by the producer
+ * run in their order, across the wrap-around of a small ring, and the close ends Run()
+ */
+
+#define TEST_RING_SIZE             (16U)    /* a few lines, the indexes wrap around many times */
+#define TEST_LINES                 (200)
+
+/* values given to the "rec" command, in the order the shell ran it */
+static std::vector<int> g_viRecorded;
+
+/*----------------------------------------------------------------------------*/
+static int recordLine(const command_s *psCmd, void *pvContext) {
+    (void)pvContext;
+    g_viRecorded.push_back((int)psCmd->vi[0]);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* all or nothing: a line which does not fit is refused without a byte written or counted */
+static void testRefusalAndWrap(void) {
+    uint8_t vBuffer[8];
+    inputRing_s sRing;
+
+    TEST_CHECK(false == input_ring_init(&sRing, vBuffer, 6U));
+    TEST_CHECK(true == input_ring_init(&sRing, vBuffer, sizeof(vBuffer)));
+
+    TEST_CHECK(true == input_ring_put_line(&sRing, "abcdefg"));     /* 8 bytes: the ring is full */
+    TEST_CHECK(false == input_ring_put_line(&sRing, "x"));
+    TEST_CHECK(8U == sRing.szHead);
+    TEST_CHECK(0U == sRing.uOverruns);
+    TEST_CHECK(false == input_ring_write(&sRing, "x", 1U));
+    TEST_CHECK(0U == sRing.uOverruns);
+    TEST_CHECK(false == input_ring_put(&sRing, 'y'));               /* one byte: dropped and counted */
+    TEST_CHECK(1U == sRing.uOverruns);
+
+    uint8_t vRead[16];
+    TEST_CHECK(3U == input_ring_read(&sRing, vRead, 3U));
+    TEST_CHECK(0 == memcmp(vRead, "abc", 3U));
+    TEST_CHECK(false == input_ring_put_line(&sRing, "xyz"));        /* 4 bytes, 3 free */
+    TEST_CHECK(true == input_ring_put_line(&sRing, "xy"));          /* across szMask */
+    TEST_CHECK(11U == sRing.szHead);
+
+    const uint8_t vExpected[] = { 'd', 'e', 'f', 'g', uSHELL_KEY_ENTER, 'x', 'y', uSHELL_KEY_ENTER };
+    size_t szRead = 0U;
+    for (size_t szBatch = 1U; 0U != szBatch; szRead += szBatch) {  /* the head is reloaded once per batch */
+        szBatch = input_ring_read(&sRing, vRead + szRead, sizeof(vRead) - szRead);
+    }
+    TEST_CHECK(sizeof(vExpected) == szRead);
+    TEST_CHECK(0 == memcmp(vRead, vExpected, sizeof(vExpected)));
+    TEST_CHECK(-1 == input_ring_get(&sRing));
+
+    input_ring_close(&sRing);
+    TEST_CHECK(EOF == input_ring_wait_get(&sRing));
+    TEST_CHECK(1U == sRing.uOverruns);
+}
+
+/*----------------------------------------------------------------------------*/
+/* a producer thread retries the lines refused on the full ring, then closes it */
+static void testShellRunsLines(void) {
+    static uint8_t vBuffer[TEST_RING_SIZE];
+    static inputRing_s sRing;
+    size_t szBytes = 0U;
+
+    TEST_CHECK(true == uShellRootRegisterCommand("rec", "i", recordLine, nullptr, "record the value|\tvalue - any"));
+    TEST_CHECK(true == input_ring_init(&sRing, vBuffer, sizeof(vBuffer)));
+    ushell_input_attach(&sRing);
+
+#if (0 == uSHELL_SUPPORTS_EXTERNAL_USER_DATA)
+    uShellInst_s *pShellInst = uShellPluginEntry();
+#else
+    uShellInst_s *pShellInst = uShellPluginEntry(nullptr);
+#endif /* (0 == uSHELL_SUPPORTS_EXTERNAL_USER_DATA) */
+#if (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES)
+    std::shared_ptr<Microshell> pShell = Microshell::getShellSharedPtr(pShellInst, "test");
+#else
+    Microshell *pShell = Microshell::getShellPtr(pShellInst, "test");
+#endif /* (1 == uSHELL_SUPPORTS_MULTIPLE_INSTANCES) */
+    TEST_CHECK(nullptr != pShell);
+    if (nullptr == pShell) {
+        return;
+    }
+
+    std::thread producer([&szBytes]() {
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        while (false == input_ring_put_line(&sRing, "#a")) {   /* typed keys, not completed ones */
+            std::this_thread::yield();
+        }
+        szBytes += 3U;
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+        for (int i = 0; i < TEST_LINES; ++i) {
+            const std::string strLine = "rec " + std::to_string(i);
+            while (false == input_ring_put_line(&sRing, strLine.c_str())) {
+                std::this_thread::yield();  /* full: nothing written, try again */
+            }
+            szBytes += strLine.size() + 1U;
+        }
+        input_ring_close(&sRing);
+    });
+
+    pShell->Run();      /* returns at the end of the input */
+    producer.join();
+    TEST_CHECK(true == ushell_input_ended());
+    ushell_input_attach(nullptr);
+
+    TEST_CHECK(TEST_LINES == (int)g_viRecorded.size());
+    for (int i = 0; i < (int)g_viRecorded.size(); ++i) {
+        TEST_CHECK(i == g_viRecorded[(size_t)i]);
+    }
+    TEST_CHECK(szBytes == sRing.szHead);
+    TEST_CHECK(sRing.szHead > (10U * (sRing.szMask + 1U)));
+    TEST_CHECK(sRing.szHead == sRing.szTail);
+    TEST_CHECK(0U == sRing.uOverruns);
+}
+
+/*----------------------------------------------------------------------------*/
+int main(void) {
+    testRefusalAndWrap();
+    testShellRunsLines();
+    return test_result("input_ring");
+}
@@ -0,0 +1,301 @@
+#include "ushell_core_linkfilter.h"
+
+#include "test_check.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/*
+ * The link filter against a small terminal emulator: a recorded session of the shell and
+ * sequences made for one decision each go through the filter, the terminal fed with what
+ * the filter sends must end with the screen of the terminal fed with the raw output.
+ */
+
+#define TEST_SCREEN_COLS           (256U)
+
+/* attributes of a cell, the colours as their SGR parameters ("" default, "31", "38;5;208") */
+typedef struct {
+    uint16_t     uFlags;
+    std::string  strFg;
+    std::string  strBg;
+} testAttr_s;
+
+typedef struct {
+    char        cChar;
+    testAttr_s  sAttr;
+} testCell_s;
+
+/* the part of a VT100 the shell uses */
+class TestTerminal
+{
+public:
+    void feed(const std::string &strText)
+    {
+        for (const char c : strText) {
+            feed(c);
+        }
+    }
+
+    bool operator==(const TestTerminal &other) const
+    {
+        return (screen_ == other.screen_) && (row_ == other.row_) && (col_ == other.col_) &&
+               (bHidden_ == other.bHidden_) && same(sAttr_, other.sAttr_);
+    }
+
+    std::string line(size_t szRow) const
+    {
+        std::string strLine;
+        for (const testCell_s &sCell : screen_[szRow]) {
+            strLine.push_back(sCell.cChar);
+        }
+        return strLine;
+    }
+
+    size_t rows() const { return screen_.size(); }
+    bool hidden() const { return bHidden_; }
+
+private:
+    struct Row : std::vector<testCell_s> {
+        bool operator==(const Row &other) const
+        {
+            for (size_t i = 0U; i < TEST_SCREEN_COLS; ++i) {
+                if (((*this)[i].cChar != other[i].cChar) || !same((*this)[i].sAttr, other[i].sAttr)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    std::vector<Row> screen_;
+    size_t row_ = 0U;
+    size_t col_ = 0U;
+    bool bHidden_ = false;
+    testAttr_s sAttr_ = {};
+    std::string strSeq_;    /* escape sequence being received */
+
+    static bool same(const testAttr_s &a, const testAttr_s &b)
+    {
+        return (a.uFlags == b.uFlags) && (a.strFg == b.strFg) && (a.strBg == b.strBg);
+    }
+
+    testCell_s &cell(size_t szCol)
+    {
+        while (screen_.size() <= row_) {
+            screen_.push_back(Row());
+            screen_.back().resize(TEST_SCREEN_COLS, testCell_s{ ' ', testAttr_s{} });
+        }
+        return screen_[row_][(szCol < TEST_SCREEN_COLS) ? szCol : (TEST_SCREEN_COLS - 1U)];
+    }
+
+    void feed(char c)
+    {
+        if (!strSeq_.empty()) {
+            strSeq_.push_back(c);
+            if ((2U == strSeq_.size()) && ('[' != c)) {
+                strSeq_.clear();    /* not a CSI: ignored */
+            } else if ((strSeq_.size() > 2U) && (c >= '@') && (c <= '~')) {
+                sequence(strSeq_.substr(2U, strSeq_.size() - 3U), c);
+                strSeq_.clear();
+            }
+            return;
+        }
+        switch (c) {
+            case '\033': { strSeq_ = "\033"; } break;
+            case '\r':   { col_ = 0U; } break;
+            case '\n':   { ++row_; cell(col_); } break;
+            case '\b':   { col_ = (0U != col_) ? (col_ - 1U) : 0U; } break;
+            default: {
+                if ((unsigned char)c >= 0x20U) {
+                    cell(col_) = testCell_s{ c, sAttr_ };
+                    col_ = (col_ + 1U < TEST_SCREEN_COLS) ? (col_ + 1U) : col_;
+                }
+            } break;
+        }
+    }
+
+    void sgr(const std::string &strParams)
+    {
+        std::vector<std::string> vCodes(1U);
+        for (const char c : strParams) {
+            if (';' == c) {
+                vCodes.push_back("");
+            } else {
+                vCodes.back().push_back(c);
+            }
+        }
+        for (size_t i = 0U; i < vCodes.size(); ++i) {
+            const std::string &strCode = vCodes[i];
+            if (std::string::npos != strCode.find(':')) {       /* 38:5:n, 38:2::r:g:b */
+                ((0 == strCode.compare(0U, 2U, "48")) ? sAttr_.strBg : sAttr_.strFg) = strCode;
+                continue;
+            }
+            const unsigned int uCode = strCode.empty() ? 0U : (unsigned int)std::stoul(strCode);
+            if ((38U == uCode) || (48U == uCode)) {                 /* 38;5;n, 38;2;r;g;b */
+                const size_t szParts = ((i + 1U < vCodes.size()) && ("2" == vCodes[i + 1U])) ? 5U : 3U;
+                std::string strColour = strCode;
+                for (size_t j = 1U; (j < szParts) && (i + 1U < vCodes.size()); ++j) {
+                    strColour += ";" + vCodes[++i];
+                }
+                ((48U == uCode) ? sAttr_.strBg : sAttr_.strFg) = strColour;
+            } else if (0U == uCode) {
+                sAttr_ = testAttr_s{};
+            } else if (uCode <= 9U) {
+                sAttr_.uFlags = (uint16_t)(sAttr_.uFlags | (1U << uCode));
+            } else if (22U == uCode) {
+                sAttr_.uFlags = (uint16_t)(sAttr_.uFlags & ~((1U << 1) | (1U << 2)));
+            } else if ((uCode >= 23U) && (uCode <= 29U)) {
+                sAttr_.uFlags = (uint16_t)(sAttr_.uFlags & ~(1U << (uCode - 20U)));
+                if (25U == uCode) {
+                    sAttr_.uFlags = (uint16_t)(sAttr_.uFlags & ~(1U << 6));
+                }
+            } else if (((uCode >= 30U) && (uCode <= 37U)) || ((uCode >= 90U) && (uCode <= 97U))) {
+                sAttr_.strFg = strCode;
+            } else if (39U == uCode) {
+                sAttr_.strFg.clear();
+            } else if (((uCode >= 40U) && (uCode <= 47U)) || ((uCode >= 100U) && (uCode <= 107U))) {
+                sAttr_.strBg = strCode;
+            } else if (49U == uCode) {
+                sAttr_.strBg.clear();
+            }
+        }
+    }
+
+    void sequence(const std::string &strParams, char cFinal)
+    {
+        if ('m' == cFinal) {
+            sgr(strParams);
+            return;
+        }
+        if ("?25" == strParams) {
+            bHidden_ = ('l' == cFinal);
+            return;
+        }
+        const size_t szCount = strParams.empty() ? 1U : std::max<size_t>(1U, std::stoul(strParams));
+        switch (cFinal) {
+            case 'A': { row_ = (row_ > szCount) ? (row_ - szCount) : 0U; } break;
+            case 'B': { row_ += szCount; } break;
+            case 'C': { col_ = std::min<size_t>(col_ + szCount, TEST_SCREEN_COLS - 1U); } break;
+            case 'D': { col_ = (col_ > szCount) ? (col_ - szCount) : 0U; } break;
+            case 'K': { /* to the end of the line, the cells take the background */
+                for (size_t i = col_; i < TEST_SCREEN_COLS; ++i) {
+                    cell(i) = testCell_s{ ' ', testAttr_s{ 0U, "", sAttr_.strBg } };
+                }
+            } break;
+            default: {
+                TEST_CHECK_ROW(false, ("sequence not emulated: " + strParams + cFinal).c_str());
+            } break;
+        }
+    }
+};
+
+/*----------------------------------------------------------------------------*/
+static void collect(const char *pstrText, size_t szLength, void *pvContext) {
+    ((std::string *)pvContext)->append(pstrText, szLength);
+}
+
+/*----------------------------------------------------------------------------*/
+/* the output of the filter for the text given in writes of szChunk bytes (0: one write) */
+static std::string filtered(const std::string &strInput, size_t szChunk, linkFilter_s *psFilter) {
+    std::string strOutput;
+    link_filter_init(psFilter, collect, &strOutput);
+    szChunk = (0U == szChunk) ? strInput.size() : szChunk;
+    for (size_t szPos = 0U; szPos < strInput.size(); szPos += szChunk) {
+        link_filter_write(psFilter, strInput.data() + szPos, std::min(szChunk, strInput.size() - szPos));
+    }
+    link_filter_flush(psFilter);
+    return strOutput;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the terminal shows the same whether it gets the raw output or the filtered one */
+static void checkSameScreen(const std::string &strInput, const std::string &strOutput, const char *pstrCase) {
+    TestTerminal sRaw;
+    TestTerminal sFiltered;
+    sRaw.feed(strInput);
+    sFiltered.feed(strOutput);
+    TEST_CHECK_ROW(sRaw == sFiltered, pstrCase);
+}
+
+/*----------------------------------------------------------------------------*/
+/* the recorded session, in one write and split inside the sequences */
+static void testRecordedSession(void) {
+    std::ifstream file(TEST_SOURCE_DIR "/link_filter_session.txt", std::ios::binary);
+    const std::string strSession((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    TEST_CHECK(!strSession.empty());
+
+    const size_t vszChunks[] = { 0U, 1U, 2U, 3U, 5U, 7U, 64U };
+    for (const size_t szChunk : vszChunks) {
+        linkFilter_s sFilter;
+        const std::string strOutput = filtered(strSession, szChunk, &sFilter);
+        const std::string strCase = "session in writes of " + std::to_string(szChunk);
+        TEST_CHECK_ROW(strSession.size() == sFilter.ullBytesIn, strCase.c_str());
+        TEST_CHECK_ROW(strOutput.size() == sFilter.ullBytesOut, strCase.c_str());
+        TEST_CHECK_ROW(sFilter.ullBytesOut < sFilter.ullBytesIn, strCase.c_str());
+        checkSameScreen(strSession, strOutput, strCase.c_str());
+    }
+
+    linkFilter_s sFilter;
+    const std::string strOutput = filtered(strSession, 0U, &sFilter);
+    printf("session: %zu bytes in, %zu bytes out\n", strSession.size(), strOutput.size());
+    TestTerminal sScreen;
+    sScreen.feed(strOutput);
+    TEST_CHECK(sScreen.rows() > 10U);
+}
+
+/*----------------------------------------------------------------------------*/
+/* one decision each: the exact bytes sent, and the same screen */
+static void testDecisions(void) {
+    static const struct {
+        const char *pstrCase;
+        const char *pstrInput;
+        const char *pstrOutput;
+    } vsCases[] = {
+        /* hide + one movement + show: the movement alone */
+        { "held move left",         "ab\033[?25l\033[D\033[?25h",               "ab\b" },
+        { "held move right",        "ab\033[?25l\033[5C\033[?25h",              "ab\033[5C" },
+        { "held nothing",           "ab\033[?25l\033[?25h",                     "ab" },
+        { "held released by text",  "ab\033[?25l\033[3Dxy\033[?25h",            "ab\033[?25l\b\b\bxy\033[?25h" },
+        { "second movement",        "abcdef\033[?25l\033[D\033[4D\033[?25h",    "abcdef\033[?25l\b\033[4D\033[?25h" },
+        { "hidden at the end",      "ab\033[?25l\033[D",                        "ab\033[?25l\b" },
+        { "shortest movements",     "abcd\033[1D\033[2D\033[0C\033[1C\033[12C", "abcd\b\b\b\033[C\033[C\033[12C" },
+        /* SGR: the delta or the full sequence, whichever is shorter */
+        { "delta",                  "\033[31mA\033[1mB",                       "\033[31mA\033[1mB" },
+        { "full shorter",           "\033[1;31mA\033[0;32mB",                  "\033[1;31mA\033[0;32mB" },
+        { "full from delta",        "\033[1;31mA\033[22;32mB",                 "\033[1;31mA\033[0;32mB" },
+        { "reset then colour",      "\033[96mA\033[0m\033[96mB",               "\033[96mAB" },
+        { "colour set twice",       "\033[92mA\033[92m\033[0m\033[92mB",       "\033[92mAB" },
+        { "no text between",        "\033[91m\033[0m\033[93mA",                "\033[93mA" },
+        { "reset at the end",       "\033[96mA\033[0m",                        "\033[96mA\033[m" },
+        { "bold kept, dim off",     "\033[1;2;34mA\033[0;1;34mB",              "\033[1;2;34mA\033[22;1mB" },
+        { "background kept",        "\033[44;33mA\033[0;44mB",                 "\033[33;44mA\033[39mB" },
+        { "erase with background",  "\033[44m\033[K",                          "\033[44m\033[K" },
+        /* attributes the filter does not decode go as they came, the next ones in full */
+        { "256 colours",            "\033[38;5;208mA\033[0mB",                 "\033[38;5;208mA\033[mB" },
+        { "sub-parameters",         "\033[38:5:208mA\033[1mB",                 "\033[38:5:208mA\033[1mB" },
+        { "known again by a reset", "\033[38;5;1mA\033[4mB\033[0;4mC\033[4mD", "\033[38;5;1mA\033[4mB\033[0;4mCD" },
+        { "RGB after a colour",     "\033[31mA\033[48;2;1;2;3mB\033[0;31mC",   "\033[31mA\033[48;2;1;2;3mB\033[0;31mC" },
+    };
+
+    for (const auto &sCase : vsCases) {
+        linkFilter_s sFilter;
+        const std::string strInput = sCase.pstrInput;
+        for (size_t szChunk = 0U; szChunk < 4U; ++szChunk) {
+            const std::string strOutput = filtered(strInput, szChunk, &sFilter);
+            TEST_CHECK_ROW(strOutput == sCase.pstrOutput, sCase.pstrCase);
+            TEST_CHECK_ROW(sFilter.ullBytesOut <= sFilter.ullBytesIn, sCase.pstrCase);
+            checkSameScreen(strInput, strOutput, sCase.pstrCase);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+int main(void) {
+    testRecordedSession();
+    testDecisions();
+    return test_result("link_filter");
+}
@@ -0,0 +1,57 @@
+#include "ushell_user_plugin_catalog.h"
+
+#include "test_check.h"
+
+#include <fstream>
+#include <thread>
+
+/*
+ * The generation of the plugin catalogue: it changes when a plugin is added, rewritten or
+ * removed, not when its library is only opened for writing and closed again
+ */
+
+/*----------------------------------------------------------------------------*/
+static void writeFile(const std::filesystem::path &path, const char *pstrText, std::ios::openmode eMode) {
+    std::ofstream file(path, std::ios::binary | eMode);
+    file << pstrText;
+}
+
+/*----------------------------------------------------------------------------*/
+static void testGeneration(void) {
+    const std::filesystem::path directory = std::filesystem::current_path() / "plugin_catalog";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path library = directory / "libalpha_plugin.so";
+
+    PluginCatalog catalog(directory.string() + "/", "lib", "_plugin.so", std::chrono::milliseconds(0));
+    uint64_t generation = catalog.generation();
+    TEST_CHECK(0U == catalog.forEach([](const PluginCatalog::Entry&) {}));
+
+    writeFile(library, "v1", std::ios::trunc);
+    TEST_CHECK(catalog.generation() > generation);
+    generation = catalog.generation();
+    std::string strPath;
+    TEST_CHECK(catalog.resolve("ALPHA", strPath) && (strPath == library.string()));
+
+    writeFile(library, "", std::ios::app);              /* closed after writing, nothing written */
+    TEST_CHECK(catalog.generation() == generation);
+    writeFile(directory / "readme.txt", "not a plugin", std::ios::trunc);
+    TEST_CHECK(catalog.generation() == generation);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));   /* a modification time of its own */
+    writeFile(library, "v2", std::ios::trunc);          /* rebuilt */
+    TEST_CHECK(catalog.generation() > generation);
+    generation = catalog.generation();
+
+    std::filesystem::remove(library);
+    TEST_CHECK(catalog.generation() > generation);
+    TEST_CHECK(false == catalog.resolve("alpha", strPath));
+
+    std::filesystem::remove_all(directory);
+}
+
+/*----------------------------------------------------------------------------*/
+int main(void) {
+    testGeneration();
+    return test_result("plugin_catalog");
+}
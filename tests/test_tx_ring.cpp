@@ -0,0 +1,195 @@
+#include "ushell_core_txring.h"
+
+#include "test_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * The output ring between the shell and a simulated UART thread draining it with
+ * tx_ring_peek() / tx_ring_consume(): what the UART sends for each policy, the bytes
+ * counted as dropped and the watermark callbacks
+ */
+
+#define TEST_RING_SIZE             (64U)
+#define TEST_WRITES                (2000U)
+#define TEST_MAX_WRITE             (100U)   /* longer than the ring: TX_RING_BLOCK waits in the middle of a write */
+#define TEST_UART_CHUNK            (7U)     /* bytes sent at once, the UART is slower than the producer */
+
+/* the simulated UART: the consumer of the ring */
+typedef struct {
+    txRing_s                     *psRing;
+    std::string                   strSent;
+    std::atomic<bool>             bStop;
+    std::mutex                    mtxEvents;
+    std::vector<txRingEvent_e>    veEvents;
+} testUart_s;
+
+/*----------------------------------------------------------------------------*/
+/* producer side for HIGH, consumer side for LOW */
+static void onWatermark(txRing_s *psRing, txRingEvent_e eEvent, void *pvContext) {
+    (void)psRing;
+    testUart_s *psUart = (testUart_s *)pvContext;
+    std::lock_guard<std::mutex> lock(psUart->mtxEvents);
+    psUart->veEvents.push_back(eEvent);
+}
+
+/*----------------------------------------------------------------------------*/
+/* sends what the ring holds until it is stopped and empty */
+static void uartThread(testUart_s *psUart) {
+    for (;;) {
+        const uint8_t *pData = nullptr;
+        size_t szLength = tx_ring_peek(psUart->psRing, &pData);
+        if (0U == szLength) {
+            if (psUart->bStop.load()) {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        szLength = (szLength < TEST_UART_CHUNK) ? szLength : TEST_UART_CHUNK;
+        psUart->strSent.append((const char *)pData, szLength);
+        tx_ring_consume(psUart->psRing, szLength);
+        if (0U == (psUart->strSent.size() % 64U)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* the watermark events alternate, starting with HIGH, and the ring ends below the low one */
+static void checkEvents(testUart_s *psUart, const char *pstrPolicy) {
+    for (size_t i = 0U; i < psUart->veEvents.size(); ++i) {
+        TEST_CHECK_ROW(psUart->veEvents[i] == ((0U == (i & 1U)) ? TX_RING_HIGH_WATERMARK : TX_RING_LOW_WATERMARK), pstrPolicy);
+    }
+    TEST_CHECK_ROW(0U == (psUart->veEvents.size() & 1U), pstrPolicy);
+    TEST_CHECK_ROW(psUart->psRing->uHighEvents == psUart->psRing->uLowEvents, pstrPolicy);
+    TEST_CHECK_ROW(psUart->veEvents.size() == (size_t)psUart->psRing->uHighEvents * 2U, pstrPolicy);
+}
+
+/*----------------------------------------------------------------------------*/
+/* writes of 1 .. TEST_MAX_WRITE bytes while the UART sends; the UART gets the bytes the
+ * writes returned, in their order: all of them (BLOCK), whole writes (DROP), their starts (TRUNCATE) */
+static void testPolicyWithUart(txRingPolicy_e ePolicy, const char *pstrPolicy) {
+    static uint8_t vBuffer[TEST_RING_SIZE];
+    txRing_s sRing;
+    testUart_s sUart;
+
+    TEST_CHECK(true == tx_ring_init(&sRing, vBuffer, sizeof(vBuffer)));
+    sRing.ePolicy = ePolicy;
+    sRing.pfWatermark = onWatermark;
+    sRing.pvContext = &sUart;
+    sUart.psRing = &sRing;
+    sUart.bStop = false;
+    std::thread uart(uartThread, &sUart);
+
+    std::string strOffered;
+    std::string strExpected;
+    uint32_t uSeed = 1U;
+    for (size_t i = 0U; i < TEST_WRITES; ++i) {
+        uSeed = uSeed * 1103515245U + 12345U;
+        const size_t szLength = 1U + ((uSeed >> 16) % TEST_MAX_WRITE);
+        std::string strWrite;
+        for (size_t j = 0U; j < szLength; ++j) {
+            strWrite.push_back((char)('!' + ((strOffered.size() + j) % 90U)));
+        }
+        const size_t szWritten = tx_ring_write(&sRing, strWrite.data(), strWrite.size());
+        if (TX_RING_DROP == ePolicy) {
+            TEST_CHECK_ROW((0U == szWritten) || (szLength == szWritten), pstrPolicy);
+        }
+        strOffered += strWrite;
+        strExpected.append(strWrite, 0U, szWritten);
+    }
+
+    tx_ring_flush(&sRing);
+    sUart.bStop = true;
+    uart.join();
+
+    TEST_CHECK_ROW(sUart.strSent == strExpected, pstrPolicy);
+    TEST_CHECK_ROW(strOffered.size() == strExpected.size() + sRing.uDropped, pstrPolicy);
+    if (TX_RING_BLOCK == ePolicy) {
+        TEST_CHECK(sUart.strSent == strOffered);
+        TEST_CHECK(0U == sRing.uDropped);
+        TEST_CHECK(0U != sRing.uBlocked);
+    } else {
+        TEST_CHECK_ROW(0U != sRing.uDropped, pstrPolicy);
+        TEST_CHECK_ROW(0U == sRing.uBlocked, pstrPolicy);
+    }
+    TEST_CHECK_ROW(0U != sRing.uHighEvents, pstrPolicy);
+    checkEvents(&sUart, pstrPolicy);
+}
+
+/*----------------------------------------------------------------------------*/
+/* the counts of a full ring, without a consumer running */
+static void testDroppedCounts(void) {
+    uint8_t vBuffer[16];
+    txRing_s sRing;
+    const uint8_t *pData = nullptr;
+
+    TEST_CHECK(true == tx_ring_init(&sRing, vBuffer, sizeof(vBuffer)));
+    sRing.ePolicy = TX_RING_DROP;
+    TEST_CHECK(10U == tx_ring_write(&sRing, "0123456789", 10U));
+    TEST_CHECK(0U == tx_ring_write(&sRing, "abcdefghij", 10U));    /* 6 free: all of it is dropped */
+    TEST_CHECK(10U == sRing.uDropped);
+    TEST_CHECK(6U == tx_ring_write(&sRing, "klmnop", 6U));
+    TEST_CHECK(0U == tx_ring_write(&sRing, "q", 1U));
+    TEST_CHECK(11U == sRing.uDropped);
+    TEST_CHECK(16U == tx_ring_peek(&sRing, &pData));
+    TEST_CHECK(0 == memcmp(pData, "0123456789klmnop", 16U));
+
+    TEST_CHECK(true == tx_ring_init(&sRing, vBuffer, sizeof(vBuffer)));
+    sRing.ePolicy = TX_RING_TRUNCATE;
+    TEST_CHECK(10U == tx_ring_write(&sRing, "0123456789", 10U));
+    TEST_CHECK(6U == tx_ring_write(&sRing, "abcdefghij", 10U));    /* cut to the 6 free bytes */
+    TEST_CHECK(4U == sRing.uDropped);
+    TEST_CHECK(0U == tx_ring_write(&sRing, "klm", 3U));
+    TEST_CHECK(7U == sRing.uDropped);
+    TEST_CHECK(16U == tx_ring_peek(&sRing, &pData));
+    TEST_CHECK(0 == memcmp(pData, "0123456789abcdef", 16U));
+    TEST_CHECK(0U == sRing.uBlocked);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HIGH at 3/4 of the ring, LOW at 1/4, one of each until the level crosses the other one */
+static void testWatermarks(void) {
+    uint8_t vBuffer[16];
+    txRing_s sRing;
+    testUart_s sUart;
+
+    TEST_CHECK(true == tx_ring_init(&sRing, vBuffer, sizeof(vBuffer)));
+    sRing.pfWatermark = onWatermark;
+    sRing.pvContext = &sUart;
+    sUart.psRing = &sRing;
+
+    TEST_CHECK(11U == tx_ring_write(&sRing, "0123456789a", 11U));
+    TEST_CHECK(sUart.veEvents.empty());
+    TEST_CHECK(1U == tx_ring_write(&sRing, "b", 1U));              /* 12: high */
+    TEST_CHECK(1U == tx_ring_write(&sRing, "c", 1U));              /* still above: no second one */
+    TEST_CHECK(1U == sUart.veEvents.size());
+    tx_ring_consume(&sRing, 8U);                                    /* 5 */
+    TEST_CHECK(1U == sUart.veEvents.size());
+    TEST_CHECK(1U == tx_ring_write(&sRing, "d", 1U));              /* 6: below high, the low one is pending */
+    tx_ring_consume(&sRing, 2U);                                    /* 4: low */
+    tx_ring_consume(&sRing, 1U);
+    TEST_CHECK(2U == sUart.veEvents.size());
+    TEST_CHECK(9U == tx_ring_write(&sRing, "efghijklm", 9U));      /* 12: high again */
+    TEST_CHECK(3U == sUart.veEvents.size());
+    while (-1 != tx_ring_getc(&sRing)) {}
+    TEST_CHECK(4U == sUart.veEvents.size());
+    checkEvents(&sUart, "watermarks");
+}
+
+/*----------------------------------------------------------------------------*/
+int main(void) {
+    testDroppedCounts();
+    testWatermarks();
+    testPolicyWithUart(TX_RING_BLOCK, "block");
+    testPolicyWithUart(TX_RING_DROP, "drop");
+    testPolicyWithUart(TX_RING_TRUNCATE, "truncate");
+    return test_result("tx_ring");
+}